@@ -0,0 +1,531 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <mylib/camera.h>
+#include <mylib/render_stats.h>
+#include <mylib/render_device.h>
+
+
+// ·һؼ֡ʱΪ
+struct CameraKeyframe
+{
+    float mTime;
+    glm::vec3 mPosition;
+    glm::vec3 mTarget;
+};
+
+
+// ·ؼ֮֡Catmull-Romֵ
+// ļʽΪıÿһؼ֡ʱ λxyz Ŀxyz#ͷΪע
+class CameraPath {
+public:
+    // ¼ʱؼ֮֡С
+    static constexpr float kRecordInterval = 0.25f;
+
+    // centerһȦ·β
+    static CameraPath Orbit(const glm::vec3& center, float radius, float height, float duration, int keyframeCount = 16);
+
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+
+    void Clear() { mKeyframes.clear(); }
+    // ؼ֡밴ʱ˳
+    void AddKeyframe(float time, const glm::vec3& position, const glm::vec3& target);
+    // ¼ĵǰλúͳ򣬾һؼ֡kRecordIntervalʱ
+    void Record(float time, Camera& camera);
+
+    bool IsEmpty() const { return mKeyframes.empty(); }
+    float GetDuration() const { return mKeyframes.empty() ? 0.0f : mKeyframes.back().mTime; }
+    std::size_t GetKeyframeCount() const { return mKeyframes.size(); }
+    // ʱʱȡһؼ֡
+    void Sample(float time, glm::vec3& position, glm::vec3& target) const;
+
+private:
+    std::vector<CameraKeyframe> mKeyframes;
+};
+
+CameraPath CameraPath::Orbit(const glm::vec3& center, float radius, float height, float duration, int keyframeCount)
+{
+    CameraPath path;
+    for (int i = 0; i <= keyframeCount; i++) {
+        float t = static_cast<float>(i) / keyframeCount;
+        float angle = glm::radians(360.0f) * t;
+        path.AddKeyframe(duration * t, center + glm::vec3(std::sin(angle) * radius, height, std::cos(angle) * radius), center);
+    }
+    return path;
+}
+
+bool CameraPath::Load(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cout << "Failed to open camera path: " << path << std::endl;
+        return false;
+    }
+    mKeyframes.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream stream(line);
+        CameraKeyframe keyframe;
+        if (stream >> keyframe.mTime >> keyframe.mPosition.x >> keyframe.mPosition.y >> keyframe.mPosition.z
+            >> keyframe.mTarget.x >> keyframe.mTarget.y >> keyframe.mTarget.z) {
+            AddKeyframe(keyframe.mTime, keyframe.mPosition, keyframe.mTarget);
+        }
+    }
+    return !mKeyframes.empty();
+}
+
+bool CameraPath::Save(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file) {
+        std::cout << "Failed to write camera path: " << path << std::endl;
+        return false;
+    }
+    file << "# time position.xyz target.xyz" << std::endl;
+    for (auto&& keyframe : mKeyframes) {
+        file << keyframe.mTime << " " << keyframe.mPosition.x << " " << keyframe.mPosition.y << " " << keyframe.mPosition.z
+            << " " << keyframe.mTarget.x << " " << keyframe.mTarget.y << " " << keyframe.mTarget.z << std::endl;
+    }
+    return true;
+}
+
+void CameraPath::AddKeyframe(float time, const glm::vec3& position, const glm::vec3& target)
+{
+    if (!mKeyframes.empty() && time <= mKeyframes.back().mTime) {
+        return;
+    }
+    mKeyframes.push_back({ time, position, target });
+}
+
+void CameraPath::Record(float time, Camera& camera)
+{
+    if (!mKeyframes.empty() && time - mKeyframes.back().mTime < kRecordInterval) {
+        return;
+    }
+    AddKeyframe(time, camera.GetPos(), camera.GetPos() + camera.GetDir());
+}
+
+void CameraPath::Sample(float time, glm::vec3& position, glm::vec3& target) const
+{
+    if (mKeyframes.empty()) {
+        return;
+    }
+    if (time <= mKeyframes.front().mTime || mKeyframes.size() == 1) {
+        position = mKeyframes.front().mPosition;
+        target = mKeyframes.front().mTarget;
+        return;
+    }
+    if (time >= mKeyframes.back().mTime) {
+        position = mKeyframes.back().mPosition;
+        target = mKeyframes.back().mTarget;
+        return;
+    }
+
+    // ҵtimeڵһΣĿƵȡ˵㱾
+    std::size_t next = 1;
+    while (mKeyframes[next].mTime < time) {
+        next++;
+    }
+    const CameraKeyframe& k0 = mKeyframes[next > 1 ? next - 2 : 0];
+    const CameraKeyframe& k1 = mKeyframes[next - 1];
+    const CameraKeyframe& k2 = mKeyframes[next];
+    const CameraKeyframe& k3 = mKeyframes[std::min(next + 1, mKeyframes.size() - 1)];
+    float t = (time - k1.mTime) / (k2.mTime - k1.mTime);
+    auto catmullRom = [t](const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3) {
+        float t2 = t * t;
+        float t3 = t2 * t;
+        return 0.5f * (2.0f * p1 + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2
+            + (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+    };
+    position = catmullRom(k0.mPosition, k1.mPosition, k2.mPosition, k3.mPosition);
+    target = catmullRom(k0.mTarget, k1.mTarget, k2.mTarget, k3.mTarget);
+}
+
+
+// ׼ԵĲ
+struct BenchmarkSettings
+{
+    int mWarmupFrames = 60;               // Ԥ֡
+    int mMeasureFrames = 600;             // ͳƵ֡·ȲԶʱѭ
+    float mFixedDelta = 1.0f / 60.0f;     // ÿ֡ƽĹ̶ʱ
+    float mRegressionThreshold = 0.1f;    // ʱȻ߶Ϊ˻
+};
+
+
+// ׼ԵĽֵָʱΪ룬Ϊÿ֡ƽ
+struct BenchmarkResult
+{
+    std::string mScene;
+    int mWidth = 0;
+    int mHeight = 0;
+    int mFrames = 0;
+    std::map<std::string, double> mMetrics;
+
+    bool WriteJson(const std::string& path) const;
+    bool LoadJson(const std::string& path);
+    // Ƚϲ仯˻ʱfalse
+    // _msβĺʱ(1 + threshold)Ϊ˻ȷģ߾˻
+    bool Compare(const BenchmarkResult& baseline, float threshold, std::ostream& out) const;
+};
+
+bool BenchmarkResult::WriteJson(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file) {
+        std::cout << "Failed to write benchmark result: " << path << std::endl;
+        return false;
+    }
+    file << "{\n  \"scene\": \"" << mScene << "\",\n  \"width\": " << mWidth << ",\n  \"height\": " << mHeight
+        << ",\n  \"frames\": " << mFrames << ",\n  \"metrics\": {";
+    file << std::fixed << std::setprecision(6);
+    bool first = true;
+    for (auto&& metric : mMetrics) {
+        file << (first ? "\n" : ",\n") << "    \"" << metric.first << "\": " << metric.second;
+        first = false;
+    }
+    file << "\n  }\n}\n";
+    return true;
+}
+
+bool BenchmarkResult::LoadJson(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cout << "Failed to open benchmark result: " << path << std::endl;
+        return false;
+    }
+    std::stringstream stream;
+    stream << file.rdbuf();
+    std::string json = stream.str();
+
+    // ֻȡWriteJsonдĸʽ
+    auto findValue = [&json](const std::string& key, std::size_t from) {
+        std::size_t pos = json.find("\"" + key + "\"", from);
+        return pos == std::string::npos ? pos : json.find(':', pos) + 1;
+    };
+    std::size_t pos = findValue("scene", 0);
+    if (pos != std::string::npos) {
+        std::size_t begin = json.find('"', pos) + 1;
+        mScene = json.substr(begin, json.find('"', begin) - begin);
+    }
+    if ((pos = findValue("width", 0)) != std::string::npos) {
+        mWidth = std::atoi(json.c_str() + pos);
+    }
+    if ((pos = findValue("height", 0)) != std::string::npos) {
+        mHeight = std::atoi(json.c_str() + pos);
+    }
+    if ((pos = findValue("frames", 0)) != std::string::npos) {
+        mFrames = std::atoi(json.c_str() + pos);
+    }
+
+    mMetrics.clear();
+    std::size_t begin = json.find('{', findValue("metrics", 0));
+    std::size_t end = json.find('}', begin);
+    if (begin == std::string::npos || end == std::string::npos) {
+        std::cout << "Invalid benchmark result: " << path << std::endl;
+        return false;
+    }
+    for (std::size_t keyBegin = json.find('"', begin); keyBegin < end; keyBegin = json.find('"', keyBegin)) {
+        std::size_t keyEnd = json.find('"', keyBegin + 1);
+        std::string key = json.substr(keyBegin + 1, keyEnd - keyBegin - 1);
+        char* valueEnd = nullptr;
+        mMetrics[key] = std::strtod(json.c_str() + json.find(':', keyEnd) + 1, &valueEnd);
+        keyBegin = valueEnd - json.c_str();
+    }
+    return true;
+}
+
+bool BenchmarkResult::Compare(const BenchmarkResult& baseline, float threshold, std::ostream& out) const
+{
+    if (baseline.mScene != mScene || baseline.mWidth != mWidth || baseline.mHeight != mHeight) {
+        out << "Warning: baseline is " << baseline.mScene << " " << baseline.mWidth << "x" << baseline.mHeight
+            << ", current is " << mScene << " " << mWidth << "x" << mHeight << std::endl;
+    }
+
+    bool passed = true;
+    out << std::fixed << std::setprecision(3);
+    for (auto&& metric : mMetrics) {
+        auto found = baseline.mMetrics.find(metric.first);
+        if (found == baseline.mMetrics.end()) {
+            continue;
+        }
+        double base = found->second;
+        double current = metric.second;
+        bool timing = metric.first.size() > 3 && metric.first.compare(metric.first.size() - 3, 3, "_ms") == 0;
+        bool regressed = timing ? current > base * (1.0 + threshold) : current > base;
+        double change = base > 0.0 ? 100.0 * (current - base) / base : 0.0;
+        out << "  " << std::setw(20) << std::left << metric.first << std::right << std::setw(12) << base
+            << " -> " << std::setw(12) << current << " (" << std::showpos << change << std::noshowpos << "%)"
+            << (regressed ? "  REGRESSION" : "") << std::endl;
+        passed = passed && !regressed;
+    }
+    return passed;
+}
+
+
+// ȷԵĻ׼
+// ·̶ƶÿ֡Ļֻ֡žٶȺ޹
+// ÿ֡ͳCPUʱBeginFrameEndFrame壩GPUʱGL_TIMESTAMP֡ٶȡԼRenderStatsļ
+class Benchmark {
+public:
+    Benchmark(const std::string& scene, const CameraPath& path, int width, int height,
+        const BenchmarkSettings& settings = BenchmarkSettings());
+    ~Benchmark();
+
+    bool IsFinished() const { return mFinished; }
+    // ֡һ֡ģʱ䣬еĶӦʹʱ
+    float BeginFrame(Camera& camera);
+    void EndFrame();
+    float GetDeltaTime() const { return mSettings.mFixedDelta; }
+    const BenchmarkSettings& GetSettings() const { return mSettings; }
+    // ԽЧ
+    const BenchmarkResult& GetResult() const { return mResult; }
+
+private:
+    // ѯӳٶȡ֡
+    static const int kQueryFrames = 4;
+
+    CameraPath mPath;
+    BenchmarkSettings mSettings;
+    BenchmarkResult mResult;
+
+    int mFrame = 0;
+    bool mFinished = false;
+    bool mGpuTiming;  // 豸ûGLģͳGPUʱ
+    std::chrono::steady_clock::time_point mFrameStart;
+    unsigned int mQueries[kQueryFrames][2];
+    int mQueryFrame[kQueryFrames];  // ÿѯӦ֡ţ-1Ϊ
+
+    std::vector<float> mCpuTimes;
+    std::vector<float> mGpuTimes;
+    std::uint64_t mDrawCalls = 0;
+    std::uint64_t mTriangles = 0;
+    std::uint64_t mStateChanges = 0;
+
+    bool _isMeasured(int frame) const { return frame >= mSettings.mWarmupFrames; }
+    void _readQueries(bool wait);
+    void _finish();
+};
+
+Benchmark::Benchmark(const std::string& scene, const CameraPath& path, int width, int height, const BenchmarkSettings& settings)
+    : mPath(path), mSettings(settings)
+{
+    mResult.mScene = scene;
+    mResult.mWidth = width;
+    mResult.mHeight = height;
+    mGpuTiming = !RenderDevice::Get().IsNull();
+    if (mGpuTiming) {
+        glGenQueries(kQueryFrames * 2, &mQueries[0][0]);
+    }
+    std::fill(mQueryFrame, mQueryFrame + kQueryFrames, -1);
+    mCpuTimes.reserve(settings.mMeasureFrames);
+    mGpuTimes.reserve(settings.mMeasureFrames);
+}
+
+Benchmark::~Benchmark()
+{
+    if (mGpuTiming) {
+        glDeleteQueries(kQueryFrames * 2, &mQueries[0][0]);
+    }
+}
+
+float Benchmark::BeginFrame(Camera& camera)
+{
+    float time = mFrame * mSettings.mFixedDelta;
+    float duration = mPath.GetDuration();
+    glm::vec3 position, target;
+    mPath.Sample(duration > 0.0f ? std::fmod(time, duration) : 0.0f, position, target);
+    camera.SetLookAt(position, target);
+
+    RenderStats::Get().Reset();
+    mFrameStart = std::chrono::steady_clock::now();
+    if (mGpuTiming) {
+        glQueryCounter(mQueries[mFrame % kQueryFrames][0], GL_TIMESTAMP);
+    }
+    return time;
+}
+
+void Benchmark::EndFrame()
+{
+    if (mFinished) {
+        return;
+    }
+    if (mGpuTiming) {
+        int slot = mFrame % kQueryFrames;
+        glQueryCounter(mQueries[slot][1], GL_TIMESTAMP);
+        mQueryFrame[slot] = mFrame;
+    }
+
+    if (_isMeasured(mFrame)) {
+        mCpuTimes.push_back(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - mFrameStart).count());
+        const RenderStats& stats = RenderStats::Get();
+        mDrawCalls += stats.mDrawCalls;
+        mTriangles += stats.mTriangles;
+        mStateChanges += stats.GetStateChanges();
+    }
+    mFrame++;
+
+    // һ֡ҪõѯֻȡѾɵ
+    _readQueries(false);
+    if (mFrame == mSettings.mWarmupFrames + mSettings.mMeasureFrames) {
+        _finish();
+    }
+}
+
+void Benchmark::_readQueries(bool wait)
+{
+    for (int i = 0; i < kQueryFrames; i++) {
+        int slot = (mFrame + i) % kQueryFrames;
+        if (mQueryFrame[slot] < 0) {
+            continue;
+        }
+        if (!wait && i > 0) {
+            GLint available = 0;
+            glGetQueryObjectiv(mQueries[slot][1], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                break;
+            }
+        }
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(mQueries[slot][0], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(mQueries[slot][1], GL_QUERY_RESULT, &end);
+        if (_isMeasured(mQueryFrame[slot])) {
+            mGpuTimes.push_back(static_cast<float>((end - begin) * 1e-6));
+        }
+        mQueryFrame[slot] = -1;
+    }
+}
+
+void Benchmark::_finish()
+{
+    _readQueries(true);
+    mFinished = true;
+
+    auto addTimes = [this](const std::string& prefix, std::vector<float> values) {
+        if (values.empty()) {
+            return;
+        }
+        double sum = 0.0;
+        for (auto&& value : values) {
+            sum += value;
+        }
+        std::sort(values.begin(), values.end());
+        auto percentile = [&values](double p) {
+            return values[std::min(values.size() - 1, static_cast<std::size_t>(p * values.size()))];
+        };
+        mResult.mMetrics[prefix + "_avg_ms"] = sum / values.size();
+        mResult.mMetrics[prefix + "_p50_ms"] = percentile(0.5);
+        mResult.mMetrics[prefix + "_p95_ms"] = percentile(0.95);
+        mResult.mMetrics[prefix + "_p99_ms"] = percentile(0.99);
+    };
+    addTimes("cpu", mCpuTimes);
+    addTimes("gpu", mGpuTimes);
+
+    double frames = std::max<std::size_t>(mCpuTimes.size(), 1);
+    mResult.mFrames = static_cast<int>(mCpuTimes.size());
+    mResult.mMetrics["draw_calls"] = mDrawCalls / frames;
+    mResult.mMetrics["triangles"] = mTriangles / frames;
+    mResult.mMetrics["state_changes"] = mStateChanges / frames;
+}
+
+
+// л׼Եв
+// --benchmark ·ļΪorbitʱʹóĬϵĻ·--warmup Ԥ֡--measure ͳ֡
+// --output json--baseline json--threshold ĺʱӱ
+struct BenchmarkOptions
+{
+    bool mEnabled = false;
+    std::string mPathFile;
+    std::string mOutputFile = "benchmark.json";
+    std::string mBaselineFile;
+    BenchmarkSettings mSettings;
+
+    // ʶĲ˳ŵothersУothersΪʱʶĲfalse
+    bool Parse(int argc, char* argv[], std::vector<std::string>* others = nullptr);
+    // ·ļΪorbitʱʹdefaultPath
+    bool LoadPath(const CameraPath& defaultPath, CameraPath& path) const;
+    // лʱȽϣؽ̵˳룬˻ʱΪ1
+    int Finish(const BenchmarkResult& result) const;
+};
+
+bool BenchmarkOptions::Parse(int argc, char* argv[], std::vector<std::string>* others)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (option == "--benchmark" && hasValue) {
+            mEnabled = true;
+            mPathFile = argv[++i];
+        }
+        else if (option == "--warmup" && hasValue) {
+            mSettings.mWarmupFrames = std::atoi(argv[++i]);
+        }
+        else if (option == "--measure" && hasValue) {
+            mSettings.mMeasureFrames = std::atoi(argv[++i]);
+        }
+        else if (option == "--output" && hasValue) {
+            mOutputFile = argv[++i];
+        }
+        else if (option == "--baseline" && hasValue) {
+            mBaselineFile = argv[++i];
+        }
+        else if (option == "--threshold" && hasValue) {
+            mSettings.mRegressionThreshold = static_cast<float>(std::atof(argv[++i]));
+        }
+        else if (others) {
+            others->push_back(option);
+        }
+        else {
+            std::cout << "Unknown option: " << option << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BenchmarkOptions::LoadPath(const CameraPath& defaultPath, CameraPath& path) const
+{
+    if (mPathFile == "orbit") {
+        path = defaultPath;
+        return true;
+    }
+    return path.Load(mPathFile);
+}
+
+int BenchmarkOptions::Finish(const BenchmarkResult& result) const
+{
+    std::cout << "Benchmark " << result.mScene << " " << result.mWidth << "x" << result.mHeight
+        << ", " << result.mFrames << " frames" << std::endl;
+    for (auto&& metric : result.mMetrics) {
+        std::cout << "  " << metric.first << ": " << metric.second << std::endl;
+    }
+    result.WriteJson(mOutputFile);
+
+    if (mBaselineFile.empty()) {
+        return 0;
+    }
+    BenchmarkResult baseline;
+    if (!baseline.LoadJson(mBaselineFile)) {
+        return 1;
+    }
+    std::cout << "Compare with " << mBaselineFile << " (threshold " << mSettings.mRegressionThreshold * 100.0f << "%)" << std::endl;
+    bool passed = result.Compare(baseline, mSettings.mRegressionThreshold, std::cout);
+    std::cout << (passed ? "PASSED" : "REGRESSED") << std::endl;
+    return passed ? 0 : 1;
+}
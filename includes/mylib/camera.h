@@ -128,6 +128,16 @@ public:
 		_UpdateViewMatrix();
 	}
 
+	// ֱλúͳĿ㣬ͬʱתǣ֮
+	void SetLookAt(const glm::vec3& position, const glm::vec3& target)
+	{
+		cameraPos = position;
+		cameraFront = glm::normalize(target - position);
+		pitch = glm::degrees(asin(std::max(std::min(cameraFront.y, 1.0f), -1.0f)));
+		yaw = glm::degrees(atan2(cameraFront.x, -cameraFront.z));
+		_UpdateViewMatrix();
+	}
+
 	void SetFOV(float yOffset)
 	{
 		if (fov >= 1.0f && fov <= 45.0f)
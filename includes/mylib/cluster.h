@@ -0,0 +1,300 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <mylib/shader_s.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#define MYLIB_CLUSTER_SSE 1
+#endif
+
+
+// ִǰȾĹԴ
+// ׶尴Ļֿ飬ȰָƬֳgridX * gridY * gridZأfroxel
+// ÿ֡CPUϰѵԴ;۹Ʒ䵽Уϴ壺
+//   lightData    RGBA32F ÿԴ6texel_packLight
+//   lightIndices R32UI   дصĹԴ±
+//   clusters     RG32UI  ÿlightIndicesеʼλú
+// Ƭɫgl_FragCoordͼռҵڵĴأֻеĹԴ
+class LightClusters {
+public:
+    static const std::uint32_t kTexelsPerLight = 6;
+
+    LightClusters(std::uint32_t gridX = 16, std::uint32_t gridY = 9, std::uint32_t gridZ = 24);
+
+    // ͶӰ仯ʱ¼ÿصİΧУȻԴϴ
+    void Update(const std::vector<LightParameters::PointLight>& pointLights, const std::vector<LightParameters::SpotLight>& spotLights,
+        const glm::mat4& viewMat, const glm::mat4& projMat);
+
+    // 嵽firstUnitʼԪ÷ִزscreenSizeΪȾĿС
+    void Bind(Shader& shader, int firstUnit, const glm::vec2& screenSize);
+
+    std::uint32_t GetClusterCount() const { return mGridX * mGridY * mGridZ; }
+    std::uint32_t GetLightCount() const { return mLightCount; }
+    // дصĹԴ±ԴƽÿصĹԴ
+    std::uint32_t GetIndexCount() const { return static_cast<std::uint32_t>(mIndices.size()); }
+
+private:
+    std::uint32_t mGridX;
+    std::uint32_t mGridY;
+    std::uint32_t mGridZ;
+    std::uint32_t mSliceStride;  // ÿص4뷽SIMD
+
+    // ͼռÿصİΧУSoA
+    std::vector<float> mMinX, mMinY, mMinZ;
+    std::vector<float> mMaxX, mMaxY, mMaxZ;
+    glm::mat4 mBoundsProj = glm::mat4(0.0f);
+    float mNear = 0.1f;
+    float mFar = 100.0f;
+
+    std::uint32_t mLightCount = 0;
+    std::vector<glm::vec4> mLightData;
+    std::vector<std::uint32_t> mPairs;  // ཻԵĽÿΪ(±, Դ±)
+    std::vector<std::uint32_t> mRecords;
+    std::vector<std::uint32_t> mIndices;
+
+    unsigned int mBuffers[3];
+    unsigned int mTextures[3];
+
+    void _buildClusterBounds(const glm::mat4& projMat);
+    void _packLight(std::uint32_t type, const glm::vec3& position, const glm::vec3& direction, float cutOff, float outerCutOff,
+        float constant, float linear, float quadratic, const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular, float radius);
+    void _binSphere(std::uint32_t light, const glm::vec3& center, float radius);
+    void _binCone(std::uint32_t light, const glm::vec3& position, const glm::vec3& direction, float cosAngle, float range);
+    void _upload(std::uint32_t index, GLenum format, const void* data, std::size_t size);
+};
+
+LightClusters::LightClusters(std::uint32_t gridX, std::uint32_t gridY, std::uint32_t gridZ)
+    : mGridX(gridX), mGridY(gridY), mGridZ(gridZ)
+{
+    mSliceStride = (gridX * gridY + 3) / 4 * 4;
+    std::size_t boundsCount = static_cast<std::size_t>(mSliceStride) * gridZ;
+    mMinX.resize(boundsCount); mMinY.resize(boundsCount); mMinZ.resize(boundsCount);
+    mMaxX.resize(boundsCount); mMaxY.resize(boundsCount); mMaxZ.resize(boundsCount);
+
+    glGenBuffers(3, mBuffers);
+    glGenTextures(3, mTextures);
+}
+
+void LightClusters::_buildClusterBounds(const glm::mat4& projMat)
+{
+    mBoundsProj = projMat;
+    // ͸ӾȡԶƽ
+    mNear = projMat[3][2] / (projMat[2][2] - 1.0f);
+    mFar = projMat[3][2] / (projMat[2][2] + 1.0f);
+
+    // õĶΪհΧУԶཻ
+    std::fill(mMinX.begin(), mMinX.end(), 1e30f);
+    std::fill(mMaxX.begin(), mMaxX.end(), -1e30f);
+
+    glm::mat4 invProj = glm::inverse(projMat);
+    for (std::uint32_t z = 0; z < mGridZ; z++) {
+        // ָƬshaderȼƬĹʽһ
+        float sliceNear = mNear * std::pow(mFar / mNear, static_cast<float>(z) / mGridZ);
+        float sliceFar = mNear * std::pow(mFar / mNear, static_cast<float>(z + 1) / mGridZ);
+        for (std::uint32_t y = 0; y < mGridY; y++) {
+            for (std::uint32_t x = 0; x < mGridX; x++) {
+                glm::vec3 boundsMin(1e30f), boundsMax(-1e30f);
+                for (int corner = 0; corner < 4; corner++) {
+                    // ֿǵڽƽϵλã߷
+                    float ndcX = static_cast<float>(x + (corner & 1)) / mGridX * 2.0f - 1.0f;
+                    float ndcY = static_cast<float>(y + (corner >> 1)) / mGridY * 2.0f - 1.0f;
+                    glm::vec4 ray = invProj * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+                    glm::vec3 dir = glm::vec3(ray) / ray.w;
+                    for (float depth : { sliceNear, sliceFar }) {
+                        glm::vec3 point = dir * (depth / -dir.z);
+                        boundsMin = glm::min(boundsMin, point);
+                        boundsMax = glm::max(boundsMax, point);
+                    }
+                }
+                std::size_t i = static_cast<std::size_t>(z) * mSliceStride + y * mGridX + x;
+                mMinX[i] = boundsMin.x; mMinY[i] = boundsMin.y; mMinZ[i] = boundsMin.z;
+                mMaxX[i] = boundsMax.x; mMaxY[i] = boundsMax.y; mMaxZ[i] = boundsMax.z;
+            }
+        }
+    }
+}
+
+void LightClusters::_packLight(std::uint32_t type, const glm::vec3& position, const glm::vec3& direction, float cutOff, float outerCutOff,
+    float constant, float linear, float quadratic, const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular, float radius)
+{
+    mLightData.emplace_back(position, static_cast<float>(type));
+    mLightData.emplace_back(direction, cutOff);
+    mLightData.emplace_back(ambient, constant);
+    mLightData.emplace_back(diffuse, linear);
+    mLightData.emplace_back(specular, quadratic);
+    mLightData.emplace_back(outerCutOff, radius, 0.0f, 0.0f);
+}
+
+void LightClusters::_binSphere(std::uint32_t light, const glm::vec3& center, float radius)
+{
+    // ֻ԰ΧȷΧڵƬ
+    float depthMin = std::max(-center.z - radius, mNear);
+    float depthMax = std::min(-center.z + radius, mFar);
+    if (depthMin > depthMax) {
+        return;
+    }
+    float sliceScale = mGridZ / std::log(mFar / mNear);
+    std::uint32_t sliceBegin = static_cast<std::uint32_t>(std::max(0.0f, std::floor(std::log(depthMin / mNear) * sliceScale)));
+    std::uint32_t sliceEnd = std::min(mGridZ, static_cast<std::uint32_t>(std::floor(std::log(depthMax / mNear) * sliceScale)) + 1);
+
+    float radiusSq = radius * radius;
+    std::uint32_t sliceCount = mGridX * mGridY;
+    for (std::uint32_t z = sliceBegin; z < sliceEnd; z++) {
+        std::size_t base = static_cast<std::size_t>(z) * mSliceStride;
+#ifdef MYLIB_CLUSTER_SSE
+        // һβ4أΧеĵƽ뾶ƽȽ
+        __m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), cz = _mm_set1_ps(center.z);
+        __m128 r2 = _mm_set1_ps(radiusSq);
+        __m128 zero = _mm_setzero_ps();
+        for (std::uint32_t i = 0; i < mSliceStride; i += 4) {
+            std::size_t c = base + i;
+            __m128 dx = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&mMinX[c]), cx), zero), _mm_max_ps(_mm_sub_ps(cx, _mm_loadu_ps(&mMaxX[c])), zero));
+            __m128 dy = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&mMinY[c]), cy), zero), _mm_max_ps(_mm_sub_ps(cy, _mm_loadu_ps(&mMaxY[c])), zero));
+            __m128 dz = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&mMinZ[c]), cz), zero), _mm_max_ps(_mm_sub_ps(cz, _mm_loadu_ps(&mMaxZ[c])), zero));
+            __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            int mask = _mm_movemask_ps(_mm_cmple_ps(distSq, r2));
+            while (mask) {
+                int lane = 0;
+                while (!(mask & (1 << lane))) {
+                    lane++;
+                }
+                mask &= ~(1 << lane);
+                mPairs.push_back(z * sliceCount + i + lane);
+                mPairs.push_back(light);
+            }
+        }
+#else
+        for (std::uint32_t i = 0; i < sliceCount; i++) {
+            std::size_t c = base + i;
+            float dx = std::max(mMinX[c] - center.x, 0.0f) + std::max(center.x - mMaxX[c], 0.0f);
+            float dy = std::max(mMinY[c] - center.y, 0.0f) + std::max(center.y - mMaxY[c], 0.0f);
+            float dz = std::max(mMinZ[c] - center.z, 0.0f) + std::max(center.z - mMaxZ[c], 0.0f);
+            if (dx * dx + dy * dy + dz * dz <= radiusSq) {
+                mPairs.push_back(z * sliceCount + i);
+                mPairs.push_back(light);
+            }
+        }
+#endif
+    }
+}
+
+void LightClusters::_binCone(std::uint32_t light, const glm::vec3& position, const glm::vec3& direction, float cosAngle, float range)
+{
+    // ðΧɸѡٰÿؿΧ׶ȷ
+    std::size_t first = mPairs.size();
+    _binSphere(light, position, range);
+
+    float sinAngle = std::sqrt(std::max(0.0f, 1.0f - cosAngle * cosAngle));
+    std::uint32_t sliceCount = mGridX * mGridY;
+    std::size_t kept = first;
+    for (std::size_t i = first; i < mPairs.size(); i += 2) {
+        std::uint32_t cluster = mPairs[i];
+        std::size_t c = static_cast<std::size_t>(cluster / sliceCount) * mSliceStride + cluster % sliceCount;
+        glm::vec3 boundsMin(mMinX[c], mMinY[c], mMinZ[c]);
+        glm::vec3 boundsMax(mMaxX[c], mMaxY[c], mMaxZ[c]);
+        glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+        float radius = glm::length(boundsMax - center);
+
+        glm::vec3 v = center - position;
+        float vLenSq = glm::dot(v, v);
+        float v1Len = glm::dot(v, direction);
+        float distClosest = cosAngle * std::sqrt(std::max(0.0f, vLenSq - v1Len * v1Len)) - v1Len * sinAngle;
+        if (distClosest > radius || v1Len > range + radius || v1Len < -radius) {
+            continue;
+        }
+        mPairs[kept++] = cluster;
+        mPairs[kept++] = light;
+    }
+    mPairs.resize(kept);
+}
+
+void LightClusters::Update(const std::vector<LightParameters::PointLight>& pointLights, const std::vector<LightParameters::SpotLight>& spotLights,
+    const glm::mat4& viewMat, const glm::mat4& projMat)
+{
+    if (projMat != mBoundsProj) {
+        _buildClusterBounds(projMat);
+    }
+
+    mLightData.clear();
+    mPairs.clear();
+    mLightCount = 0;
+
+    for (auto&& pointLight : pointLights) {
+        float radius = pointLight.GetInfluenceRadius();
+        _packLight(0, pointLight.mPosition, glm::vec3(0.0f), 0.0f, 0.0f, pointLight.mConstant, pointLight.mLinear, pointLight.mQuadratic,
+            pointLight.mAmbient, pointLight.mDiffuse, pointLight.mSpecular, radius);
+        _binSphere(mLightCount++, glm::vec3(viewMat * glm::vec4(pointLight.mPosition, 1.0f)), radius);
+    }
+    for (auto&& spotLight : spotLights) {
+        float radius = spotLight.GetInfluenceRadius();
+        _packLight(1, spotLight.mPosition, spotLight.mDirection, spotLight.mCutOff, spotLight.mOuterCutOff,
+            spotLight.mConstant, spotLight.mLinear, spotLight.mQuadratic, spotLight.mAmbient, spotLight.mDiffuse, spotLight.mSpecular, radius);
+        glm::vec3 viewDir = glm::normalize(glm::vec3(viewMat * glm::vec4(spotLight.mDirection, 0.0f)));
+        _binCone(mLightCount++, glm::vec3(viewMat * glm::vec4(spotLight.mPosition, 1.0f)), viewDir, spotLight.mOuterCutOff, radius);
+    }
+
+    // ͳÿصĹԴǰ׺͵õʼλãٰԴ±
+    std::uint32_t clusterCount = GetClusterCount();
+    mRecords.assign(clusterCount * 2, 0);
+    for (std::size_t i = 0; i < mPairs.size(); i += 2) {
+        mRecords[mPairs[i] * 2 + 1]++;
+    }
+    std::uint32_t offset = 0;
+    for (std::uint32_t i = 0; i < clusterCount; i++) {
+        mRecords[i * 2] = offset;
+        offset += mRecords[i * 2 + 1];
+        mRecords[i * 2 + 1] = 0;
+    }
+    mIndices.resize(offset);
+    for (std::size_t i = 0; i < mPairs.size(); i += 2) {
+        std::uint32_t* record = &mRecords[mPairs[i] * 2];
+        mIndices[record[0] + record[1]++] = mPairs[i + 1];
+    }
+
+    // 岻Ϊ
+    if (mLightData.empty()) {
+        mLightData.emplace_back(0.0f);
+    }
+    if (mIndices.empty()) {
+        mIndices.push_back(0);
+    }
+    _upload(0, GL_RGBA32F, mLightData.data(), mLightData.size() * sizeof(glm::vec4));
+    _upload(1, GL_R32UI, mIndices.data(), mIndices.size() * sizeof(std::uint32_t));
+    _upload(2, GL_RG32UI, mRecords.data(), mRecords.size() * sizeof(std::uint32_t));
+}
+
+void LightClusters::_upload(std::uint32_t index, GLenum format, const void* data, std::size_t size)
+{
+    // ·洢ᶪһ֡ʹõľݶҪȴ
+    glBindBuffer(GL_TEXTURE_BUFFER, mBuffers[index]);
+    glBufferData(GL_TEXTURE_BUFFER, size, data, GL_STREAM_DRAW);
+    RenderStats::Get().AddBufferUpload(size);
+    glBindTexture(GL_TEXTURE_BUFFER, mTextures[index]);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, mBuffers[index]);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::Bind(Shader& shader, int firstUnit, const glm::vec2& screenSize)
+{
+    static constexpr UniformId names[3] = { "lightData"_uid, "lightIndices"_uid, "clusters"_uid };
+    for (int i = 0; i < 3; i++) {
+        glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+        glBindTexture(GL_TEXTURE_BUFFER, mTextures[i]);
+        shader.setInt(names[i], firstUnit + i);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    // Ƭ± = log() * zScale - zBias
+    float logRatio = std::log(mFar / mNear);
+    shader.setVec3("clusterGrid"_uid, static_cast<float>(mGridX), static_cast<float>(mGridY), static_cast<float>(mGridZ));
+    shader.setFloat("clusterZScale"_uid, mGridZ / logRatio);
+    shader.setFloat("clusterZBias"_uid, mGridZ * std::log(mNear) / logRatio);
+    shader.setVec2("screenSize"_uid, screenSize);
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <mylib/render_stats.h>
+#include <mylib/render_device.h>
+
+
+// ͼAPI޹صȾ̶16ֽڣ˳
+enum class RenderCommandType : std::uint8_t
+{
+    bindProgram,
+    bindVertexArray,
+    bindTexture,
+    setUniformBlock,
+    drawIndexed,
+};
+
+struct RenderCommand
+{
+    RenderCommandType mType;
+    std::uint8_t mSlot;      // Ԫ / uniform󶨵
+    std::uint32_t mHandle;   // program / VAO / ID߻Ƶ
+    std::uint32_t mOffset;   // uniformеƫ / Ĳ
+    std::uint32_t mSize;     // uniformݴС
+};
+
+
+// 壬ÿ̶߳ռһֻ¼κGLԿڹ߳ʹ
+// uniformݶResetȶÿ֡ٷڴ
+class CommandBuffer
+{
+public:
+    // alignmentΪuniformݵĶҪ󣬼GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+    CommandBuffer(std::uint32_t alignment = 256) : mAlignment(alignment) {}
+
+    void Reset()
+    {
+        mCommands.clear();
+        mUniformData.clear();
+    }
+
+    void BindProgram(std::uint32_t program)
+    {
+        mCommands.push_back({ RenderCommandType::bindProgram, 0, program, 0, 0 });
+    }
+
+    void BindVertexArray(std::uint32_t vao)
+    {
+        mCommands.push_back({ RenderCommandType::bindVertexArray, 0, vao, 0, 0 });
+    }
+
+    // samplerΪ0ʱʹԼĲ
+    void BindTexture(std::uint8_t unit, std::uint32_t texture, std::uint32_t sampler = 0)
+    {
+        mCommands.push_back({ RenderCommandType::bindTexture, unit, texture, sampler, 0 });
+    }
+
+    // һuniformݵطʱ󶨵uniformbinding
+    template<typename T>
+    void SetUniformBlock(std::uint8_t binding, const T& data)
+    {
+        std::uint32_t offset = static_cast<std::uint32_t>(mUniformData.size());
+        std::uint32_t alignedSize = (sizeof(T) + mAlignment - 1) / mAlignment * mAlignment;
+        mUniformData.resize(offset + alignedSize);
+        std::memcpy(mUniformData.data() + offset, &data, sizeof(T));
+        mCommands.push_back({ RenderCommandType::setUniformBlock, binding, 0, offset, static_cast<std::uint32_t>(sizeof(T)) });
+    }
+
+    void DrawIndexed(std::uint32_t indexCount)
+    {
+        mCommands.push_back({ RenderCommandType::drawIndexed, 0, indexCount, 0, 0 });
+    }
+
+    const std::vector<RenderCommand>& GetCommands() const { return mCommands; }
+    const std::vector<std::uint8_t>& GetUniformData() const { return mUniformData; }
+
+private:
+    std::uint32_t mAlignment;
+    std::vector<RenderCommand> mCommands;
+    std::vector<std::uint8_t> mUniformData;
+};
+
+
+// GL߳ϺϲطŶ
+class CommandReplayer
+{
+public:
+    CommandReplayer();
+
+    std::uint32_t GetUniformAlignment() const { return mAlignment; }
+
+    // ˳طţлuniformݺϲһϴͬһUBO
+    void Submit(const std::vector<CommandBuffer>& buffers);
+
+    // һύʵִеĻƴظ״̬л
+    std::uint32_t GetDrawCount() const { return mDrawCount; }
+    std::uint32_t GetSkippedCount() const { return mSkippedCount; }
+
+private:
+    unsigned int mUBO;
+    std::uint32_t mUBOSize = 0;
+    std::uint32_t mAlignment;
+    std::vector<std::uint32_t> mBaseOffsets;
+
+    std::uint32_t mDrawCount = 0;
+    std::uint32_t mSkippedCount = 0;
+};
+
+CommandReplayer::CommandReplayer()
+{
+    RenderDevice& device = RenderDevice::Get();
+    mAlignment = device.GetUniformBufferAlignment();
+    mUBO = device.CreateBuffer(DeviceBufferType::uniform, 0, nullptr, true);
+}
+
+void CommandReplayer::Submit(const std::vector<CommandBuffer>& buffers)
+{
+    // ÿuniformUBOеʼλãÿݴСѾ
+    std::uint32_t totalSize = 0;
+    mBaseOffsets.resize(buffers.size());
+    for (size_t i = 0; i < buffers.size(); i++) {
+        mBaseOffsets[i] = totalSize;
+        totalSize += static_cast<std::uint32_t>(buffers[i].GetUniformData().size());
+    }
+
+    // ȶݣȴһ֡ʹõĻ
+    RenderDevice& device = RenderDevice::Get();
+    device.SetBufferData(mUBO, DeviceBufferType::uniform, totalSize, nullptr);
+    RenderStats& stats = RenderStats::Get();
+    stats.AddBufferMemory(static_cast<std::int64_t>(totalSize) - mUBOSize);
+    mUBOSize = totalSize;
+    for (size_t i = 0; i < buffers.size(); i++) {
+        auto&& data = buffers[i].GetUniformData();
+        if (!data.empty()) {
+            device.UpdateBuffer(mUBO, DeviceBufferType::uniform, mBaseOffsets[i], data.size(), data.data());
+            stats.AddBufferUpload(data.size());
+        }
+    }
+
+    // ¼ǰ״̬ظİ
+    std::uint32_t currentProgram = 0;
+    std::uint32_t currentVAO = 0;
+    std::uint32_t currentTextures[16] = { 0 };
+    std::uint32_t currentSamplers[16] = { 0 };
+    mDrawCount = 0;
+    mSkippedCount = 0;
+
+    for (size_t i = 0; i < buffers.size(); i++) {
+        for (auto&& command : buffers[i].GetCommands()) {
+            switch (command.mType)
+            {
+            case RenderCommandType::bindProgram:
+                if (command.mHandle == currentProgram) {
+                    mSkippedCount++;
+                    break;
+                }
+                currentProgram = command.mHandle;
+                device.BindProgram(command.mHandle);
+                RenderStats::Get().mProgramBinds++;
+                break;
+            case RenderCommandType::bindVertexArray:
+                if (command.mHandle == currentVAO) {
+                    mSkippedCount++;
+                    break;
+                }
+                currentVAO = command.mHandle;
+                device.BindVertexArray(command.mHandle);
+                RenderStats::Get().mVertexArrayBinds++;
+                break;
+            case RenderCommandType::bindTexture:
+                if (command.mSlot < 16 && currentTextures[command.mSlot] == command.mHandle && currentSamplers[command.mSlot] == command.mOffset) {
+                    mSkippedCount++;
+                    break;
+                }
+                if (command.mSlot < 16) {
+                    currentTextures[command.mSlot] = command.mHandle;
+                    currentSamplers[command.mSlot] = command.mOffset;
+                }
+                device.BindTexture(command.mSlot, DeviceTextureType::texture2D, command.mHandle, command.mOffset);
+                RenderStats::Get().mTextureBinds++;
+                break;
+            case RenderCommandType::setUniformBlock:
+                device.BindUniformBuffer(command.mSlot, mUBO, mBaseOffsets[i] + command.mOffset, command.mSize);
+                break;
+            case RenderCommandType::drawIndexed:
+                device.DrawIndexed(command.mHandle);
+                RenderStats::Get().AddDraw(command.mHandle);
+                mDrawCount++;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    device.BindVertexArray(0);
+}
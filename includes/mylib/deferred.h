@@ -0,0 +1,184 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <iostream>
+#include <vector>
+#include <mylib/shader_s.h>
+#include <mylib/model.h>
+#include <mylib/render_target.h>
+
+
+// ӳȾG-buffer
+// ν׶ֻдʺͷߣս׶Ļռ㣬ÿԴĿֻǵй
+//   Ŀ0 RGBA8   rgbΪalbedoaΪ߹ǿ
+//   Ŀ1 RGBA16F xyzΪռ䷨ߣaΪǷҪ
+//     DEPTH24_STENCIL8ʱؽռλ
+// ĿBeginGeometryʱӶȡսRelease黹֮passԸЩԴ
+class GBuffer {
+public:
+    GBuffer(RenderTargetPool& pool) : mPool(pool) {}
+
+    // ʼν׶Σ󶨲G-bufferرջϣ͸Ӱ취ߺͱ
+    // СҪ볡֡ͬ
+    void BeginGeometry(int width, int height);
+    // ս黹G-buffer
+    void Release();
+    // ν׶ΣȸƵtargetFBOϣ֮ĹԴǰ嶼ʹ
+    void EndGeometry(unsigned int targetFBO);
+
+    // ȫƶ⣬дtargetFBO
+    void LightDirectional(Shader& dirShader, unsigned int quadVAO, const LightParameters& lightParams,
+        const ModelRenderParam& modelRenderParam, unsigned int targetFBO);
+    // ðΧƵԴ;۹ƣӵtargetFBOϣsphereModelΪλ
+    void LightVolumes(Shader& lightShader, Model& sphereModel, const std::vector<LightParameters::PointLight>& pointLights,
+        const LightParameters::SpotLight& spotLight, float shininess, const ModelRenderParam& modelRenderParam, unsigned int targetFBO);
+
+private:
+    RenderTargetPool& mPool;
+    int mWidth = 0;
+    int mHeight = 0;
+    unsigned int mFBO = 0;
+    RenderTarget* mAlbedoSpecTarget = nullptr;
+    RenderTarget* mNormalTarget = nullptr;
+    RenderTarget* mDepthTarget = nullptr;
+
+    void _bindTextures(Shader& shader, const ModelRenderParam& modelRenderParam);
+};
+
+void GBuffer::BeginGeometry(int width, int height)
+{
+    // Ҫͽϸߵľȣʹøʽ
+    // 볡֡ȸʽֱͬӸƹȥ
+    mWidth = width;
+    mHeight = height;
+    mAlbedoSpecTarget = mPool.Acquire(RenderTargetDesc(GL_RGBA8, width, height));
+    mNormalTarget = mPool.Acquire(RenderTargetDesc(GL_RGBA16F, width, height));
+    mDepthTarget = mPool.Acquire(RenderTargetDesc(GL_DEPTH24_STENCIL8, width, height));
+    mFBO = mPool.GetFramebuffer({ mAlbedoSpecTarget, mNormalTarget }, mDepthTarget);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, mFBO);
+    glViewport(0, 0, mWidth, mHeight);
+
+    const float clearColor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    glClearBufferfv(GL_COLOR, 0, clearColor);
+    glClearBufferfv(GL_COLOR, 1, clearColor);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    glEnable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+}
+
+void GBuffer::EndGeometry(unsigned int targetFBO)
+{
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, mFBO);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, targetFBO);
+    glBlitFramebuffer(0, 0, mWidth, mHeight, 0, 0, mWidth, mHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFBO);
+    glEnable(GL_BLEND);
+}
+
+void GBuffer::Release()
+{
+    mPool.Release(mAlbedoSpecTarget);
+    mPool.Release(mNormalTarget);
+    mPool.Release(mDepthTarget);
+    mAlbedoSpecTarget = mNormalTarget = mDepthTarget = nullptr;
+}
+
+void GBuffer::_bindTextures(Shader& shader, const ModelRenderParam& modelRenderParam)
+{
+    shader.setInt("gAlbedoSpec"_uid, 0);
+    shader.setInt("gNormal"_uid, 1);
+    shader.setInt("gDepth"_uid, 2);
+    // Gûmipͨ豸󶨻ԼĲĲ
+    RenderDevice& device = RenderDevice::Get();
+    device.BindTexture(0, DeviceTextureType::texture2D, mAlbedoSpecTarget->mTexture);
+    device.BindTexture(1, DeviceTextureType::texture2D, mNormalTarget->mTexture);
+    device.BindTexture(2, DeviceTextureType::texture2D, mDepthTarget->mTexture);
+
+    // ս׶ؽռλ
+    shader.setVec3("viewPos"_uid, modelRenderParam.mCameraPos);
+    shader.setMat4("invViewProj"_uid, glm::inverse(modelRenderParam.mProjMat * modelRenderParam.mViewMat));
+}
+
+void GBuffer::LightDirectional(Shader& dirShader, unsigned int quadVAO, const LightParameters& lightParams,
+    const ModelRenderParam& modelRenderParam, unsigned int targetFBO)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFBO);
+    glViewport(0, 0, mWidth, mHeight);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+
+    dirShader.use();
+    _bindTextures(dirShader, modelRenderParam);
+    dirShader.setFloat("shininess"_uid, lightParams.mMaterial.mShininess);
+    dirShader.setVec3("dirLight.direction"_uid, lightParams.mDirectLight.mDirection);
+    dirShader.setVec3("dirLight.ambient"_uid, lightParams.mDirectLight.mAmbient);
+    dirShader.setVec3("dirLight.diffuse"_uid, lightParams.mDirectLight.mDiffuse);
+    dirShader.setVec3("dirLight.specular"_uid, lightParams.mDirectLight.mSpecular);
+
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+
+    glEnable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+}
+
+void GBuffer::LightVolumes(Shader& lightShader, Model& sphereModel, const std::vector<LightParameters::PointLight>& pointLights,
+    const LightParameters::SpotLight& spotLight, float shininess, const ModelRenderParam& modelRenderParam, unsigned int targetFBO)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFBO);
+    glViewport(0, 0, mWidth, mHeight);
+
+    // ֻưΧı棬ڳ֮زſܱʱҲ©
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_GEQUAL);
+    glDepthMask(GL_FALSE);
+    glCullFace(GL_FRONT);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+
+    lightShader.use();
+    _bindTextures(lightShader, modelRenderParam);
+    lightShader.setFloat("shininess"_uid, shininess);
+    lightShader.setVec2("screenSize"_uid, static_cast<float>(mWidth), static_cast<float>(mHeight));
+
+    ModelRenderParam volumeRenderParam = modelRenderParam;
+    auto drawVolume = [&](const glm::vec3& position, float radius) {
+        volumeRenderParam.mModelTransMat = glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(radius));
+        sphereModel.Draw(lightShader, volumeRenderParam);
+    };
+
+    lightShader.setInt("lightType"_uid, 0);
+    for (auto&& pointLight : pointLights) {
+        lightShader.setVec3("light.position"_uid, pointLight.mPosition);
+        lightShader.setFloat("light.constant"_uid, pointLight.mConstant);
+        lightShader.setFloat("light.linear"_uid, pointLight.mLinear);
+        lightShader.setFloat("light.quadratic"_uid, pointLight.mQuadratic);
+        lightShader.setVec3("light.ambient"_uid, pointLight.mAmbient);
+        lightShader.setVec3("light.diffuse"_uid, pointLight.mDiffuse);
+        lightShader.setVec3("light.specular"_uid, pointLight.mSpecular);
+        drawVolume(pointLight.mPosition, pointLight.GetInfluenceRadius());
+    }
+
+    // ۹ͬʹðΧ׶֮shaderеĽǶ˥ȥ
+    lightShader.setInt("lightType"_uid, 1);
+    lightShader.setVec3("light.position"_uid, spotLight.mPosition);
+    lightShader.setVec3("light.direction"_uid, spotLight.mDirection);
+    lightShader.setFloat("light.cutOff"_uid, spotLight.mCutOff);
+    lightShader.setFloat("light.outerCutOff"_uid, spotLight.mOuterCutOff);
+    lightShader.setFloat("light.constant"_uid, spotLight.mConstant);
+    lightShader.setFloat("light.linear"_uid, spotLight.mLinear);
+    lightShader.setFloat("light.quadratic"_uid, spotLight.mQuadratic);
+    lightShader.setVec3("light.ambient"_uid, spotLight.mAmbient);
+    lightShader.setVec3("light.diffuse"_uid, spotLight.mDiffuse);
+    lightShader.setVec3("light.specular"_uid, spotLight.mSpecular);
+    drawVolume(spotLight.mPosition, spotLight.GetInfluenceRadius());
+
+    // ָĬ״̬
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    glCullFace(GL_BACK);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <mylib/shader_s.h>
+#include <mylib/render_target.h>
+
+
+// ֱ̬ʵĲ
+struct DynamicResolutionSettings
+{
+    float mTargetMs = 16.6f;      // ĿGPU֡ʱ
+    float mMinScale = 0.5f;       // ֱԴڵС
+    float mMaxScale = 1.0f;
+    float mStep = 0.05f;          // ȡÿ֡´СȾĿ
+    float mUpThreshold = 0.85f;   // ƽ֡ʱĿ߷ֱ
+    int mStableFrames = 30;       // ô֡һ
+};
+
+
+// ֱ̬ʿ
+// ÿ֡ʼͽʱ¼һGL_TIMESTAMP֮֡ٶȡȴGPU
+// ƽ֡ʱ䳬ĿʱʱȽͱĿһһʱߣ֮䲻
+class DynamicResolution {
+public:
+    DynamicResolution(const DynamicResolutionSettings& settings = DynamicResolutionSettings());
+    ~DynamicResolution();
+
+    void BeginFrame();
+    // һ֡ȡѾɵĲѯһ֡ı
+    void EndFrame();
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const { return mEnabled; }
+    float GetScale() const { return mEnabled ? mScale : 1.0f; }
+    // ƽGPU֡ʱ䣬
+    float GetGpuTime() const { return mSmoothedMs; }
+
+private:
+    // ѯӳٶȡ֡
+    static const int kQueryFrames = 4;
+
+    DynamicResolutionSettings mSettings;
+    unsigned int mQueries[kQueryFrames][2];
+    bool mPending[kQueryFrames] = {};
+    int mFrame = 0;
+
+    bool mEnabled = true;
+    float mScale;
+    float mSmoothedMs = 0.0f;
+    int mStableCount = 0;
+    int mCooldown = 0;
+
+    void _update(float gpuMs);
+    float _quantize(float scale) const;
+};
+
+DynamicResolution::DynamicResolution(const DynamicResolutionSettings& settings)
+    : mSettings(settings), mScale(settings.mMaxScale)
+{
+    glGenQueries(kQueryFrames * 2, &mQueries[0][0]);
+}
+
+DynamicResolution::~DynamicResolution()
+{
+    glDeleteQueries(kQueryFrames * 2, &mQueries[0][0]);
+}
+
+void DynamicResolution::SetEnabled(bool enabled)
+{
+    mEnabled = enabled;
+    mScale = mSettings.mMaxScale;
+    mStableCount = 0;
+    mCooldown = kQueryFrames;
+}
+
+void DynamicResolution::BeginFrame()
+{
+    glQueryCounter(mQueries[mFrame % kQueryFrames][0], GL_TIMESTAMP);
+}
+
+void DynamicResolution::EndFrame()
+{
+    int slot = mFrame % kQueryFrames;
+    glQueryCounter(mQueries[slot][1], GL_TIMESTAMP);
+    mPending[slot] = true;
+    mFrame++;
+
+    // һ֡ʼȡѾɵĲѯ
+    for (int i = 0; i < kQueryFrames; i++) {
+        int oldest = (mFrame + i) % kQueryFrames;
+        if (!mPending[oldest]) {
+            continue;
+        }
+        GLint available = 0;
+        glGetQueryObjectiv(mQueries[oldest][1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(mQueries[oldest][0], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(mQueries[oldest][1], GL_QUERY_RESULT, &end);
+        mPending[oldest] = false;
+        _update(static_cast<float>((end - begin) * 1e-6));
+    }
+}
+
+float DynamicResolution::_quantize(float scale) const
+{
+    scale = std::floor(scale / mSettings.mStep + 0.001f) * mSettings.mStep;
+    return std::min(std::max(scale, mSettings.mMinScale), mSettings.mMaxScale);
+}
+
+void DynamicResolution::_update(float gpuMs)
+{
+    mSmoothedMs = mSmoothedMs <= 0.0f ? gpuMs : mSmoothedMs * 0.9f + gpuMs * 0.1f;
+    if (!mEnabled) {
+        return;
+    }
+    // 仯ڶеĲѯǾɵķֱʣЩ
+    if (mCooldown > 0) {
+        mCooldown--;
+        return;
+    }
+
+    if (mSmoothedMs > mSettings.mTargetMs) {
+        // ƽ
+        float scale = _quantize(mScale * std::sqrt(mSettings.mTargetMs / mSmoothedMs));
+        if (scale < mScale) {
+            mScale = scale;
+            mCooldown = kQueryFrames;
+            mSmoothedMs = 0.0f;
+        }
+        mStableCount = 0;
+    }
+    else if (mSmoothedMs < mSettings.mTargetMs * mSettings.mUpThreshold && mScale < mSettings.mMaxScale) {
+        if (++mStableCount >= mSettings.mStableFrames) {
+            mScale = _quantize(mScale + mSettings.mStep);
+            mStableCount = 0;
+            mCooldown = kQueryFrames;
+            mSmoothedMs = 0.0f;
+        }
+    }
+    else {
+        mStableCount = 0;
+    }
+}
+
+
+// ռŴñԵӦĲֵŴĿСԱȶӦ
+// shaderɵߴupscaleShaderΪshader_4_upscale.fssharpenShaderΪshader_4_sharpen.fs
+class SpatialUpscaler {
+public:
+    SpatialUpscaler(RenderTargetPool& pool) : mPool(pool) {}
+
+    // sharpness01֮䣬Ϊ0ʱ񻯣ŴֱдtargetFBO
+    void Apply(Shader& upscaleShader, Shader& sharpenShader, unsigned int quadVAO, unsigned int sourceTexture,
+        unsigned int targetFBO, int targetWidth, int targetHeight, float sharpness);
+
+private:
+    RenderTargetPool& mPool;
+};
+
+void SpatialUpscaler::Apply(Shader& upscaleShader, Shader& sharpenShader, unsigned int quadVAO, unsigned int sourceTexture,
+    unsigned int targetFBO, int targetWidth, int targetHeight, float sharpness)
+{
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    GLboolean blend = glIsEnabled(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(quadVAO);
+    glViewport(0, 0, targetWidth, targetHeight);
+
+    RenderTarget* upscaled = nullptr;
+    if (sharpness > 0.0f) {
+        upscaled = mPool.Acquire(RenderTargetDesc(GL_RGBA8, targetWidth, targetHeight));
+        glBindFramebuffer(GL_FRAMEBUFFER, mPool.GetFramebuffer({ upscaled }, nullptr));
+    }
+    else {
+        glBindFramebuffer(GL_FRAMEBUFFER, targetFBO);
+    }
+    upscaleShader.use();
+    upscaleShader.setInt("screenTexture"_uid, 0);
+    RenderDevice::Get().BindTexture(0, DeviceTextureType::texture2D, sourceTexture);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+
+    if (upscaled) {
+        glBindFramebuffer(GL_FRAMEBUFFER, targetFBO);
+        sharpenShader.use();
+        sharpenShader.setInt("screenTexture"_uid, 0);
+        sharpenShader.setFloat("sharpness"_uid, sharpness);
+        RenderDevice::Get().BindTexture(0, DeviceTextureType::texture2D, upscaled->mTexture);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        mPool.Release(upscaled);
+    }
+
+    glBindVertexArray(0);
+    if (depthTest) {
+        glEnable(GL_DEPTH_TEST);
+    }
+    if (blend) {
+        glEnable(GL_BLEND);
+    }
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+
+// ֡ڴ棺ÿ֡ʱݴһԤȷڴ˳䣬֡ʱãͷ
+// ÿ߳Լ֡ڴ棨FrameArena::ForThreadʱҪ
+// FrameVectorFrameStringFrameMapʹõǰ̵߳֡ڴ棬ֻһ֡ʹãܱ浽һ֡
+class FrameArena
+{
+public:
+    explicit FrameArena(std::size_t capacity = 64 * 1024);
+    ~FrameArena();
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // ǰ̵߳֡ڴ棬һʹʱ
+    static FrameArena& ForThread();
+    // ̵߳֡ڴ棬֡ûִʱ
+    static void ResetAll();
+
+    void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+    // һ֡ڴȫϣһ֡˶ڴʱϲΪһ飬֮֡Ҫϵͳ
+    void Reset();
+
+    // һ֡Ѿֽ
+    std::size_t GetUsed() const { return mPreviousBlocksUsed + mOffset; }
+    std::size_t GetCapacity() const;
+    // һֽ֡
+    std::size_t GetPeak() const { return std::max(mPeak, GetUsed()); }
+    // ǰ鲻ʱϵͳ¿Ĵ
+    std::uint64_t GetOverflowCount() const { return mOverflowCount; }
+
+private:
+    struct Block
+    {
+        std::uint8_t* mData;
+        std::size_t mSize;
+    };
+
+    // һǳפģһ֡ʱ
+    std::vector<Block> mBlocks;
+    std::size_t mOffset = 0;              // һѾõֽ
+    std::size_t mPreviousBlocksUsed = 0;  // ֮ǰĿõֽ
+    std::size_t mPeak = 0;
+    std::uint64_t mOverflowCount = 0;
+    bool mRegistered = false;
+
+    static std::vector<FrameArena*>& _getRegistry();
+    static std::mutex& _getRegistryMutex();
+};
+
+// ʹ֡ڴSTLdeallocateʲô
+template<typename T>
+class FrameAllocator
+{
+public:
+    using value_type = T;
+
+    FrameAllocator() : mArena(&FrameArena::ForThread()) {}
+    explicit FrameAllocator(FrameArena& arena) : mArena(&arena) {}
+    template<typename U>
+    FrameAllocator(const FrameAllocator<U>& other) : mArena(other.GetArena()) {}
+
+    T* allocate(std::size_t count) { return static_cast<T*>(mArena->Allocate(count * sizeof(T), alignof(T))); }
+    void deallocate(T*, std::size_t) {}
+
+    FrameArena* GetArena() const { return mArena; }
+
+    template<typename U>
+    bool operator==(const FrameAllocator<U>& other) const { return mArena == other.GetArena(); }
+    template<typename U>
+    bool operator!=(const FrameAllocator<U>& other) const { return mArena != other.GetArena(); }
+
+private:
+    FrameArena* mArena;
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+using FrameString = std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>;
+template<typename Key, typename Value, typename Compare = std::less<Key>>
+using FrameMap = std::map<Key, Value, Compare, FrameAllocator<std::pair<const Key, Value>>>;
+
+
+// ȫoperator newĵô֤ȶ֡ûжѷ
+// ֻڳһԴļдMYLIB_DEFINE_ALLOCATION_COUNTER()ʱŻͳƣһֱΪ0
+struct AllocationCounter
+{
+    static std::atomic<std::uint64_t>& GetCounter()
+    {
+        static std::atomic<std::uint64_t> counter(0);
+        return counter;
+    }
+    static std::uint64_t Get() { return GetCounter().load(std::memory_order_relaxed); }
+    static void Add() { GetCounter().fetch_add(1, std::memory_order_relaxed); }
+};
+
+#define MYLIB_DEFINE_ALLOCATION_COUNTER() \
+    void* operator new(std::size_t size) \
+    { \
+        AllocationCounter::Add(); \
+        if (void* pointer = std::malloc(size > 0 ? size : 1)) { \
+            return pointer; \
+        } \
+        throw std::bad_alloc(); \
+    } \
+    void* operator new[](std::size_t size) { return operator new(size); } \
+    void operator delete(void* pointer) noexcept { std::free(pointer); } \
+    void operator delete[](void* pointer) noexcept { std::free(pointer); } \
+    void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); } \
+    void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+
+FrameArena::FrameArena(std::size_t capacity)
+{
+    mBlocks.reserve(8);
+    mBlocks.push_back({ new std::uint8_t[capacity], capacity });
+}
+
+FrameArena::~FrameArena()
+{
+    if (mRegistered) {
+        std::lock_guard<std::mutex> lock(_getRegistryMutex());
+        auto& registry = _getRegistry();
+        registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+    }
+    for (auto&& block : mBlocks) {
+        delete[] block.mData;
+    }
+}
+
+std::vector<FrameArena*>& FrameArena::_getRegistry()
+{
+    static std::vector<FrameArena*> registry;
+    return registry;
+}
+
+std::mutex& FrameArena::_getRegistryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+FrameArena& FrameArena::ForThread()
+{
+    thread_local FrameArena arena;
+    if (!arena.mRegistered) {
+        std::lock_guard<std::mutex> lock(_getRegistryMutex());
+        _getRegistry().push_back(&arena);
+        arena.mRegistered = true;
+    }
+    return arena;
+}
+
+void FrameArena::ResetAll()
+{
+    std::lock_guard<std::mutex> lock(_getRegistryMutex());
+    for (auto&& arena : _getRegistry()) {
+        arena->Reset();
+    }
+}
+
+std::size_t FrameArena::GetCapacity() const
+{
+    std::size_t capacity = 0;
+    for (auto&& block : mBlocks) {
+        capacity += block.mSize;
+    }
+    return capacity;
+}
+
+void* FrameArena::Allocate(std::size_t size, std::size_t alignment)
+{
+    // ǵַƫƣ鱾Ķ벻Ӱ
+    Block* block = &mBlocks.back();
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block->mData);
+    std::uintptr_t address = (base + mOffset + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+    if (address + size > base + block->mSize) {
+        // ¿ǵǰһ֡вƵ
+        mPreviousBlocksUsed += mOffset;
+        std::size_t blockSize = std::max(block->mSize * 2, size + alignment);
+        mBlocks.push_back({ new std::uint8_t[blockSize], blockSize });
+        mOverflowCount++;
+        block = &mBlocks.back();
+        base = reinterpret_cast<std::uintptr_t>(block->mData);
+        mOffset = 0;
+        address = (base + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+    }
+    mOffset = address + size - base;
+    return reinterpret_cast<void*>(address);
+}
+
+void FrameArena::Reset()
+{
+    mPeak = GetPeak();
+    if (mBlocks.size() > 1) {
+        std::size_t capacity = GetCapacity();
+        for (auto&& block : mBlocks) {
+            delete[] block.mData;
+        }
+        mBlocks.clear();
+        mBlocks.push_back({ new std::uint8_t[capacity], capacity });
+    }
+    mOffset = 0;
+    mPreviousBlocksUsed = 0;
+}
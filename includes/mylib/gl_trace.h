@@ -0,0 +1,949 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// GLõץȡͻط
+// gladÿGLһָglad_glXxxץȡʱЩָ뻻ɰװ¼šҪݺٵԭ
+// װģ尴gladкָɣбgl_trace_functions.hУglad.cصĺһ
+//
+// traceļʽСˣ
+//   ļͷmagic "GLTR"汾ÿ1ֽڳ + ַ
+//   ÿã2ֽںţļͷе˳򣩣0xFFFFΪһ֡
+//             ˳򣺱ֱӱԭʼֽڣGLsync8ֽ
+//                         ָȱ1ֽڵGLTracePointervalueΪ8ֽڵֵƫƵȣpayloadΪ4ֽڳȼݣoutputΪ4ֽڳ
+//             зֵʱ淵ֵԭʼֽ
+//             glGen*úٱɵ֣4ֽڳȼݣطʱǷһ
+//
+// ƣӳ仺壨glMapBufferдݲᱻ¼ûаʱͻڴеͶ鲻ᱻ¼
+//       ޷ȷСָ¼Ϊunsupportedطʱ
+//       طŲӳֺuniformλãаͬ˳䣬һʱmismatch
+
+
+// 
+enum GLTraceFunctionId : std::uint16_t
+{
+#define GL_TRACE_FUNCTION(name) GLTraceId_##name,
+#include <mylib/gl_trace_functions.h>
+#undef GL_TRACE_FUNCTION
+    GLTraceId_count
+};
+
+// gladglXxxΪ꣬GL_TRACE_FUNCTIONвٰnameGL_TRACE_HOOKչҪֱƴ
+#define GL_TRACE_HOOK(name) GLTraceHook<GLTraceId_##name, decltype(glad_##name)>
+
+static const std::uint16_t kGLTraceFrameEnd = 0xFFFF;
+static const std::uint32_t kGLTraceMagic = 0x52544C47;  // "GLTR"
+static const std::uint32_t kGLTraceVersion = 1;
+static const int kGLTraceMaxArgs = 12;
+
+// ࣬ɲ;
+enum class GLTraceArgClass : std::uint8_t { scalar, handle, input, output, string, stringArray };
+// ָı淽ʽ
+enum class GLTracePointer : std::uint8_t { value, payload, output, unsupported };
+
+template<typename T>
+constexpr GLTraceArgClass GetGLTraceArgClass()
+{
+    if constexpr (std::is_same<T, GLsync>::value) {
+        return GLTraceArgClass::handle;
+    }
+    else if constexpr (std::is_same<T, const GLchar*>::value) {
+        return GLTraceArgClass::string;
+    }
+    else if constexpr (std::is_same<T, const GLchar* const*>::value) {
+        return GLTraceArgClass::stringArray;
+    }
+    else if constexpr (std::is_pointer<T>::value) {
+        return std::is_const<typename std::remove_pointer<T>::type>::value ? GLTraceArgClass::input : GLTraceArgClass::output;
+    }
+    else {
+        return GLTraceArgClass::scalar;
+    }
+}
+
+template<typename T>
+std::uint64_t GLTraceToBits(T value)
+{
+    std::uint64_t bits = 0;
+    if constexpr (std::is_pointer<T>::value) {
+        bits = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(value));
+    }
+    else {
+        std::memcpy(&bits, &value, sizeof(T));
+    }
+    return bits;
+}
+
+// ĲģɣץȡͻطŹ
+struct GLTraceSignature
+{
+    const char* mName;
+    std::uint8_t mArgCount;
+    std::uint8_t mArgSizes[kGLTraceMaxArgs];
+    GLTraceArgClass mArgClasses[kGLTraceMaxArgs];
+    std::uint8_t mResultSize;
+    GLTraceArgClass mResultClass;
+    std::uint8_t mVectorBytes;   // glUniform*vglVertexAttrib*vÿԪصֽ
+    bool mGeneratesNames;        // glGen*ú¼ɵ
+    bool mDeletesNames;          // glDelete*
+    bool mIsDraw;                // glDraw*glMultiDraw*
+};
+
+// طʱһ
+struct GLTraceArg
+{
+    std::uint64_t mValue;
+    GLTracePointer mMode;
+    const void* mPointer;
+    std::uint32_t mSize;         // payloadoutputֽ
+};
+
+// һãָָreaderڲݣȡһúʧЧ
+struct GLTraceCall
+{
+    std::uint16_t mFunction;     // еĺţkGLTraceFrameEnd
+    GLTraceArg mArgs[kGLTraceMaxArgs];
+    std::uint64_t mResult;
+    const std::uint8_t* mNames;  // glGen*ɵ
+    std::uint32_t mNamesSize;
+    std::uint32_t mPayloadBytes; // ݵֽ
+    bool mSupported;
+    std::vector<const char*> mStrings;
+};
+
+const GLTraceSignature* GetGLTraceSignatures();
+
+
+// ץȡGLãֻGL߳ʹ
+class GLCapture
+{
+public:
+    static GLCapture& Get()
+    {
+        static GLCapture capture;
+        return capture;
+    }
+
+    // 滻gladĺָ뿪ʼץȡҪgladLoadGL֮
+    bool Start(const std::string& path);
+    // ָԭĺָ벢дļ
+    void Stop();
+    bool IsCapturing() const { return mCapturing; }
+    // ÿ֡ʱãд֡
+    void EndFrame();
+    std::uint64_t GetBytesWritten() const { return mBytesWritten + mBuffer.size(); }
+    std::uint32_t GetFrameCount() const { return mFrames; }
+
+    // װ
+    void _writeCall(std::uint16_t function, const std::uint64_t* values);
+    void _writeResult(std::uint16_t function, const std::uint64_t* values, const void* result);
+
+private:
+    static constexpr std::size_t kFlushSize = 4 << 20;
+
+    std::ofstream mFile;
+    std::vector<std::uint8_t> mBuffer;
+    std::uint64_t mBytesWritten = 0;
+    std::uint32_t mFrames = 0;
+    bool mCapturing = false;
+
+    void _install(bool install);
+    void _flush();
+    void _put(const void* data, std::size_t size)
+    {
+        const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+        mBuffer.insert(mBuffer.end(), bytes, bytes + size);
+    }
+    template<typename T>
+    void _put(T value) { _put(&value, sizeof(T)); }
+    void _putPayload(const void* data, std::size_t size)
+    {
+        _put(GLTracePointer::payload);
+        _put(static_cast<std::uint32_t>(size));
+        _put(data, size);
+    }
+
+    GLTracePointer _getInputSize(std::uint16_t function, const std::uint64_t* values, std::size_t& size) const;
+    GLTracePointer _getOutputSize(std::uint16_t function, int arg, const std::uint64_t* values, std::size_t& size) const;
+    static GLint _getInteger(GLenum name);
+};
+
+
+// ÿGLİװIdΪţFnΪgladкָ
+template<int Id, typename Fn>
+struct GLTraceHook;
+
+template<int Id, typename R, typename... Args>
+struct GLTraceHook<Id, R (APIENTRYP)(Args...)>
+{
+    using Function = R (APIENTRYP)(Args...);
+    // ԭĺָ룬ץȡطʱ
+    static Function sReal;
+
+    static GLTraceSignature Describe(const char* name);
+
+    static R APIENTRY Capture(Args... args)
+    {
+        GLCapture& capture = GLCapture::Get();
+        const std::uint64_t values[sizeof...(Args) + 1] = { GLTraceToBits(args)... };
+        capture._writeCall(Id, values);
+        if constexpr (std::is_void<R>::value) {
+            sReal(args...);
+            capture._writeResult(Id, values, nullptr);
+        }
+        else {
+            R result = sReal(args...);
+            capture._writeResult(Id, values, &result);
+            return result;
+        }
+    }
+
+    // ýĲԭطֵԭʼֽ
+    static std::uint64_t Execute(const GLTraceCall& call)
+    {
+        return _execute(call, std::index_sequence_for<Args...>());
+    }
+
+private:
+    template<typename T>
+    static T _getArg(const GLTraceCall& call, std::size_t index)
+    {
+        const GLTraceArg& arg = call.mArgs[index];
+        if constexpr (std::is_pointer<T>::value) {
+            return reinterpret_cast<T>(const_cast<void*>(arg.mPointer));
+        }
+        else {
+            T value;
+            std::memcpy(&value, &arg.mValue, sizeof(T));
+            return value;
+        }
+    }
+
+    template<std::size_t... I>
+    static std::uint64_t _execute(const GLTraceCall& call, std::index_sequence<I...>)
+    {
+        if constexpr (std::is_void<R>::value) {
+            sReal(_getArg<Args>(call, I)...);
+            return 0;
+        }
+        else {
+            return GLTraceToBits(sReal(_getArg<Args>(call, I)...));
+        }
+    }
+};
+
+template<int Id, typename R, typename... Args>
+typename GLTraceHook<Id, R (APIENTRYP)(Args...)>::Function GLTraceHook<Id, R (APIENTRYP)(Args...)>::sReal = nullptr;
+
+template<int Id, typename R, typename... Args>
+GLTraceSignature GLTraceHook<Id, R (APIENTRYP)(Args...)>::Describe(const char* name)
+{
+    static_assert(sizeof...(Args) <= kGLTraceMaxArgs, "too many arguments");
+    GLTraceSignature signature = {};
+    signature.mName = name;
+    signature.mArgCount = sizeof...(Args);
+    const std::uint8_t sizes[sizeof...(Args) + 1] = { static_cast<std::uint8_t>(sizeof(Args))... };
+    const GLTraceArgClass classes[sizeof...(Args) + 1] = { GetGLTraceArgClass<Args>()... };
+    for (std::size_t i = 0; i < sizeof...(Args); i++) {
+        signature.mArgSizes[i] = sizes[i];
+        signature.mArgClasses[i] = classes[i];
+    }
+    if constexpr (!std::is_void<R>::value) {
+        signature.mResultSize = sizeof(R);
+        signature.mResultClass = GetGLTraceArgClass<R>();
+    }
+
+    // ɺõϢ
+    std::string text(name);
+    auto startsWith = [&text](const char* prefix) { return text.compare(0, std::strlen(prefix), prefix) == 0; };
+    signature.mGeneratesNames = startsWith("glGen") && !startsWith("glGenerate") && signature.mArgCount == 2;
+    signature.mDeletesNames = startsWith("glDelete") && signature.mArgCount == 2 && signature.mArgClasses[1] == GLTraceArgClass::input;
+    signature.mIsDraw = (startsWith("glDraw") && !startsWith("glDrawBuffer")) || startsWith("glMultiDraw");
+    if ((startsWith("glUniform") || startsWith("glVertexAttrib")) && text.back() == 'v' && text.find("Pointer") == std::string::npos) {
+        // glUniformMatrix2x3fvglUniform4fvglVertexAttrib4NubvȣԪ־ԪشСͺ׺
+        std::size_t digit = text.find_first_of("1234");
+        if (text.find("AttribP") != std::string::npos) {
+            // glVertexAttribP*uivΪһGLuint
+            signature.mVectorBytes = 4;
+        }
+        else if (digit != std::string::npos) {
+            int count = text[digit] - '0';
+            std::size_t typePos = digit + 1;
+            if (startsWith("glUniformMatrix")) {
+                if (text[typePos] == 'x') {
+                    count *= text[typePos + 1] - '0';
+                    typePos += 2;
+                }
+                else {
+                    count *= count;
+                }
+            }
+            std::string type = text.substr(typePos, text.size() - typePos - 1);
+            if (!type.empty() && type[0] == 'N') {
+                type = type.substr(1);
+            }
+            int typeSize = type == "b" || type == "ub" ? 1 : type == "s" || type == "us" ? 2 : type == "d" ? 8 : 4;
+            signature.mVectorBytes = static_cast<std::uint8_t>(count * typeSize);
+        }
+    }
+    return signature;
+}
+
+
+const GLTraceSignature* GetGLTraceSignatures()
+{
+    static const GLTraceSignature signatures[] = {
+#define GL_TRACE_FUNCTION(name) GLTraceHook<GLTraceId_##name, decltype(glad_##name)>::Describe(#name),
+#include <mylib/gl_trace_functions.h>
+#undef GL_TRACE_FUNCTION
+    };
+    return signatures;
+}
+
+// ݵֽGLȡͻڴķʽһ£ÿаalignment룬һв
+std::size_t GetGLTraceImageSize(GLenum format, GLenum type, std::int64_t width, std::int64_t height, std::int64_t depth, GLint alignment)
+{
+    int components = 4;
+    switch (format)
+    {
+    case GL_RED: case GL_GREEN: case GL_BLUE: case GL_RED_INTEGER: case GL_GREEN_INTEGER: case GL_BLUE_INTEGER:
+    case GL_DEPTH_COMPONENT: case GL_STENCIL_INDEX: case GL_DEPTH_STENCIL:
+        components = 1;
+        break;
+    case GL_RG: case GL_RG_INTEGER:
+        components = 2;
+        break;
+    case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: case GL_BGR_INTEGER:
+        components = 3;
+        break;
+    default:
+        break;
+    }
+
+    std::int64_t pixelSize;
+    switch (type)
+    {
+    case GL_UNSIGNED_BYTE: case GL_BYTE:
+        pixelSize = components;
+        break;
+    case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT:
+        pixelSize = components * 2;
+        break;
+    case GL_UNSIGNED_BYTE_3_3_2: case GL_UNSIGNED_BYTE_2_3_3_REV:
+        pixelSize = 1;
+        break;
+    case GL_UNSIGNED_SHORT_5_6_5: case GL_UNSIGNED_SHORT_5_6_5_REV: case GL_UNSIGNED_SHORT_4_4_4_4:
+    case GL_UNSIGNED_SHORT_4_4_4_4_REV: case GL_UNSIGNED_SHORT_5_5_5_1: case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+        pixelSize = 2;
+        break;
+    case GL_UNSIGNED_INT_8_8_8_8: case GL_UNSIGNED_INT_8_8_8_8_REV: case GL_UNSIGNED_INT_10_10_10_2:
+    case GL_UNSIGNED_INT_2_10_10_10_REV: case GL_UNSIGNED_INT_24_8: case GL_UNSIGNED_INT_10F_11F_11F_REV:
+    case GL_UNSIGNED_INT_5_9_9_9_REV:
+        pixelSize = 4;
+        break;
+    case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+        pixelSize = 8;
+        break;
+    default:
+        pixelSize = components * 4;
+        break;
+    }
+
+    if (width <= 0 || height <= 0 || depth <= 0) {
+        return 0;
+    }
+    std::int64_t row = width * pixelSize;
+    std::int64_t alignedRow = (row + alignment - 1) / alignment * alignment;
+    return static_cast<std::size_t>(alignedRow * (height * depth - 1) + row);
+}
+
+
+bool GLCapture::Start(const std::string& path)
+{
+    if (mCapturing) {
+        return false;
+    }
+    mFile.open(path, std::ios::binary);
+    if (!mFile) {
+        std::cout << "Failed to open capture file: " << path << std::endl;
+        return false;
+    }
+
+    // ļͷ
+    mBuffer.clear();
+    mBytesWritten = 0;
+    mFrames = 0;
+    _put(kGLTraceMagic);
+    _put(kGLTraceVersion);
+    _put(static_cast<std::uint32_t>(GLTraceId_count));
+    const GLTraceSignature* signatures = GetGLTraceSignatures();
+    for (int i = 0; i < GLTraceId_count; i++) {
+        std::uint8_t length = static_cast<std::uint8_t>(std::strlen(signatures[i].mName));
+        _put(length);
+        _put(signatures[i].mName, length);
+    }
+
+    _install(true);
+    mCapturing = true;
+    return true;
+}
+
+void GLCapture::Stop()
+{
+    if (!mCapturing) {
+        return;
+    }
+    _install(false);
+    mCapturing = false;
+    _flush();
+    mFile.close();
+}
+
+void GLCapture::EndFrame()
+{
+    if (mCapturing) {
+        _put(kGLTraceFrameEnd);
+        mFrames++;
+        if (mBuffer.size() >= kFlushSize) {
+            _flush();
+        }
+    }
+}
+
+void GLCapture::_install(bool install)
+{
+    // ûмصĺΪ
+#define GL_TRACE_FUNCTION(name) \
+    if (install && glad_##name) { GLTraceHook<GLTraceId_##name, decltype(glad_##name)>::sReal = glad_##name; glad_##name = &GLTraceHook<GLTraceId_##name, decltype(glad_##name)>::Capture; } \
+    else if (!install && GLTraceHook<GLTraceId_##name, decltype(glad_##name)>::sReal) { glad_##name = GLTraceHook<GLTraceId_##name, decltype(glad_##name)>::sReal; }
+#include <mylib/gl_trace_functions.h>
+#undef GL_TRACE_FUNCTION
+}
+
+void GLCapture::_flush()
+{
+    mFile.write(reinterpret_cast<const char*>(mBuffer.data()), mBuffer.size());
+    mBytesWritten += mBuffer.size();
+    mBuffer.clear();
+}
+
+GLint GLCapture::_getInteger(GLenum name)
+{
+    GLint value = 0;
+    GL_TRACE_HOOK(glGetIntegerv)::sReal(name, &value);
+    return value;
+}
+
+void GLCapture::_writeCall(std::uint16_t function, const std::uint64_t* values)
+{
+    const GLTraceSignature& signature = GetGLTraceSignatures()[function];
+    _put(function);
+    for (int i = 0; i < signature.mArgCount; i++) {
+        const void* pointer = reinterpret_cast<const void*>(static_cast<std::uintptr_t>(values[i]));
+        switch (signature.mArgClasses[i])
+        {
+        case GLTraceArgClass::scalar:
+            _put(&values[i], signature.mArgSizes[i]);
+            break;
+        case GLTraceArgClass::handle:
+            _put(values[i]);
+            break;
+        case GLTraceArgClass::string:
+            if (pointer) {
+                _putPayload(pointer, std::strlen(static_cast<const char*>(pointer)) + 1);
+            }
+            else {
+                _put(GLTracePointer::value);
+                _put(values[i]);
+            }
+            break;
+        case GLTraceArgClass::stringArray: {
+            // glShaderSourceĵ4Ϊÿַĳȣַ0β
+            // Ϊַÿַ4ֽڳȼݣ0β
+            const char* const* strings = static_cast<const char* const*>(pointer);
+            const GLint* lengths = function == GLTraceId_glShaderSource ? reinterpret_cast<const GLint*>(static_cast<std::uintptr_t>(values[3])) : nullptr;
+            std::uint32_t count = static_cast<std::uint32_t>(values[1]);
+            std::vector<std::uint8_t> payload;
+            payload.insert(payload.end(), reinterpret_cast<const std::uint8_t*>(&count), reinterpret_cast<const std::uint8_t*>(&count) + 4);
+            for (std::uint32_t s = 0; s < count; s++) {
+                std::uint32_t length = static_cast<std::uint32_t>(lengths && lengths[s] >= 0 ? lengths[s] : std::strlen(strings[s]));
+                std::uint32_t stored = length + 1;
+                payload.insert(payload.end(), reinterpret_cast<const std::uint8_t*>(&stored), reinterpret_cast<const std::uint8_t*>(&stored) + 4);
+                payload.insert(payload.end(), strings[s], strings[s] + length);
+                payload.push_back(0);
+            }
+            _putPayload(payload.data(), payload.size());
+            break;
+        }
+        case GLTraceArgClass::input: {
+            if (function == GLTraceId_glShaderSource) {
+                // ַѾַдطʱַ0β
+                _put(GLTracePointer::value);
+                _put(std::uint64_t(0));
+                break;
+            }
+            std::size_t size = 0;
+            GLTracePointer mode = pointer ? _getInputSize(function, values, size) : GLTracePointer::value;
+            if (mode == GLTracePointer::payload) {
+                _putPayload(pointer, size);
+            }
+            else {
+                _put(mode);
+                if (mode == GLTracePointer::value) {
+                    _put(values[i]);
+                }
+            }
+            break;
+        }
+        case GLTraceArgClass::output: {
+            std::size_t size = 0;
+            GLTracePointer mode = pointer ? _getOutputSize(function, i, values, size) : GLTracePointer::value;
+            _put(mode);
+            if (mode == GLTracePointer::value) {
+                _put(values[i]);
+            }
+            else {
+                _put(static_cast<std::uint32_t>(size));
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+void GLCapture::_writeResult(std::uint16_t function, const std::uint64_t* values, const void* result)
+{
+    const GLTraceSignature& signature = GetGLTraceSignatures()[function];
+    if (result) {
+        _put(result, signature.mResultSize);
+    }
+    if (signature.mGeneratesNames) {
+        std::uint32_t size = static_cast<std::uint32_t>(values[0]) * 4;
+        _put(size);
+        _put(reinterpret_cast<const void*>(static_cast<std::uintptr_t>(values[1])), size);
+    }
+}
+
+GLTracePointer GLCapture::_getInputSize(std::uint16_t function, const std::uint64_t* values, std::size_t& size) const
+{
+    const GLTraceSignature& signature = GetGLTraceSignatures()[function];
+    auto imageSize = [&values](int width, int height, int depth, int format, int type) {
+        return GetGLTraceImageSize(static_cast<GLenum>(values[format]), static_cast<GLenum>(values[type]),
+            width >= 0 ? static_cast<GLsizei>(values[width]) : 1, height >= 0 ? static_cast<GLsizei>(values[height]) : 1,
+            depth >= 0 ? static_cast<GLsizei>(values[depth]) : 1, _getInteger(GL_UNPACK_ALIGNMENT));
+    };
+    // ػʱݵָǻеƫ
+    bool unpackBuffer = false;
+    switch (function)
+    {
+    case GLTraceId_glTexImage1D: case GLTraceId_glTexImage2D: case GLTraceId_glTexImage3D:
+    case GLTraceId_glTexSubImage1D: case GLTraceId_glTexSubImage2D: case GLTraceId_glTexSubImage3D:
+    case GLTraceId_glCompressedTexImage1D: case GLTraceId_glCompressedTexImage2D: case GLTraceId_glCompressedTexImage3D:
+    case GLTraceId_glCompressedTexSubImage1D: case GLTraceId_glCompressedTexSubImage2D: case GLTraceId_glCompressedTexSubImage3D:
+        unpackBuffer = _getInteger(GL_PIXEL_UNPACK_BUFFER_BINDING) != 0;
+        break;
+    default:
+        break;
+    }
+    if (unpackBuffer) {
+        return GLTracePointer::value;
+    }
+
+    switch (function)
+    {
+    case GLTraceId_glBufferData:
+        size = static_cast<std::size_t>(values[1]);
+        return GLTracePointer::payload;
+    case GLTraceId_glBufferSubData:
+        size = static_cast<std::size_t>(values[2]);
+        return GLTracePointer::payload;
+    case GLTraceId_glTexImage1D:
+        size = imageSize(3, -1, -1, 5, 6);
+        return GLTracePointer::payload;
+    case GLTraceId_glTexImage2D:
+        size = imageSize(3, 4, -1, 6, 7);
+        return GLTracePointer::payload;
+    case GLTraceId_glTexImage3D:
+        size = imageSize(3, 4, 5, 7, 8);
+        return GLTracePointer::payload;
+    case GLTraceId_glTexSubImage1D:
+        size = imageSize(3, -1, -1, 4, 5);
+        return GLTracePointer::payload;
+    case GLTraceId_glTexSubImage2D:
+        size = imageSize(4, 5, -1, 6, 7);
+        return GLTracePointer::payload;
+    case GLTraceId_glTexSubImage3D:
+        size = imageSize(5, 6, 7, 8, 9);
+        return GLTracePointer::payload;
+    case GLTraceId_glCompressedTexImage1D: case GLTraceId_glCompressedTexImage2D: case GLTraceId_glCompressedTexImage3D:
+    case GLTraceId_glCompressedTexSubImage1D: case GLTraceId_glCompressedTexSubImage2D: case GLTraceId_glCompressedTexSubImage3D:
+        // һΪݣڶΪݴС
+        size = static_cast<std::size_t>(values[signature.mArgCount - 2]);
+        return GLTracePointer::payload;
+    // Щָǵǰеƫ
+    case GLTraceId_glVertexAttribPointer: case GLTraceId_glVertexAttribIPointer:
+    case GLTraceId_glDrawElements: case GLTraceId_glDrawElementsInstanced: case GLTraceId_glDrawRangeElements:
+    case GLTraceId_glDrawElementsBaseVertex: case GLTraceId_glDrawRangeElementsBaseVertex: case GLTraceId_glDrawElementsInstancedBaseVertex:
+        return GLTracePointer::value;
+    case GLTraceId_glClearBufferiv: case GLTraceId_glClearBufferuiv: case GLTraceId_glClearBufferfv:
+        size = values[0] == GL_COLOR ? 16 : 4;
+        return GLTracePointer::payload;
+    case GLTraceId_glTexParameterfv: case GLTraceId_glTexParameteriv: case GLTraceId_glTexParameterIiv: case GLTraceId_glTexParameterIuiv:
+    case GLTraceId_glSamplerParameterfv: case GLTraceId_glSamplerParameteriv: case GLTraceId_glSamplerParameterIiv: case GLTraceId_glSamplerParameterIuiv:
+        size = values[1] == GL_TEXTURE_BORDER_COLOR ? 16 : 4;
+        return GLTracePointer::payload;
+    case GLTraceId_glMultiDrawArrays:
+        size = static_cast<std::size_t>(values[3]) * 4;
+        return GLTracePointer::payload;
+    case GLTraceId_glGetActiveUniformsiv:
+        size = static_cast<std::size_t>(values[1]) * 4;
+        return GLTracePointer::payload;
+    case GLTraceId_glDrawBuffers:
+        size = static_cast<std::size_t>(values[0]) * 4;
+        return GLTracePointer::payload;
+    default:
+        break;
+    }
+
+    if (signature.mDeletesNames) {
+        size = static_cast<std::size_t>(values[0]) * 4;
+        return GLTracePointer::payload;
+    }
+    if (signature.mVectorBytes > 0) {
+        // glUniform*vĵڶΪ鳤ȣglVertexAttrib*vֻһԪ
+        bool uniform = std::strncmp(signature.mName, "glUniform", 9) == 0;
+        size = signature.mVectorBytes * (uniform ? static_cast<std::size_t>(values[1]) : 1);
+        return GLTracePointer::payload;
+    }
+    return GLTracePointer::unsupported;
+}
+
+GLTracePointer GLCapture::_getOutputSize(std::uint16_t function, int arg, const std::uint64_t* values, std::size_t& size) const
+{
+    switch (function)
+    {
+    case GLTraceId_glReadPixels:
+        // GL_PIXEL_PACK_BUFFERʱΪеƫ
+        if (_getInteger(GL_PIXEL_PACK_BUFFER_BINDING) != 0) {
+            return GLTracePointer::value;
+        }
+        size = GetGLTraceImageSize(static_cast<GLenum>(values[4]), static_cast<GLenum>(values[5]),
+            static_cast<GLsizei>(values[2]), static_cast<GLsizei>(values[3]), 1, _getInteger(GL_PACK_ALIGNMENT));
+        break;
+    case GLTraceId_glGetTexImage: {
+        if (_getInteger(GL_PIXEL_PACK_BUFFER_BINDING) != 0) {
+            return GLTracePointer::value;
+        }
+        GLenum target = static_cast<GLenum>(values[0]);
+        GLint level = static_cast<GLint>(values[1]);
+        GLint width = 0, height = 0, depth = 0;
+        GL_TRACE_HOOK(glGetTexLevelParameteriv)::sReal(target, level, GL_TEXTURE_WIDTH, &width);
+        GL_TRACE_HOOK(glGetTexLevelParameteriv)::sReal(target, level, GL_TEXTURE_HEIGHT, &height);
+        GL_TRACE_HOOK(glGetTexLevelParameteriv)::sReal(target, level, GL_TEXTURE_DEPTH, &depth);
+        size = GetGLTraceImageSize(static_cast<GLenum>(values[2]), static_cast<GLenum>(values[3]), width, height, depth, _getInteger(GL_PACK_ALIGNMENT));
+        break;
+    }
+    case GLTraceId_glGetBufferSubData:
+        size = static_cast<std::size_t>(values[2]);
+        break;
+    case GLTraceId_glGetShaderInfoLog: case GLTraceId_glGetProgramInfoLog: case GLTraceId_glGetShaderSource:
+        size = arg == 3 ? static_cast<std::size_t>(values[1]) : 0;
+        break;
+    case GLTraceId_glGetActiveUniform: case GLTraceId_glGetActiveAttrib: case GLTraceId_glGetTransformFeedbackVarying:
+        size = arg == 6 ? static_cast<std::size_t>(values[2]) : 0;
+        break;
+    case GLTraceId_glGetActiveUniformName: case GLTraceId_glGetActiveUniformBlockName:
+        size = arg == 4 ? static_cast<std::size_t>(values[2]) : 0;
+        break;
+    case GLTraceId_glGetAttachedShaders:
+        size = arg == 3 ? static_cast<std::size_t>(values[1]) * 4 : 0;
+        break;
+    default:
+        if (GetGLTraceSignatures()[function].mGeneratesNames) {
+            size = static_cast<std::size_t>(values[0]) * 4;
+        }
+        break;
+    }
+    return GLTracePointer::output;
+}
+
+
+// ȡtraceļļڴ
+class GLTraceReader
+{
+public:
+    bool Open(const std::string& path);
+    // ȡһãʱfalseʱGetErrorΪ
+    bool Next(GLTraceCall& call);
+    const std::string& GetError() const { return mError; }
+    std::size_t GetSize() const { return mData.size(); }
+
+private:
+    // ûм¼СʹõĻС
+    static constexpr std::uint32_t kDefaultOutputSize = 4096;
+
+    std::vector<std::uint8_t> mData;
+    std::size_t mOffset = 0;
+    std::vector<int> mFunctionMap;  // traceеıŵеıţ-1Ϊûеĺ
+    std::vector<std::string> mTraceNames;
+    std::vector<std::uint8_t> mScratch;
+    std::string mError;
+    bool mTruncated = false;
+
+    bool _read(void* data, std::size_t size);
+    template<typename T>
+    bool _read(T& value) { return _read(&value, sizeof(T)); }
+    const std::uint8_t* _skip(std::size_t size);
+};
+
+bool GLTraceReader::Open(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        mError = "Failed to open " + path;
+        return false;
+    }
+    mData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    mOffset = 0;
+
+    std::uint32_t magic = 0, version = 0, count = 0;
+    if (!_read(magic) || magic != kGLTraceMagic || !_read(version) || version != kGLTraceVersion || !_read(count)) {
+        mError = "Not a GL trace or unsupported version: " + path;
+        return false;
+    }
+
+    std::map<std::string, int> localIds;
+    const GLTraceSignature* signatures = GetGLTraceSignatures();
+    for (int i = 0; i < GLTraceId_count; i++) {
+        localIds[signatures[i].mName] = i;
+    }
+    mFunctionMap.assign(count, -1);
+    mTraceNames.resize(count);
+    for (std::uint32_t i = 0; i < count; i++) {
+        std::uint8_t length = 0;
+        const std::uint8_t* name = nullptr;
+        if (!_read(length) || !(name = _skip(length))) {
+            mError = "Truncated trace header";
+            return false;
+        }
+        mTraceNames[i].assign(reinterpret_cast<const char*>(name), length);
+        auto found = localIds.find(mTraceNames[i]);
+        if (found != localIds.end()) {
+            mFunctionMap[i] = found->second;
+        }
+    }
+    return true;
+}
+
+bool GLTraceReader::_read(void* data, std::size_t size)
+{
+    const std::uint8_t* bytes = _skip(size);
+    if (!bytes) {
+        return false;
+    }
+    std::memcpy(data, bytes, size);
+    return true;
+}
+
+const std::uint8_t* GLTraceReader::_skip(std::size_t size)
+{
+    if (mOffset + size > mData.size()) {
+        mTruncated = true;
+        return nullptr;
+    }
+    const std::uint8_t* bytes = mData.data() + mOffset;
+    mOffset += size;
+    return bytes;
+}
+
+bool GLTraceReader::Next(GLTraceCall& call)
+{
+    std::uint16_t traceId = 0;
+    if (mOffset == mData.size() || !_read(traceId)) {
+        return false;
+    }
+    if (traceId == kGLTraceFrameEnd) {
+        call.mFunction = kGLTraceFrameEnd;
+        return true;
+    }
+    if (traceId >= mFunctionMap.size() || mFunctionMap[traceId] < 0) {
+        // ֪;޷
+        mError = "Unknown function in trace: " + (traceId < mTraceNames.size() ? mTraceNames[traceId] : std::to_string(traceId));
+        return false;
+    }
+
+    call.mFunction = static_cast<std::uint16_t>(mFunctionMap[traceId]);
+    call.mResult = 0;
+    call.mNames = nullptr;
+    call.mNamesSize = 0;
+    call.mPayloadBytes = 0;
+    call.mSupported = true;
+    call.mStrings.clear();
+
+    // ȼʱеƫƣȫָ룬ʱݺָʧЧ
+    const GLTraceSignature& signature = GetGLTraceSignatures()[call.mFunction];
+    std::size_t outputOffsets[kGLTraceMaxArgs];
+    std::size_t scratchSize = 0;
+    for (int i = 0; i < signature.mArgCount; i++) {
+        GLTraceArg& arg = call.mArgs[i];
+        arg.mValue = 0;
+        arg.mPointer = nullptr;
+        arg.mSize = 0;
+        arg.mMode = GLTracePointer::value;
+        if (signature.mArgClasses[i] == GLTraceArgClass::scalar) {
+            _read(&arg.mValue, signature.mArgSizes[i]);
+            continue;
+        }
+        if (signature.mArgClasses[i] == GLTraceArgClass::handle) {
+            _read(arg.mValue);
+            arg.mPointer = reinterpret_cast<const void*>(static_cast<std::uintptr_t>(arg.mValue));
+            continue;
+        }
+
+        _read(arg.mMode);
+        switch (arg.mMode)
+        {
+        case GLTracePointer::value:
+            _read(arg.mValue);
+            arg.mPointer = reinterpret_cast<const void*>(static_cast<std::uintptr_t>(arg.mValue));
+            break;
+        case GLTracePointer::payload: {
+            _read(arg.mSize);
+            arg.mPointer = _skip(arg.mSize);
+            call.mPayloadBytes += arg.mSize;
+            if (signature.mArgClasses[i] == GLTraceArgClass::stringArray && arg.mPointer) {
+                // ԭΪַָ
+                const std::uint8_t* bytes = static_cast<const std::uint8_t*>(arg.mPointer);
+                std::uint32_t count = 0;
+                std::memcpy(&count, bytes, 4);
+                std::size_t offset = 4;
+                for (std::uint32_t s = 0; s < count && offset + 4 <= arg.mSize; s++) {
+                    std::uint32_t length = 0;
+                    std::memcpy(&length, bytes + offset, 4);
+                    call.mStrings.push_back(reinterpret_cast<const char*>(bytes + offset + 4));
+                    offset += 4 + length;
+                }
+                arg.mPointer = call.mStrings.data();
+            }
+            break;
+        }
+        case GLTracePointer::output:
+            _read(arg.mSize);
+            outputOffsets[i] = scratchSize;
+            scratchSize += std::max(arg.mSize, kDefaultOutputSize);
+            break;
+        default:
+            call.mSupported = false;
+            break;
+        }
+    }
+    if (signature.mResultSize > 0) {
+        _read(&call.mResult, signature.mResultSize);
+    }
+    if (signature.mGeneratesNames) {
+        _read(call.mNamesSize);
+        call.mNames = _skip(call.mNamesSize);
+    }
+    if (mTruncated) {
+        mError = "Truncated trace";
+        return false;
+    }
+
+    if (mScratch.size() < scratchSize) {
+        mScratch.resize(scratchSize);
+    }
+    for (int i = 0; i < signature.mArgCount; i++) {
+        if (signature.mArgClasses[i] != GLTraceArgClass::scalar && signature.mArgClasses[i] != GLTraceArgClass::handle
+            && call.mArgs[i].mMode == GLTracePointer::output) {
+            call.mArgs[i].mPointer = mScratch.data() + outputOffsets[i];
+        }
+    }
+    return true;
+}
+
+
+// ڵǰGLִtraceеĵ
+class GLTraceReplayer
+{
+public:
+    // ҪѾgladLoadGL
+    GLTraceReplayer();
+
+    // ִһãֵ֧ĵ
+    void Execute(GLTraceCall& call);
+
+    std::uint64_t GetSkippedCount() const { return mSkipped; }
+    // ɵ֡uniformλõץȡʱһµĴ
+    std::uint64_t GetMismatchCount() const { return mMismatches; }
+
+private:
+    using ExecuteFunction = std::uint64_t(*)(const GLTraceCall&);
+    std::vector<ExecuteFunction> mFunctions;
+    std::vector<bool> mCompareResults;
+    std::map<std::uint64_t, std::uint64_t> mSyncs;  // ץȡʱGLsyncطʱGLsync
+    std::uint64_t mSkipped = 0;
+    std::uint64_t mMismatches = 0;
+};
+
+GLTraceReplayer::GLTraceReplayer()
+{
+    mFunctions.assign(GLTraceId_count, nullptr);
+#define GL_TRACE_FUNCTION(name) \
+    if (glad_##name) { GLTraceHook<GLTraceId_##name, decltype(glad_##name)>::sReal = glad_##name; mFunctions[GLTraceId_##name] = &GLTraceHook<GLTraceId_##name, decltype(glad_##name)>::Execute; }
+#include <mylib/gl_trace_functions.h>
+#undef GL_TRACE_FUNCTION
+
+    // ЩķֵͬһӦץȡʱͬ
+    const GLTraceSignature* signatures = GetGLTraceSignatures();
+    mCompareResults.assign(GLTraceId_count, false);
+    for (int i = 0; i < GLTraceId_count; i++) {
+        std::string name = signatures[i].mName;
+        mCompareResults[i] = name.compare(0, 8, "glCreate") == 0
+            || (name.compare(0, 5, "glGet") == 0 && (name.find("Location") != std::string::npos || name.find("Index") != std::string::npos));
+    }
+}
+
+void GLTraceReplayer::Execute(GLTraceCall& call)
+{
+    if (call.mFunction == kGLTraceFrameEnd) {
+        return;
+    }
+    if (!call.mSupported || !mFunctions[call.mFunction]) {
+        mSkipped++;
+        return;
+    }
+
+    const GLTraceSignature& signature = GetGLTraceSignatures()[call.mFunction];
+    for (int i = 0; i < signature.mArgCount; i++) {
+        if (signature.mArgClasses[i] == GLTraceArgClass::handle) {
+            auto found = mSyncs.find(call.mArgs[i].mValue);
+            call.mArgs[i].mPointer = found != mSyncs.end() ? reinterpret_cast<const void*>(static_cast<std::uintptr_t>(found->second)) : nullptr;
+        }
+    }
+
+    std::uint64_t result = mFunctions[call.mFunction](call);
+
+    if (signature.mResultClass == GLTraceArgClass::handle && signature.mResultSize > 0) {
+        mSyncs[call.mResult] = result;
+    }
+    else if (mCompareResults[call.mFunction] && result != call.mResult) {
+        mMismatches++;
+    }
+    if (call.mNames && std::memcmp(call.mNames, call.mArgs[1].mPointer, call.mNamesSize) != 0) {
+        mMismatches++;
+    }
+}
@@ -0,0 +1,378 @@
+// ץ֡ʱװGLglad.cмصĺбͬgl=3.3 coregladҪͬ
+// ʹǰGL_TRACE_FUNCTION(name)ÿչһΣ˳򼴺ţtraceļбֱ˳仯Ӱȡļ
+// ûincludeԶΰ
+
+GL_TRACE_FUNCTION(glCullFace)
+GL_TRACE_FUNCTION(glFrontFace)
+GL_TRACE_FUNCTION(glHint)
+GL_TRACE_FUNCTION(glLineWidth)
+GL_TRACE_FUNCTION(glPointSize)
+GL_TRACE_FUNCTION(glPolygonMode)
+GL_TRACE_FUNCTION(glScissor)
+GL_TRACE_FUNCTION(glTexParameterf)
+GL_TRACE_FUNCTION(glTexParameterfv)
+GL_TRACE_FUNCTION(glTexParameteri)
+GL_TRACE_FUNCTION(glTexParameteriv)
+GL_TRACE_FUNCTION(glTexImage1D)
+GL_TRACE_FUNCTION(glTexImage2D)
+GL_TRACE_FUNCTION(glDrawBuffer)
+GL_TRACE_FUNCTION(glClear)
+GL_TRACE_FUNCTION(glClearColor)
+GL_TRACE_FUNCTION(glClearStencil)
+GL_TRACE_FUNCTION(glClearDepth)
+GL_TRACE_FUNCTION(glStencilMask)
+GL_TRACE_FUNCTION(glColorMask)
+GL_TRACE_FUNCTION(glDepthMask)
+GL_TRACE_FUNCTION(glDisable)
+GL_TRACE_FUNCTION(glEnable)
+GL_TRACE_FUNCTION(glFinish)
+GL_TRACE_FUNCTION(glFlush)
+GL_TRACE_FUNCTION(glBlendFunc)
+GL_TRACE_FUNCTION(glLogicOp)
+GL_TRACE_FUNCTION(glStencilFunc)
+GL_TRACE_FUNCTION(glStencilOp)
+GL_TRACE_FUNCTION(glDepthFunc)
+GL_TRACE_FUNCTION(glPixelStoref)
+GL_TRACE_FUNCTION(glPixelStorei)
+GL_TRACE_FUNCTION(glReadBuffer)
+GL_TRACE_FUNCTION(glReadPixels)
+GL_TRACE_FUNCTION(glGetBooleanv)
+GL_TRACE_FUNCTION(glGetDoublev)
+GL_TRACE_FUNCTION(glGetError)
+GL_TRACE_FUNCTION(glGetFloatv)
+GL_TRACE_FUNCTION(glGetIntegerv)
+GL_TRACE_FUNCTION(glGetString)
+GL_TRACE_FUNCTION(glGetTexImage)
+GL_TRACE_FUNCTION(glGetTexParameterfv)
+GL_TRACE_FUNCTION(glGetTexParameteriv)
+GL_TRACE_FUNCTION(glGetTexLevelParameterfv)
+GL_TRACE_FUNCTION(glGetTexLevelParameteriv)
+GL_TRACE_FUNCTION(glIsEnabled)
+GL_TRACE_FUNCTION(glDepthRange)
+GL_TRACE_FUNCTION(glViewport)
+GL_TRACE_FUNCTION(glDrawArrays)
+GL_TRACE_FUNCTION(glDrawElements)
+GL_TRACE_FUNCTION(glPolygonOffset)
+GL_TRACE_FUNCTION(glCopyTexImage1D)
+GL_TRACE_FUNCTION(glCopyTexImage2D)
+GL_TRACE_FUNCTION(glCopyTexSubImage1D)
+GL_TRACE_FUNCTION(glCopyTexSubImage2D)
+GL_TRACE_FUNCTION(glTexSubImage1D)
+GL_TRACE_FUNCTION(glTexSubImage2D)
+GL_TRACE_FUNCTION(glBindTexture)
+GL_TRACE_FUNCTION(glDeleteTextures)
+GL_TRACE_FUNCTION(glGenTextures)
+GL_TRACE_FUNCTION(glIsTexture)
+GL_TRACE_FUNCTION(glDrawRangeElements)
+GL_TRACE_FUNCTION(glTexImage3D)
+GL_TRACE_FUNCTION(glTexSubImage3D)
+GL_TRACE_FUNCTION(glCopyTexSubImage3D)
+GL_TRACE_FUNCTION(glActiveTexture)
+GL_TRACE_FUNCTION(glSampleCoverage)
+GL_TRACE_FUNCTION(glCompressedTexImage3D)
+GL_TRACE_FUNCTION(glCompressedTexImage2D)
+GL_TRACE_FUNCTION(glCompressedTexImage1D)
+GL_TRACE_FUNCTION(glCompressedTexSubImage3D)
+GL_TRACE_FUNCTION(glCompressedTexSubImage2D)
+GL_TRACE_FUNCTION(glCompressedTexSubImage1D)
+GL_TRACE_FUNCTION(glGetCompressedTexImage)
+GL_TRACE_FUNCTION(glBlendFuncSeparate)
+GL_TRACE_FUNCTION(glMultiDrawArrays)
+GL_TRACE_FUNCTION(glMultiDrawElements)
+GL_TRACE_FUNCTION(glPointParameterf)
+GL_TRACE_FUNCTION(glPointParameterfv)
+GL_TRACE_FUNCTION(glPointParameteri)
+GL_TRACE_FUNCTION(glPointParameteriv)
+GL_TRACE_FUNCTION(glBlendColor)
+GL_TRACE_FUNCTION(glBlendEquation)
+GL_TRACE_FUNCTION(glGenQueries)
+GL_TRACE_FUNCTION(glDeleteQueries)
+GL_TRACE_FUNCTION(glIsQuery)
+GL_TRACE_FUNCTION(glBeginQuery)
+GL_TRACE_FUNCTION(glEndQuery)
+GL_TRACE_FUNCTION(glGetQueryiv)
+GL_TRACE_FUNCTION(glGetQueryObjectiv)
+GL_TRACE_FUNCTION(glGetQueryObjectuiv)
+GL_TRACE_FUNCTION(glBindBuffer)
+GL_TRACE_FUNCTION(glDeleteBuffers)
+GL_TRACE_FUNCTION(glGenBuffers)
+GL_TRACE_FUNCTION(glIsBuffer)
+GL_TRACE_FUNCTION(glBufferData)
+GL_TRACE_FUNCTION(glBufferSubData)
+GL_TRACE_FUNCTION(glGetBufferSubData)
+GL_TRACE_FUNCTION(glMapBuffer)
+GL_TRACE_FUNCTION(glUnmapBuffer)
+GL_TRACE_FUNCTION(glGetBufferParameteriv)
+GL_TRACE_FUNCTION(glGetBufferPointerv)
+GL_TRACE_FUNCTION(glBlendEquationSeparate)
+GL_TRACE_FUNCTION(glDrawBuffers)
+GL_TRACE_FUNCTION(glStencilOpSeparate)
+GL_TRACE_FUNCTION(glStencilFuncSeparate)
+GL_TRACE_FUNCTION(glStencilMaskSeparate)
+GL_TRACE_FUNCTION(glAttachShader)
+GL_TRACE_FUNCTION(glBindAttribLocation)
+GL_TRACE_FUNCTION(glCompileShader)
+GL_TRACE_FUNCTION(glCreateProgram)
+GL_TRACE_FUNCTION(glCreateShader)
+GL_TRACE_FUNCTION(glDeleteProgram)
+GL_TRACE_FUNCTION(glDeleteShader)
+GL_TRACE_FUNCTION(glDetachShader)
+GL_TRACE_FUNCTION(glDisableVertexAttribArray)
+GL_TRACE_FUNCTION(glEnableVertexAttribArray)
+GL_TRACE_FUNCTION(glGetActiveAttrib)
+GL_TRACE_FUNCTION(glGetActiveUniform)
+GL_TRACE_FUNCTION(glGetAttachedShaders)
+GL_TRACE_FUNCTION(glGetAttribLocation)
+GL_TRACE_FUNCTION(glGetProgramiv)
+GL_TRACE_FUNCTION(glGetProgramInfoLog)
+GL_TRACE_FUNCTION(glGetShaderiv)
+GL_TRACE_FUNCTION(glGetShaderInfoLog)
+GL_TRACE_FUNCTION(glGetShaderSource)
+GL_TRACE_FUNCTION(glGetUniformLocation)
+GL_TRACE_FUNCTION(glGetUniformfv)
+GL_TRACE_FUNCTION(glGetUniformiv)
+GL_TRACE_FUNCTION(glGetVertexAttribdv)
+GL_TRACE_FUNCTION(glGetVertexAttribfv)
+GL_TRACE_FUNCTION(glGetVertexAttribiv)
+GL_TRACE_FUNCTION(glGetVertexAttribPointerv)
+GL_TRACE_FUNCTION(glIsProgram)
+GL_TRACE_FUNCTION(glIsShader)
+GL_TRACE_FUNCTION(glLinkProgram)
+GL_TRACE_FUNCTION(glShaderSource)
+GL_TRACE_FUNCTION(glUseProgram)
+GL_TRACE_FUNCTION(glUniform1f)
+GL_TRACE_FUNCTION(glUniform2f)
+GL_TRACE_FUNCTION(glUniform3f)
+GL_TRACE_FUNCTION(glUniform4f)
+GL_TRACE_FUNCTION(glUniform1i)
+GL_TRACE_FUNCTION(glUniform2i)
+GL_TRACE_FUNCTION(glUniform3i)
+GL_TRACE_FUNCTION(glUniform4i)
+GL_TRACE_FUNCTION(glUniform1fv)
+GL_TRACE_FUNCTION(glUniform2fv)
+GL_TRACE_FUNCTION(glUniform3fv)
+GL_TRACE_FUNCTION(glUniform4fv)
+GL_TRACE_FUNCTION(glUniform1iv)
+GL_TRACE_FUNCTION(glUniform2iv)
+GL_TRACE_FUNCTION(glUniform3iv)
+GL_TRACE_FUNCTION(glUniform4iv)
+GL_TRACE_FUNCTION(glUniformMatrix2fv)
+GL_TRACE_FUNCTION(glUniformMatrix3fv)
+GL_TRACE_FUNCTION(glUniformMatrix4fv)
+GL_TRACE_FUNCTION(glValidateProgram)
+GL_TRACE_FUNCTION(glVertexAttrib1d)
+GL_TRACE_FUNCTION(glVertexAttrib1dv)
+GL_TRACE_FUNCTION(glVertexAttrib1f)
+GL_TRACE_FUNCTION(glVertexAttrib1fv)
+GL_TRACE_FUNCTION(glVertexAttrib1s)
+GL_TRACE_FUNCTION(glVertexAttrib1sv)
+GL_TRACE_FUNCTION(glVertexAttrib2d)
+GL_TRACE_FUNCTION(glVertexAttrib2dv)
+GL_TRACE_FUNCTION(glVertexAttrib2f)
+GL_TRACE_FUNCTION(glVertexAttrib2fv)
+GL_TRACE_FUNCTION(glVertexAttrib2s)
+GL_TRACE_FUNCTION(glVertexAttrib2sv)
+GL_TRACE_FUNCTION(glVertexAttrib3d)
+GL_TRACE_FUNCTION(glVertexAttrib3dv)
+GL_TRACE_FUNCTION(glVertexAttrib3f)
+GL_TRACE_FUNCTION(glVertexAttrib3fv)
+GL_TRACE_FUNCTION(glVertexAttrib3s)
+GL_TRACE_FUNCTION(glVertexAttrib3sv)
+GL_TRACE_FUNCTION(glVertexAttrib4Nbv)
+GL_TRACE_FUNCTION(glVertexAttrib4Niv)
+GL_TRACE_FUNCTION(glVertexAttrib4Nsv)
+GL_TRACE_FUNCTION(glVertexAttrib4Nub)
+GL_TRACE_FUNCTION(glVertexAttrib4Nubv)
+GL_TRACE_FUNCTION(glVertexAttrib4Nuiv)
+GL_TRACE_FUNCTION(glVertexAttrib4Nusv)
+GL_TRACE_FUNCTION(glVertexAttrib4bv)
+GL_TRACE_FUNCTION(glVertexAttrib4d)
+GL_TRACE_FUNCTION(glVertexAttrib4dv)
+GL_TRACE_FUNCTION(glVertexAttrib4f)
+GL_TRACE_FUNCTION(glVertexAttrib4fv)
+GL_TRACE_FUNCTION(glVertexAttrib4iv)
+GL_TRACE_FUNCTION(glVertexAttrib4s)
+GL_TRACE_FUNCTION(glVertexAttrib4sv)
+GL_TRACE_FUNCTION(glVertexAttrib4ubv)
+GL_TRACE_FUNCTION(glVertexAttrib4uiv)
+GL_TRACE_FUNCTION(glVertexAttrib4usv)
+GL_TRACE_FUNCTION(glVertexAttribPointer)
+GL_TRACE_FUNCTION(glUniformMatrix2x3fv)
+GL_TRACE_FUNCTION(glUniformMatrix3x2fv)
+GL_TRACE_FUNCTION(glUniformMatrix2x4fv)
+GL_TRACE_FUNCTION(glUniformMatrix4x2fv)
+GL_TRACE_FUNCTION(glUniformMatrix3x4fv)
+GL_TRACE_FUNCTION(glUniformMatrix4x3fv)
+GL_TRACE_FUNCTION(glColorMaski)
+GL_TRACE_FUNCTION(glGetBooleani_v)
+GL_TRACE_FUNCTION(glGetIntegeri_v)
+GL_TRACE_FUNCTION(glEnablei)
+GL_TRACE_FUNCTION(glDisablei)
+GL_TRACE_FUNCTION(glIsEnabledi)
+GL_TRACE_FUNCTION(glBeginTransformFeedback)
+GL_TRACE_FUNCTION(glEndTransformFeedback)
+GL_TRACE_FUNCTION(glBindBufferRange)
+GL_TRACE_FUNCTION(glBindBufferBase)
+GL_TRACE_FUNCTION(glTransformFeedbackVaryings)
+GL_TRACE_FUNCTION(glGetTransformFeedbackVarying)
+GL_TRACE_FUNCTION(glClampColor)
+GL_TRACE_FUNCTION(glBeginConditionalRender)
+GL_TRACE_FUNCTION(glEndConditionalRender)
+GL_TRACE_FUNCTION(glVertexAttribIPointer)
+GL_TRACE_FUNCTION(glGetVertexAttribIiv)
+GL_TRACE_FUNCTION(glGetVertexAttribIuiv)
+GL_TRACE_FUNCTION(glVertexAttribI1i)
+GL_TRACE_FUNCTION(glVertexAttribI2i)
+GL_TRACE_FUNCTION(glVertexAttribI3i)
+GL_TRACE_FUNCTION(glVertexAttribI4i)
+GL_TRACE_FUNCTION(glVertexAttribI1ui)
+GL_TRACE_FUNCTION(glVertexAttribI2ui)
+GL_TRACE_FUNCTION(glVertexAttribI3ui)
+GL_TRACE_FUNCTION(glVertexAttribI4ui)
+GL_TRACE_FUNCTION(glVertexAttribI1iv)
+GL_TRACE_FUNCTION(glVertexAttribI2iv)
+GL_TRACE_FUNCTION(glVertexAttribI3iv)
+GL_TRACE_FUNCTION(glVertexAttribI4iv)
+GL_TRACE_FUNCTION(glVertexAttribI1uiv)
+GL_TRACE_FUNCTION(glVertexAttribI2uiv)
+GL_TRACE_FUNCTION(glVertexAttribI3uiv)
+GL_TRACE_FUNCTION(glVertexAttribI4uiv)
+GL_TRACE_FUNCTION(glVertexAttribI4bv)
+GL_TRACE_FUNCTION(glVertexAttribI4sv)
+GL_TRACE_FUNCTION(glVertexAttribI4ubv)
+GL_TRACE_FUNCTION(glVertexAttribI4usv)
+GL_TRACE_FUNCTION(glGetUniformuiv)
+GL_TRACE_FUNCTION(glBindFragDataLocation)
+GL_TRACE_FUNCTION(glGetFragDataLocation)
+GL_TRACE_FUNCTION(glUniform1ui)
+GL_TRACE_FUNCTION(glUniform2ui)
+GL_TRACE_FUNCTION(glUniform3ui)
+GL_TRACE_FUNCTION(glUniform4ui)
+GL_TRACE_FUNCTION(glUniform1uiv)
+GL_TRACE_FUNCTION(glUniform2uiv)
+GL_TRACE_FUNCTION(glUniform3uiv)
+GL_TRACE_FUNCTION(glUniform4uiv)
+GL_TRACE_FUNCTION(glTexParameterIiv)
+GL_TRACE_FUNCTION(glTexParameterIuiv)
+GL_TRACE_FUNCTION(glGetTexParameterIiv)
+GL_TRACE_FUNCTION(glGetTexParameterIuiv)
+GL_TRACE_FUNCTION(glClearBufferiv)
+GL_TRACE_FUNCTION(glClearBufferuiv)
+GL_TRACE_FUNCTION(glClearBufferfv)
+GL_TRACE_FUNCTION(glClearBufferfi)
+GL_TRACE_FUNCTION(glGetStringi)
+GL_TRACE_FUNCTION(glIsRenderbuffer)
+GL_TRACE_FUNCTION(glBindRenderbuffer)
+GL_TRACE_FUNCTION(glDeleteRenderbuffers)
+GL_TRACE_FUNCTION(glGenRenderbuffers)
+GL_TRACE_FUNCTION(glRenderbufferStorage)
+GL_TRACE_FUNCTION(glGetRenderbufferParameteriv)
+GL_TRACE_FUNCTION(glIsFramebuffer)
+GL_TRACE_FUNCTION(glBindFramebuffer)
+GL_TRACE_FUNCTION(glDeleteFramebuffers)
+GL_TRACE_FUNCTION(glGenFramebuffers)
+GL_TRACE_FUNCTION(glCheckFramebufferStatus)
+GL_TRACE_FUNCTION(glFramebufferTexture1D)
+GL_TRACE_FUNCTION(glFramebufferTexture2D)
+GL_TRACE_FUNCTION(glFramebufferTexture3D)
+GL_TRACE_FUNCTION(glFramebufferRenderbuffer)
+GL_TRACE_FUNCTION(glGetFramebufferAttachmentParameteriv)
+GL_TRACE_FUNCTION(glGenerateMipmap)
+GL_TRACE_FUNCTION(glBlitFramebuffer)
+GL_TRACE_FUNCTION(glRenderbufferStorageMultisample)
+GL_TRACE_FUNCTION(glFramebufferTextureLayer)
+GL_TRACE_FUNCTION(glMapBufferRange)
+GL_TRACE_FUNCTION(glFlushMappedBufferRange)
+GL_TRACE_FUNCTION(glBindVertexArray)
+GL_TRACE_FUNCTION(glDeleteVertexArrays)
+GL_TRACE_FUNCTION(glGenVertexArrays)
+GL_TRACE_FUNCTION(glIsVertexArray)
+GL_TRACE_FUNCTION(glDrawArraysInstanced)
+GL_TRACE_FUNCTION(glDrawElementsInstanced)
+GL_TRACE_FUNCTION(glTexBuffer)
+GL_TRACE_FUNCTION(glPrimitiveRestartIndex)
+GL_TRACE_FUNCTION(glCopyBufferSubData)
+GL_TRACE_FUNCTION(glGetUniformIndices)
+GL_TRACE_FUNCTION(glGetActiveUniformsiv)
+GL_TRACE_FUNCTION(glGetActiveUniformName)
+GL_TRACE_FUNCTION(glGetUniformBlockIndex)
+GL_TRACE_FUNCTION(glGetActiveUniformBlockiv)
+GL_TRACE_FUNCTION(glGetActiveUniformBlockName)
+GL_TRACE_FUNCTION(glUniformBlockBinding)
+GL_TRACE_FUNCTION(glDrawElementsBaseVertex)
+GL_TRACE_FUNCTION(glDrawRangeElementsBaseVertex)
+GL_TRACE_FUNCTION(glDrawElementsInstancedBaseVertex)
+GL_TRACE_FUNCTION(glMultiDrawElementsBaseVertex)
+GL_TRACE_FUNCTION(glProvokingVertex)
+GL_TRACE_FUNCTION(glFenceSync)
+GL_TRACE_FUNCTION(glIsSync)
+GL_TRACE_FUNCTION(glDeleteSync)
+GL_TRACE_FUNCTION(glClientWaitSync)
+GL_TRACE_FUNCTION(glWaitSync)
+GL_TRACE_FUNCTION(glGetInteger64v)
+GL_TRACE_FUNCTION(glGetSynciv)
+GL_TRACE_FUNCTION(glGetInteger64i_v)
+GL_TRACE_FUNCTION(glGetBufferParameteri64v)
+GL_TRACE_FUNCTION(glFramebufferTexture)
+GL_TRACE_FUNCTION(glTexImage2DMultisample)
+GL_TRACE_FUNCTION(glTexImage3DMultisample)
+GL_TRACE_FUNCTION(glGetMultisamplefv)
+GL_TRACE_FUNCTION(glSampleMaski)
+GL_TRACE_FUNCTION(glBindFragDataLocationIndexed)
+GL_TRACE_FUNCTION(glGetFragDataIndex)
+GL_TRACE_FUNCTION(glGenSamplers)
+GL_TRACE_FUNCTION(glDeleteSamplers)
+GL_TRACE_FUNCTION(glIsSampler)
+GL_TRACE_FUNCTION(glBindSampler)
+GL_TRACE_FUNCTION(glSamplerParameteri)
+GL_TRACE_FUNCTION(glSamplerParameteriv)
+GL_TRACE_FUNCTION(glSamplerParameterf)
+GL_TRACE_FUNCTION(glSamplerParameterfv)
+GL_TRACE_FUNCTION(glSamplerParameterIiv)
+GL_TRACE_FUNCTION(glSamplerParameterIuiv)
+GL_TRACE_FUNCTION(glGetSamplerParameteriv)
+GL_TRACE_FUNCTION(glGetSamplerParameterIiv)
+GL_TRACE_FUNCTION(glGetSamplerParameterfv)
+GL_TRACE_FUNCTION(glGetSamplerParameterIuiv)
+GL_TRACE_FUNCTION(glQueryCounter)
+GL_TRACE_FUNCTION(glGetQueryObjecti64v)
+GL_TRACE_FUNCTION(glGetQueryObjectui64v)
+GL_TRACE_FUNCTION(glVertexAttribDivisor)
+GL_TRACE_FUNCTION(glVertexAttribP1ui)
+GL_TRACE_FUNCTION(glVertexAttribP1uiv)
+GL_TRACE_FUNCTION(glVertexAttribP2ui)
+GL_TRACE_FUNCTION(glVertexAttribP2uiv)
+GL_TRACE_FUNCTION(glVertexAttribP3ui)
+GL_TRACE_FUNCTION(glVertexAttribP3uiv)
+GL_TRACE_FUNCTION(glVertexAttribP4ui)
+GL_TRACE_FUNCTION(glVertexAttribP4uiv)
+GL_TRACE_FUNCTION(glVertexP2ui)
+GL_TRACE_FUNCTION(glVertexP2uiv)
+GL_TRACE_FUNCTION(glVertexP3ui)
+GL_TRACE_FUNCTION(glVertexP3uiv)
+GL_TRACE_FUNCTION(glVertexP4ui)
+GL_TRACE_FUNCTION(glVertexP4uiv)
+GL_TRACE_FUNCTION(glTexCoordP1ui)
+GL_TRACE_FUNCTION(glTexCoordP1uiv)
+GL_TRACE_FUNCTION(glTexCoordP2ui)
+GL_TRACE_FUNCTION(glTexCoordP2uiv)
+GL_TRACE_FUNCTION(glTexCoordP3ui)
+GL_TRACE_FUNCTION(glTexCoordP3uiv)
+GL_TRACE_FUNCTION(glTexCoordP4ui)
+GL_TRACE_FUNCTION(glTexCoordP4uiv)
+GL_TRACE_FUNCTION(glMultiTexCoordP1ui)
+GL_TRACE_FUNCTION(glMultiTexCoordP1uiv)
+GL_TRACE_FUNCTION(glMultiTexCoordP2ui)
+GL_TRACE_FUNCTION(glMultiTexCoordP2uiv)
+GL_TRACE_FUNCTION(glMultiTexCoordP3ui)
+GL_TRACE_FUNCTION(glMultiTexCoordP3uiv)
+GL_TRACE_FUNCTION(glMultiTexCoordP4ui)
+GL_TRACE_FUNCTION(glMultiTexCoordP4uiv)
+GL_TRACE_FUNCTION(glNormalP3ui)
+GL_TRACE_FUNCTION(glNormalP3uiv)
+GL_TRACE_FUNCTION(glColorP3ui)
+GL_TRACE_FUNCTION(glColorP3uiv)
+GL_TRACE_FUNCTION(glColorP4ui)
+GL_TRACE_FUNCTION(glColorP4uiv)
+GL_TRACE_FUNCTION(glSecondaryColorP3ui)
+GL_TRACE_FUNCTION(glSecondaryColorP3uiv)
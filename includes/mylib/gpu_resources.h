@@ -0,0 +1,293 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mylib/render_device.h>
+#include <mylib/render_stats.h>
+
+
+// GPUԴȨ󴴽ǼǵGpuResourcesӵֻľõʱٽ豸
+// ͷź۵Ĵһ֮ǰƳȥľȫʧЧõ0֮󴴽¶
+// ͷֻǵǼǣһ֡ʱΧͨGPUʹЩ󣩺ɾ
+enum class GpuResourceType : std::uint8_t { buffer, vertexArray, texture, program, count };
+
+inline const char* GetGpuResourceTypeName(GpuResourceType type)
+{
+    static const char* names[] = { "buffer", "vertexArray", "texture", "program" };
+    return type < GpuResourceType::count ? names[static_cast<int>(type)] : "unknown";
+}
+
+// Ϊ0ǿվ
+template <GpuResourceType Type>
+struct GpuHandle
+{
+    std::uint32_t mIndex = 0;
+    std::uint32_t mGeneration = 0;
+
+    explicit operator bool() const { return mGeneration != 0; }
+    bool operator==(const GpuHandle& other) const { return mIndex == other.mIndex && mGeneration == other.mGeneration; }
+    bool operator!=(const GpuHandle& other) const { return !(*this == other); }
+};
+
+using BufferHandle = GpuHandle<GpuResourceType::buffer>;
+using VertexArrayHandle = GpuHandle<GpuResourceType::vertexArray>;
+using TextureHandle = GpuHandle<GpuResourceType::texture>;
+using ProgramHandle = GpuHandle<GpuResourceType::program>;
+
+
+class GpuResources
+{
+public:
+    static GpuResources& Get()
+    {
+        static GpuResources resources;
+        return resources;
+    }
+
+    // Ǽ豸ĶbytesRenderStatsжӦԴ棬labelй©
+    template <GpuResourceType Type>
+    GpuHandle<Type> Add(std::uint32_t object, std::int64_t bytes, const std::string& label);
+    // Ѿͷʱ0
+    template <GpuResourceType Type>
+    std::uint32_t Resolve(GpuHandle<Type> handle) const;
+    template <GpuResourceType Type>
+    bool IsValid(GpuHandle<Type> handle) const { return Resolve(handle) != 0; }
+    // ĴС仯ʱ·䡢mipǼǵֽ
+    template <GpuResourceType Type>
+    void AddBytes(GpuHandle<Type> handle, std::int64_t bytes);
+    // ʧЧÿգһ֡ΧͨɾվѾʧЧľʲô
+    template <GpuResourceType Type>
+    void Release(GpuHandle<Type>& handle);
+
+    // ÿ֡ʱãΪһ֡ͷŵĶΧɾΧѾͨĶ
+    void EndFrame();
+    // ȴΧɾͷ˵Ķ˳ǰл豸ǰ
+    void Flush();
+
+    std::size_t GetLiveCount() const;
+    std::size_t GetPendingCount() const;
+    // ûͷŵĶ˳ǰʱй©Ķ
+    void PrintLeaks(std::ostream& out) const;
+
+private:
+    struct Slot
+    {
+        std::uint32_t mObject = 0;
+        std::uint32_t mGeneration = 1;
+        std::int64_t mBytes = 0;
+        std::string mLabel;
+    };
+
+    // ͷ˵ûɾĶ
+    struct Retired
+    {
+        GpuResourceType mType;
+        std::uint32_t mObject;
+        std::int64_t mBytes;
+    };
+
+    // һ֡ͷŵĶһ֡ʱΧ
+    struct RetiredBatch
+    {
+        std::uint32_t mFence;
+        std::vector<Retired> mObjects;
+    };
+
+    static const int kTypeCount = static_cast<int>(GpuResourceType::count);
+    std::vector<Slot> mSlots[kTypeCount];
+    std::vector<std::uint32_t> mFreeSlots[kTypeCount];  // ʹõĲۣѾӹһ
+    std::vector<Retired> mRetired;
+    std::deque<RetiredBatch> mBatches;
+
+    GpuResources() = default;
+
+    static void _addMemory(GpuResourceType type, std::int64_t bytes);
+    static void _delete(const Retired& retired);
+    // ɾǰļΧѾͨĶwaitʱһֱȵȫɾ
+    void _collect(bool wait);
+};
+
+
+// ڴshader֮ǰ죬˳ȵǼͷţ֮ɾж󡢱й©onExitglfwTerminateرģ
+class GpuResourcesShutdown
+{
+public:
+    explicit GpuResourcesShutdown(void (*onExit)() = nullptr) : mOnExit(onExit) {}
+    ~GpuResourcesShutdown()
+    {
+        GpuResources::Get().Flush();
+        GpuResources::Get().PrintLeaks(std::cout);
+        if (mOnExit) {
+            mOnExit();
+        }
+    }
+    GpuResourcesShutdown(const GpuResourcesShutdown&) = delete;
+    GpuResourcesShutdown& operator=(const GpuResourcesShutdown&) = delete;
+
+private:
+    void (*mOnExit)();
+};
+
+
+template <GpuResourceType Type>
+GpuHandle<Type> GpuResources::Add(std::uint32_t object, std::int64_t bytes, const std::string& label)
+{
+    auto&& slots = mSlots[static_cast<int>(Type)];
+    auto&& freeSlots = mFreeSlots[static_cast<int>(Type)];
+    std::uint32_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        index = static_cast<std::uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+    Slot& slot = slots[index];
+    slot.mObject = object;
+    slot.mBytes = bytes;
+    slot.mLabel = label;
+    _addMemory(Type, bytes);
+    return { index, slot.mGeneration };
+}
+
+template <GpuResourceType Type>
+std::uint32_t GpuResources::Resolve(GpuHandle<Type> handle) const
+{
+    auto&& slots = mSlots[static_cast<int>(Type)];
+    if (handle.mIndex >= slots.size() || slots[handle.mIndex].mGeneration != handle.mGeneration) {
+        return 0;
+    }
+    return slots[handle.mIndex].mObject;
+}
+
+template <GpuResourceType Type>
+void GpuResources::AddBytes(GpuHandle<Type> handle, std::int64_t bytes)
+{
+    if (!IsValid(handle)) {
+        return;
+    }
+    mSlots[static_cast<int>(Type)][handle.mIndex].mBytes += bytes;
+    _addMemory(Type, bytes);
+}
+
+template <GpuResourceType Type>
+void GpuResources::Release(GpuHandle<Type>& handle)
+{
+    if (IsValid(handle)) {
+        Slot& slot = mSlots[static_cast<int>(Type)][handle.mIndex];
+        mRetired.push_back({ Type, slot.mObject, slot.mBytes });
+        slot.mObject = 0;
+        slot.mBytes = 0;
+        slot.mLabel.clear();
+        // ʱ00վ
+        slot.mGeneration = slot.mGeneration + 1 == 0 ? 1 : slot.mGeneration + 1;
+        mFreeSlots[static_cast<int>(Type)].push_back(handle.mIndex);
+    }
+    handle = {};
+}
+
+void GpuResources::EndFrame()
+{
+    if (!mRetired.empty()) {
+        mBatches.push_back({ RenderDevice::Get().CreateFence(), std::move(mRetired) });
+        mRetired.clear();
+    }
+    _collect(false);
+}
+
+void GpuResources::Flush()
+{
+    EndFrame();
+    _collect(true);
+}
+
+void GpuResources::_collect(bool wait)
+{
+    RenderDevice& device = RenderDevice::Get();
+    while (!mBatches.empty()) {
+        // ȴʱһ룬GPUסʱһֱ
+        if (!device.WaitFence(mBatches.front().mFence, wait ? 1000000000ull : 0)) {
+            break;
+        }
+        for (auto&& retired : mBatches.front().mObjects) {
+            _delete(retired);
+        }
+        mBatches.pop_front();
+    }
+}
+
+void GpuResources::_addMemory(GpuResourceType type, std::int64_t bytes)
+{
+    if (type == GpuResourceType::buffer) {
+        RenderStats::Get().AddBufferMemory(bytes);
+    }
+    else if (type == GpuResourceType::texture) {
+        RenderStats::Get().AddTextureMemory(bytes);
+    }
+}
+
+void GpuResources::_delete(const Retired& retired)
+{
+    RenderDevice& device = RenderDevice::Get();
+    switch (retired.mType)
+    {
+    case GpuResourceType::buffer:
+        device.DeleteBuffer(retired.mObject);
+        break;
+    case GpuResourceType::vertexArray:
+        device.DeleteVertexArray(retired.mObject);
+        break;
+    case GpuResourceType::texture:
+        device.DeleteTexture(retired.mObject);
+        break;
+    case GpuResourceType::program:
+        device.DeleteProgram(retired.mObject);
+        break;
+    default:
+        break;
+    }
+    _addMemory(retired.mType, -retired.mBytes);
+}
+
+std::size_t GpuResources::GetLiveCount() const
+{
+    std::size_t count = 0;
+    for (int type = 0; type < kTypeCount; type++) {
+        count += mSlots[type].size() - mFreeSlots[type].size();
+    }
+    return count;
+}
+
+std::size_t GpuResources::GetPendingCount() const
+{
+    std::size_t count = mRetired.size();
+    for (auto&& batch : mBatches) {
+        count += batch.mObjects.size();
+    }
+    return count;
+}
+
+void GpuResources::PrintLeaks(std::ostream& out) const
+{
+    std::int64_t totalBytes = 0;
+    for (int type = 0; type < kTypeCount; type++) {
+        for (auto&& slot : mSlots[type]) {
+            if (slot.mObject != 0) {
+                totalBytes += slot.mBytes;
+            }
+        }
+    }
+    out << "GPU resources: " << GetLiveCount() << " live (" << totalBytes / 1024 << " KB), " << GetPendingCount() << " waiting for deletion" << std::endl;
+    for (int type = 0; type < kTypeCount; type++) {
+        for (auto&& slot : mSlots[type]) {
+            if (slot.mObject != 0) {
+                out << "  " << GetGpuResourceTypeName(static_cast<GpuResourceType>(type)) << " " << slot.mObject << " "
+                    << (slot.mLabel.empty() ? "(unnamed)" : slot.mLabel) << ": " << slot.mBytes << " bytes" << std::endl;
+            }
+        }
+    }
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+// ޴ڵGLģEGL3.3 coreģȾ֡
+// γԣMesasurfacelessƽ̨llvmpipeȾEGL豸ö٣ʾĶԿĬʾ
+// ֧EGL_KHR_surfaceless_contextʱκsurface򴴽һpbuffer
+class HeadlessContext {
+public:
+    HeadlessContext() = default;
+    ~HeadlessContext() { Destroy(); }
+
+    // ĲGLʧʱӡԭ򲢷false
+    bool Create(int width, int height);
+    void Destroy();
+
+private:
+    EGLDisplay mDisplay = EGL_NO_DISPLAY;
+    EGLContext mContext = EGL_NO_CONTEXT;
+    EGLSurface mSurface = EGL_NO_SURFACE;
+
+    EGLDisplay _getDisplay();
+    static bool _hasExtension(const char* extensions, const char* name);
+};
+
+bool HeadlessContext::_hasExtension(const char* extensions, const char* name)
+{
+    if (!extensions) {
+        return false;
+    }
+    std::size_t length = std::strlen(name);
+    for (const char* found = std::strstr(extensions, name); found; found = std::strstr(found + length, name)) {
+        if ((found == extensions || found[-1] == ' ') && (found[length] == ' ' || found[length] == '\0')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+EGLDisplay HeadlessContext::_getDisplay()
+{
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+    if (getPlatformDisplay && _hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+        if (display != EGL_NO_DISPLAY && eglInitialize(display, NULL, NULL)) {
+            return display;
+        }
+    }
+
+    auto queryDevices = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(eglGetProcAddress("eglQueryDevicesEXT"));
+    if (getPlatformDisplay && queryDevices && _hasExtension(clientExtensions, "EGL_EXT_platform_device")) {
+        EGLDeviceEXT devices[8];
+        EGLint deviceCount = 0;
+        queryDevices(8, devices, &deviceCount);
+        for (EGLint i = 0; i < deviceCount; i++) {
+            EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_DEVICE_EXT, devices[i], NULL);
+            if (display != EGL_NO_DISPLAY && eglInitialize(display, NULL, NULL)) {
+                return display;
+            }
+        }
+    }
+
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display != EGL_NO_DISPLAY && eglInitialize(display, NULL, NULL)) {
+        return display;
+    }
+    return EGL_NO_DISPLAY;
+}
+
+bool HeadlessContext::Create(int width, int height)
+{
+    mDisplay = _getDisplay();
+    if (mDisplay == EGL_NO_DISPLAY) {
+        std::cout << "Failed to initialize EGL display" << std::endl;
+        return false;
+    }
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cout << "EGL does not support desktop OpenGL" << std::endl;
+        return false;
+    }
+
+    bool surfaceless = _hasExtension(eglQueryString(mDisplay, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(mDisplay, configAttribs, &config, 1, &configCount) || configCount == 0) {
+        std::cout << "Failed to choose EGL config" << std::endl;
+        return false;
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    mContext = eglCreateContext(mDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+    if (mContext == EGL_NO_CONTEXT) {
+        std::cout << "Failed to create OpenGL 3.3 core context, error 0x" << std::hex << eglGetError() << std::dec << std::endl;
+        return false;
+    }
+
+    if (!surfaceless) {
+        const EGLint surfaceAttribs[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+        mSurface = eglCreatePbufferSurface(mDisplay, config, surfaceAttribs);
+    }
+    if (!eglMakeCurrent(mDisplay, mSurface, mSurface, mContext)) {
+        std::cout << "Failed to make EGL context current" << std::endl;
+        return false;
+    }
+
+    if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return false;
+    }
+    std::cout << "Headless context: " << glGetString(GL_RENDERER) << ", " << glGetString(GL_VERSION)
+        << (surfaceless ? ", surfaceless" : ", pbuffer") << std::endl;
+    return true;
+}
+
+void HeadlessContext::Destroy()
+{
+    if (mDisplay == EGL_NO_DISPLAY) {
+        return;
+    }
+    eglMakeCurrent(mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (mSurface != EGL_NO_SURFACE) {
+        eglDestroySurface(mDisplay, mSurface);
+    }
+    if (mContext != EGL_NO_CONTEXT) {
+        eglDestroyContext(mDisplay, mContext);
+    }
+    eglTerminate(mDisplay);
+    mDisplay = EGL_NO_DISPLAY;
+    mContext = EGL_NO_CONTEXT;
+    mSurface = EGL_NO_SURFACE;
+}
+
+
+// RGB8رΪPPMͼƬpixelsglReadPixels˳µ
+bool WritePPM(const std::string& path, const std::vector<std::uint8_t>& pixels, int width, int height)
+{
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    std::fprintf(file, "P6\n%d %d\n255\n", width, height);
+    for (int y = height - 1; y >= 0; y--) {
+        std::fwrite(pixels.data() + static_cast<std::size_t>(y) * width * 3, 1, static_cast<std::size_t>(width) * 3, file);
+    }
+    std::fclose(file);
+    return true;
+}
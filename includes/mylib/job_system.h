@@ -0,0 +1,443 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+class JobSystem;
+struct Job;
+
+// dataָԴĲ
+using JobFunction = void (*)(JobSystem& jobSystem, Job& job, const void* data);
+
+// 񣬹̶128ֽڣÿ߳ԤȷõĻȡʱٷڴ
+// mUnfinishedJobsΪԼδɵΪ0ʱɣ֪ͨͺ
+struct alignas(64) Job
+{
+    static const int kMaxContinuations = 3;
+
+    JobFunction mFunction;
+    Job* mParent;
+    std::atomic<std::int32_t> mUnfinishedJobs;
+    std::atomic<std::int32_t> mContinuationCount;
+    Job* mContinuations[kMaxContinuations];
+    bool mMainThreadOnly;  // ֻ̣߳GḶִ߳
+    unsigned char mData[128 - 56];
+};
+static_assert(sizeof(Job) == 128, "Job should fill two cache lines");
+
+
+// Chase-Levȡ˫˶У߳ڵײѹ/̴߳Ӷȡ
+class WorkStealingQueue
+{
+public:
+    static const std::int64_t kCapacity = 4096;
+
+    void Push(Job* job)
+    {
+        std::int64_t bottom = mBottom.load(std::memory_order_relaxed);
+        mJobs[bottom & (kCapacity - 1)].store(job, std::memory_order_relaxed);
+        mBottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    Job* Pop()
+    {
+        std::int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+        mBottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t top = mTop.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            // Ϊ
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* job = mJobs[bottom & (kCapacity - 1)].load(std::memory_order_relaxed);
+        if (top != bottom) {
+            return job;
+        }
+
+        // ֻʣһҪȡ߳̾
+        if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            job = nullptr;
+        }
+        mBottom.store(bottom + 1, std::memory_order_relaxed);
+        return job;
+    }
+
+    Job* Steal()
+    {
+        std::int64_t top = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t bottom = mBottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+
+        Job* job = mJobs[top & (kCapacity - 1)].load(std::memory_order_relaxed);
+        if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            // ߳
+            return nullptr;
+        }
+        return job;
+    }
+
+private:
+    alignas(64) std::atomic<std::int64_t> mTop{ 0 };
+    alignas(64) std::atomic<std::int64_t> mBottom{ 0 };
+    std::atomic<Job*> mJobs[kCapacity];
+};
+
+
+// ȡϵͳ
+// 0߳Ϊ̣߳Ϊ̣߳ÿ߳Լк
+// ÷
+//   Job* root = jobSystem.CreateJob(func, data);
+//   Job* child = jobSystem.CreateChildJob(root, func, data);
+//   jobSystem.Run(child); jobSystem.Run(root); jobSystem.Wait(root);
+// ÿ߳ͬʱڵܳkMaxJobsPerThreadеᱻ
+// ֻ̺߳͹߳̿Դ
+class JobSystem
+{
+public:
+    static const std::uint32_t kMaxJobsPerThread = 4096;
+
+    // workerCountΪ߳߳
+    explicit JobSystem(unsigned int workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned int GetThreadCount() const { return static_cast<unsigned int>(mQueues.size()); }
+
+    Job* CreateJob(JobFunction function);
+    Job* CreateChildJob(Job* parent, JobFunction function);
+    // ִֻ߳еڵGL
+    Job* CreateMainThreadJob(JobFunction function);
+
+    // 񣬲ֵĲ
+    template<typename T>
+    Job* CreateJob(JobFunction function, const T& data);
+    template<typename T>
+    Job* CreateChildJob(Job* parent, JobFunction function, const T& data);
+
+    // ancestorɺſʼִcontinuationҪRun(ancestor)֮ǰ
+    void AddContinuation(Job* ancestor, Job* continuation);
+
+    void Run(Job* job);
+    // ȴɣȴʱǰ̻߳æִ
+    void Wait(const Job* job);
+    bool IsFinished(const Job* job) const;
+
+    // [0, count)ֳɶβִfunction(begin, end)ÿbatchSizeʱȫִ
+    template<typename Function>
+    void ParallelFor(std::size_t count, std::size_t batchSize, const Function& function);
+
+private:
+    struct MainThreadQueue
+    {
+        std::mutex mMutex;
+        Job* mJobs[kMaxJobsPerThread];
+        std::uint32_t mHead = 0;
+        std::uint32_t mTail = 0;
+    };
+
+    template<typename Function>
+    struct ParallelForData
+    {
+        const Function* mFunction;
+        std::size_t mBegin;
+        std::size_t mEnd;
+        std::size_t mBatchSize;
+    };
+
+    // ÿ̶߳ռأжα
+    struct alignas(64) JobPool
+    {
+        std::unique_ptr<Job[]> mJobs;
+        std::uint32_t mAllocated = 0;
+    };
+
+    std::vector<std::unique_ptr<WorkStealingQueue>> mQueues;
+    std::vector<JobPool> mJobPools;
+    MainThreadQueue mMainThreadQueue;
+
+    std::vector<std::thread> mWorkers;
+    std::atomic<bool> mRunning{ true };
+    std::atomic<std::int32_t> mSleepingWorkers{ 0 };
+    std::mutex mWakeMutex;
+    std::condition_variable mWakeCondition;
+
+    static unsigned int& _threadIndex();
+    Job* _allocateJob();
+    Job* _getJob();
+    void _execute(Job* job);
+    void _finish(Job* job);
+    void _workerLoop(unsigned int threadIndex);
+
+    template<typename Function>
+    static void _parallelForJob(JobSystem& jobSystem, Job& job, const void* data);
+};
+
+JobSystem::JobSystem(unsigned int workerCount)
+{
+    unsigned int threadCount = workerCount + 1;
+    mJobPools.resize(threadCount);
+    for (unsigned int i = 0; i < threadCount; i++) {
+        mQueues.emplace_back(new WorkStealingQueue());
+        mJobPools[i].mJobs.reset(new Job[kMaxJobsPerThread]);
+    }
+
+    // ϵͳ߳Ϊ߳
+    _threadIndex() = 0;
+    for (unsigned int i = 1; i < threadCount; i++) {
+        mWorkers.emplace_back(&JobSystem::_workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    mRunning = false;
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mWakeCondition.notify_all();
+    }
+    for (auto&& worker : mWorkers) {
+        worker.join();
+    }
+}
+
+unsigned int& JobSystem::_threadIndex()
+{
+    static thread_local unsigned int threadIndex = 0;
+    return threadIndex;
+}
+
+Job* JobSystem::_allocateJob()
+{
+    JobPool& pool = mJobPools[_threadIndex()];
+    return &pool.mJobs[pool.mAllocated++ & (kMaxJobsPerThread - 1)];
+}
+
+Job* JobSystem::CreateJob(JobFunction function)
+{
+    Job* job = _allocateJob();
+    job->mFunction = function;
+    job->mParent = nullptr;
+    job->mUnfinishedJobs.store(1, std::memory_order_relaxed);
+    job->mContinuationCount.store(0, std::memory_order_relaxed);
+    job->mMainThreadOnly = false;
+    return job;
+}
+
+Job* JobSystem::CreateChildJob(Job* parent, JobFunction function)
+{
+    parent->mUnfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+    Job* job = CreateJob(function);
+    job->mParent = parent;
+    return job;
+}
+
+Job* JobSystem::CreateMainThreadJob(JobFunction function)
+{
+    Job* job = CreateJob(function);
+    job->mMainThreadOnly = true;
+    return job;
+}
+
+template<typename T>
+Job* JobSystem::CreateJob(JobFunction function, const T& data)
+{
+    static_assert(sizeof(T) <= sizeof(Job::mData), "Job data is too large");
+    static_assert(std::is_trivially_copyable<T>::value, "Job data should be trivially copyable");
+    Job* job = CreateJob(function);
+    std::memcpy(job->mData, &data, sizeof(T));
+    return job;
+}
+
+template<typename T>
+Job* JobSystem::CreateChildJob(Job* parent, JobFunction function, const T& data)
+{
+    static_assert(sizeof(T) <= sizeof(Job::mData), "Job data is too large");
+    static_assert(std::is_trivially_copyable<T>::value, "Job data should be trivially copyable");
+    Job* job = CreateChildJob(parent, function);
+    std::memcpy(job->mData, &data, sizeof(T));
+    return job;
+}
+
+void JobSystem::AddContinuation(Job* ancestor, Job* continuation)
+{
+    std::int32_t index = ancestor->mContinuationCount.fetch_add(1, std::memory_order_relaxed);
+    if (index >= Job::kMaxContinuations) {
+        std::cout << "Too many continuations on one job" << std::endl;
+        ancestor->mContinuationCount.fetch_sub(1, std::memory_order_relaxed);
+        return;
+    }
+    ancestor->mContinuations[index] = continuation;
+}
+
+void JobSystem::Run(Job* job)
+{
+    if (job->mMainThreadOnly) {
+        std::lock_guard<std::mutex> lock(mMainThreadQueue.mMutex);
+        mMainThreadQueue.mJobs[mMainThreadQueue.mTail++ & (kMaxJobsPerThread - 1)] = job;
+        return;
+    }
+
+    mQueues[_threadIndex()]->Push(job);
+    if (mSleepingWorkers.load(std::memory_order_acquire) > 0) {
+        mWakeCondition.notify_one();
+    }
+}
+
+bool JobSystem::IsFinished(const Job* job) const
+{
+    return job->mUnfinishedJobs.load(std::memory_order_acquire) == 0;
+}
+
+void JobSystem::Wait(const Job* job)
+{
+    while (!IsFinished(job)) {
+        Job* next = _getJob();
+        if (next) {
+            _execute(next);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+Job* JobSystem::_getJob()
+{
+    unsigned int threadIndex = _threadIndex();
+
+    // ִֻ߳߳ܵ
+    if (threadIndex == 0) {
+        std::lock_guard<std::mutex> lock(mMainThreadQueue.mMutex);
+        if (mMainThreadQueue.mHead != mMainThreadQueue.mTail) {
+            return mMainThreadQueue.mJobs[mMainThreadQueue.mHead++ & (kMaxJobsPerThread - 1)];
+        }
+    }
+
+    Job* job = mQueues[threadIndex]->Pop();
+    if (job) {
+        return job;
+    }
+
+    // ԼĶΪգ߳ȡپ
+    unsigned int threadCount = GetThreadCount();
+    static thread_local std::uint32_t randomState = 2463534242u + threadIndex;
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    for (unsigned int i = 0; i < threadCount; i++) {
+        unsigned int victim = (randomState + i) % threadCount;
+        if (victim == threadIndex) {
+            continue;
+        }
+        job = mQueues[victim]->Steal();
+        if (job) {
+                return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::_execute(Job* job)
+{
+    job->mFunction(*this, *job, job->mData);
+    _finish(job);
+}
+
+void JobSystem::_finish(Job* job)
+{
+    std::int32_t unfinishedJobs = job->mUnfinishedJobs.fetch_sub(1, std::memory_order_acq_rel) - 1;
+    if (unfinishedJobs != 0) {
+        return;
+    }
+
+    // ȡ֪֮ͨʱܱȴ߸
+    std::int32_t continuationCount = job->mContinuationCount.load(std::memory_order_relaxed);
+    Job* continuations[Job::kMaxContinuations];
+    for (std::int32_t i = 0; i < continuationCount; i++) {
+        continuations[i] = job->mContinuations[i];
+    }
+
+    if (job->mParent) {
+        _finish(job->mParent);
+    }
+
+    for (std::int32_t i = 0; i < continuationCount; i++) {
+        Run(continuations[i]);
+    }
+}
+
+void JobSystem::_workerLoop(unsigned int threadIndex)
+{
+    _threadIndex() = threadIndex;
+
+    int idleCount = 0;
+    while (mRunning.load(std::memory_order_relaxed)) {
+        Job* job = _getJob();
+        if (job) {
+            _execute(job);
+            idleCount = 0;
+            continue;
+        }
+
+        // ֮ߣʱ
+        // ѹʱѿܶʧֻߺ̵ܶʱ¼
+        if (++idleCount < 64) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mWakeMutex);
+        mSleepingWorkers.fetch_add(1, std::memory_order_acq_rel);
+        if (mRunning.load(std::memory_order_relaxed)) {
+            mWakeCondition.wait_for(lock, std::chrono::milliseconds(1));
+        }
+        mSleepingWorkers.fetch_sub(1, std::memory_order_acq_rel);
+        idleCount = 0;
+    }
+}
+
+template<typename Function>
+void JobSystem::ParallelFor(std::size_t count, std::size_t batchSize, const Function& function)
+{
+    if (count == 0) {
+        return;
+    }
+    ParallelForData<Function> data = { &function, 0, count, std::max<std::size_t>(1, batchSize) };
+    Job* root = CreateJob(&JobSystem::_parallelForJob<Function>, data);
+    Run(root);
+    Wait(root);
+}
+
+template<typename Function>
+void JobSystem::_parallelForJob(JobSystem& jobSystem, Job& job, const void* data)
+{
+    // Χһʱ԰ÿ߳̿ȡϴĿ
+    ParallelForData<Function> range = *static_cast<const ParallelForData<Function>*>(data);
+    if (range.mEnd - range.mBegin > range.mBatchSize) {
+        std::size_t middle = range.mBegin + (range.mEnd - range.mBegin) / 2;
+        ParallelForData<Function> left = { range.mFunction, range.mBegin, middle, range.mBatchSize };
+        ParallelForData<Function> right = { range.mFunction, middle, range.mEnd, range.mBatchSize };
+        jobSystem.Run(jobSystem.CreateChildJob(&job, &JobSystem::_parallelForJob<Function>, left));
+        jobSystem.Run(jobSystem.CreateChildJob(&job, &JobSystem::_parallelForJob<Function>, right));
+        return;
+    }
+    (*range.mFunction)(range.mBegin, range.mEnd);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <mylib/shader_s.h>
+
+
+// ǰȾԴ
+// ÿԴ˥ϵõӰ뾶ǰֻѡΧཻյļԴ
+// ѡеĹԴдshader_2_obj.fspointLights飬programͬĹԴʱظϴ
+class LightAssigner {
+public:
+    // shader_2_obj.fsеNR_POINT_LIGHTSһ
+    static const std::uint32_t kMaxLightsPerObject = 4;
+
+    // óееԴԴ仯Ҫ
+    void SetLights(const std::vector<LightParameters::PointLight>& pointLights);
+
+    // ѡӰΧĹԴյΧϵȴӸߵ
+    const std::vector<std::uint32_t>& Select(const glm::vec3& center, float radius, std::uint32_t maxCount = kMaxLightsPerObject);
+
+    // ѡԴϴshaderҪȵshader.use()
+    void Apply(Shader& shader, const glm::vec3& center, float radius);
+
+    // ϴReset֮ĹԴԼΪprogramйԴͬϴ
+    std::uint32_t GetAssignedCount() const { return mAssignedCount; }
+    std::uint32_t GetSkippedCount() const { return mSkippedCount; }
+    void ResetStats() { mAssignedCount = mSkippedCount = 0; }
+
+private:
+    std::vector<LightParameters::PointLight> mLights;
+    std::vector<float> mRadii;
+    std::vector<float> mIntensities;  // diffuseķ
+
+    std::vector<std::pair<float, std::uint32_t>> mCandidates;
+    std::vector<std::uint32_t> mSelected;
+    std::map<unsigned int, std::vector<std::uint32_t>> mApplied;  // ÿprogramһϴĹԴ
+
+    std::uint32_t mAssignedCount = 0;
+    std::uint32_t mSkippedCount = 0;
+};
+
+void LightAssigner::SetLights(const std::vector<LightParameters::PointLight>& pointLights)
+{
+    mLights = pointLights;
+    mRadii.clear();
+    mIntensities.clear();
+    for (auto&& light : mLights) {
+        mRadii.push_back(light.GetInfluenceRadius());
+        mIntensities.push_back(std::max(std::max(light.mDiffuse.r, light.mDiffuse.g), light.mDiffuse.b));
+    }
+    mApplied.clear();
+}
+
+const std::vector<std::uint32_t>& LightAssigner::Select(const glm::vec3& center, float radius, std::uint32_t maxCount)
+{
+    mCandidates.clear();
+    for (std::uint32_t i = 0; i < mLights.size(); i++) {
+        float distance = glm::length(mLights[i].mPosition - center);
+        if (distance > mRadii[i] + radius) {
+            continue;
+        }
+
+        // ðΧԴĵ˥ƹԴĹ
+        auto&& light = mLights[i];
+        float nearest = std::max(0.0f, distance - radius);
+        float attenuation = 1.0f / (light.mConstant + light.mLinear * nearest + light.mQuadratic * nearest * nearest);
+        mCandidates.emplace_back(mIntensities[i] * attenuation, i);
+    }
+
+    std::uint32_t count = std::min(maxCount, static_cast<std::uint32_t>(mCandidates.size()));
+    std::partial_sort(mCandidates.begin(), mCandidates.begin() + count, mCandidates.end(),
+        [](const std::pair<float, std::uint32_t>& a, const std::pair<float, std::uint32_t>& b) {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        });
+
+    mSelected.clear();
+    for (std::uint32_t i = 0; i < count; i++) {
+        mSelected.push_back(mCandidates[i].second);
+    }
+    return mSelected;
+}
+
+void LightAssigner::Apply(Shader& shader, const glm::vec3& center, float radius)
+{
+    const std::vector<std::uint32_t>& selected = Select(center, radius);
+    mAssignedCount += static_cast<std::uint32_t>(selected.size());
+
+    auto&& applied = mApplied[shader.GetID()];
+    if (applied == selected) {
+        mSkippedCount++;
+        return;
+    }
+    applied = selected;
+
+    using PointUniforms = LightParameters::PointLightUniforms;
+    for (std::uint32_t i = 0; i < selected.size() && i < PointUniforms::kCount; i++) {
+        auto&& pointLight = mLights[selected[i]];
+        shader.setVec3(PointUniforms::kPosition[i], pointLight.mPosition);
+        shader.setFloat(PointUniforms::kConstant[i], pointLight.mConstant);
+        shader.setFloat(PointUniforms::kLinear[i], pointLight.mLinear);
+        shader.setFloat(PointUniforms::kQuadratic[i], pointLight.mQuadratic);
+        shader.setVec3(PointUniforms::kAmbient[i], pointLight.mAmbient);
+        shader.setVec3(PointUniforms::kDiffuse[i], pointLight.mDiffuse);
+        shader.setVec3(PointUniforms::kSpecular[i], pointLight.mSpecular);
+    }
+    shader.setInt("pointLightCount"_uid, static_cast<int>(selected.size()));
+}
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <cassert>
 #include <string>
 #include <vector>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <mylib/shader_s.h>
+#include <mylib/command_buffer.h>
+#include <mylib/frame_arena.h>
+#include <mylib/gpu_resources.h>
+#include <mylib/texture_streaming.h>
 
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
@@ -44,22 +49,21 @@ struct Vertex : SimpleVertex {
 
 
 struct Texture {
-    uint id;
+    TextureHandle handle;
     string type;
     aiString path;  // Ǵ·бȽ
+    SamplerPreset sampler = SamplerPreset::trilinearClamp;  // ʲķʽ
 
     Texture() = default;
-    Texture(uint tID, string tType, string tPath) :
-        id(tID), type(tType), path(tPath) {
+    Texture(TextureHandle tHandle, string tType, string tPath) :
+        handle(tHandle), type(tType), path(tPath) {
     }
 };
 
 
-uint TextureFromFile(const char* fileName, const char* filePath = nullptr)
+// ǼǵGpuResources߸ͷŷصľ
+TextureHandle LoadTexture(const char* fileName, const char* filePath = nullptr)
 {
-    uint texture;
-    glGenTextures(1, &texture);
-
     int width, height, nrChannels;
     stbi_set_flip_vertically_on_load(true);
     string resourceLocation;
@@ -69,112 +73,172 @@ uint TextureFromFile(const char* fileName, const char* filePath = nullptr)
     else {
         resourceLocation = string(fileName);
     }
+    // ʱֻmipں̨Ҫ
+    if (TextureStreamer* streamer = TextureStreamer::GetCurrent()) {
+        return streamer->Load(resourceLocation);
+    }
      
     uint8* data = stbi_load(resourceLocation.c_str(), &width, &height, &nrChannels, 0);
-
-    if (data)
-    {
-        GLenum format = GL_ZERO;
-        switch (nrChannels)
-        {
-        case 1:
-            format = GL_RED;
-            break;
-        case 3:
-            format = GL_RGB;
-            break;
-        case 4:
-            format = GL_RGBA;
-            break;
-        default:
-            cout << "Error on channels: " << nrChannels << endl;
-            break;
-        }
-
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        // Ϊǰ󶨵ûơ˷ʽ
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    }
-    else {
+    if (!data) {
         cout << "Failed to load texture" << endl;
     }
+    uint texture = RenderDevice::Get().CreateTexture2D(width, height, nrChannels, data);
+    // Դ水ȫmip
+    std::int64_t bytes = data ? static_cast<std::int64_t>(width) * height * nrChannels : 0;
+    RenderStats::Get().AddTextureUpload(bytes);
     stbi_image_free(data);
-    return texture;
+    return GpuResources::Get().Add<GpuResourceType::texture>(texture, bytes * 4 / 3, resourceLocation);
 }
 
+// GLڳǰһֱڣֱӵGLʾ
+// ûù˷ʽʱҪͬһԪϰ󶨲glBindSampler(unit, RenderDevice::Get().GetSampler(GetSamplerPresetDesc(SamplerPreset::trilinearClamp)))
+uint TextureFromFile(const char* fileName, const char* filePath = nullptr)
+{
+    return GpuResources::Get().Resolve(LoadTexture(fileName, filePath));
+}
+
+// ĶϴGPU֮Ƿ񻹱ڴ
+enum class MeshResidency : uint8
+{
+    gpuOnly,        // ϴͷţֻҪGPU
+    cpuRetained,    // ʰȡײդϴ
+};
+
+// պֻGPUϻƣ
 class SkyBoxMesh {
 public:
-    SkyBoxMesh(const vector<SimpleVertex>& vertices, const vector<uint>& indices, const unsigned int& texture) :
-        mVertices(vertices),
-        mIndices(indices),
-        mTextureID(texture)
+    // պӵдʱһͷ
+    SkyBoxMesh(const vector<SimpleVertex>& vertices, const vector<uint>& indices, TextureHandle texture) :
+        mIndexCount(static_cast<uint>(indices.size())),
+        mTexture(texture)
     {
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glGenBuffers(1, &EBO);
-
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, mVertices.size() * sizeof(SimpleVertex), &mVertices[0], GL_STATIC_DRAW);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIndices.size() * sizeof(unsigned int), &mIndices[0], GL_STATIC_DRAW);
+        RenderDevice& device = RenderDevice::Get();
+        GpuResources& resources = GpuResources::Get();
+        std::int64_t vertexBytes = vertices.size() * sizeof(SimpleVertex);
+        std::int64_t indexBytes = indices.size() * sizeof(unsigned int);
+        uint vertexBuffer = device.CreateBuffer(DeviceBufferType::vertex, vertexBytes, vertices.data(), false);
+        uint indexBuffer = device.CreateBuffer(DeviceBufferType::index, indexBytes, indices.data(), false);
+        RenderStats::Get().AddBufferUpload(vertexBytes + indexBytes);
         // λ
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SimpleVertex), (void*)0);
-
-        glBindVertexArray(0);
+        uint vertexArray = device.CreateVertexArray(vertexBuffer, indexBuffer, { { 0, 3, sizeof(SimpleVertex), 0 } });
+        mVertexBuffer = resources.Add<GpuResourceType::buffer>(vertexBuffer, vertexBytes, "SkyBox vertices");
+        mIndexBuffer = resources.Add<GpuResourceType::buffer>(indexBuffer, indexBytes, "SkyBox indices");
+        mVertexArray = resources.Add<GpuResourceType::vertexArray>(vertexArray, 0, "SkyBox");
+    }
+    ~SkyBoxMesh() { _release(); }
+    SkyBoxMesh(const SkyBoxMesh&) = delete;
+    SkyBoxMesh& operator=(const SkyBoxMesh&) = delete;
+    SkyBoxMesh(SkyBoxMesh&& other) noexcept { *this = std::move(other); }
+    SkyBoxMesh& operator=(SkyBoxMesh&& other) noexcept {
+        if (this != &other) {
+            _release();
+            mIndexCount = other.mIndexCount;
+            mTexture = other.mTexture;
+            mVertexArray = other.mVertexArray;
+            mVertexBuffer = other.mVertexBuffer;
+            mIndexBuffer = other.mIndexBuffer;
+            other.mTexture = {};
+            other.mVertexArray = {};
+            other.mVertexBuffer = other.mIndexBuffer = {};
+        }
+        return *this;
     }
 
     void Draw(Shader& shader, ModelRenderParam& modelRenderParam) {
-        glDepthMask(GL_FALSE);
+        RenderDevice& device = RenderDevice::Get();
+        device.SetDepthWrite(false);
         shader.use();
         // ù۲ͶӰ
-        shader.setMat4("view", glm::mat4(glm::mat3(modelRenderParam.mViewMat)));
-        shader.setMat4("projection", modelRenderParam.mProjMat);
-        glBindVertexArray(VAO);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, mTextureID);
-
-        glDrawElements(GL_TRIANGLES, mIndices.size(), GL_UNSIGNED_INT, 0);
-        glDepthMask(GL_TRUE);
+        shader.setMat4("view"_uid, glm::mat4(glm::mat3(modelRenderParam.mViewMat)));
+        shader.setMat4("projection"_uid, modelRenderParam.mProjMat);
+        GpuResources& resources = GpuResources::Get();
+        device.BindVertexArray(resources.Resolve(mVertexArray));
+        device.BindTexture(0, DeviceTextureType::cubeMap, resources.Resolve(mTexture));
+
+        device.DrawIndexed(mIndexCount);
+        device.SetDepthWrite(true);
+        RenderStats& stats = RenderStats::Get();
+        stats.mVertexArrayBinds++;
+        stats.mTextureBinds++;
+        stats.AddDraw(mIndexCount);
     }
 
 private:
     // 
-    vector<SimpleVertex> mVertices;
-    vector<unsigned int> mIndices;
-    unsigned int mTextureID;
+    uint mIndexCount = 0;
+    TextureHandle mTexture;
 
     // Ⱦ
-    unsigned int VAO, VBO, EBO;
+    VertexArrayHandle mVertexArray;
+    BufferHandle mVertexBuffer, mIndexBuffer;
+
+    void _release() {
+        GpuResources& resources = GpuResources::Get();
+        resources.Release(mVertexArray);
+        resources.Release(mVertexBuffer);
+        resources.Release(mIndexBuffer);
+        resources.Release(mTexture);
+    }
 };
 
+// ֻƶܸƣʱͷGPU壬ƻظͷţҲڲ临ݶ
 class Mesh {
 public:
 
     static SkyBoxMesh CreateSkyBox(const string& textureFolderPath);
-    static Mesh CreateCube(float lengthOfSide, const string& texturePath);
-    static Mesh CreatePlane(float lengthOfSide, glm::vec3& norm, const string& texturePath);
+    static Mesh CreateCube(float lengthOfSide, const string& texturePath, MeshResidency residency = MeshResidency::gpuOnly);
+    static Mesh CreatePlane(float lengthOfSide, const glm::vec3& norm, const string& texturePath, MeshResidency residency = MeshResidency::gpuOnly);
+    static Mesh CreateSphere(float radius, uint rings, uint segments, const string& texturePath, MeshResidency residency = MeshResidency::gpuOnly);
 
-    // 
-    vector<Vertex> mVertices;
-    vector<unsigned int> mIndices;
+    // ɴ߹ModelֻãԹһ
     vector<Texture> mTextures;
 
     // 
     Mesh() = default;
-    Mesh(const vector<Vertex>& vertices, const vector<uint>& indices, const vector<Texture>& textures);
+    Mesh(vector<Vertex> vertices, vector<uint> indices, vector<Texture> textures, MeshResidency residency = MeshResidency::gpuOnly);
+    ~Mesh() { _release(); }
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+    Mesh(Mesh&& other) noexcept { *this = std::move(other); }
+    Mesh& operator=(Mesh&& other) noexcept;
+
     void Draw(const Shader &shader);
+    // ¼У˳󶨵0ſʼԪ
+    void Record(CommandBuffer& commandBuffer) const;
+
+    // CPUϵĶgpuOnlyϴΪ
+    const vector<Vertex>& GetVertices() const { return mVertices; }
+    const vector<uint>& GetIndices() const { return mIndices; }
+    MeshResidency GetResidency() const { return mResidency; }
+    // ͷCPUϵݣ֮ΪgpuOnly
+    void ReleaseCpuData();
+
+    // preset
+    void SetSamplerPreset(SamplerPreset preset);
+
+    uint GetIndexCount() const { return mIndexCount; }
+    // ģͿռİΧУϴʱ㣬ͷCPUݺȻ
+    const glm::vec3& GetBoundsMin() const { return mBoundsMin; }
+    const glm::vec3& GetBoundsMax() const { return mBoundsMax; }
 private:
+    // 
+    vector<Vertex> mVertices;
+    vector<unsigned int> mIndices;
+    MeshResidency mResidency = MeshResidency::gpuOnly;
+    uint mIndexCount = 0;
+    glm::vec3 mBoundsMin = glm::vec3(0.0f);
+    glm::vec3 mBoundsMax = glm::vec3(0.0f);
+
     // Ⱦ
-    unsigned int VAO, VBO, EBO;
+    VertexArrayHandle mVertexArray;
+    BufferHandle mVertexBuffer, mIndexBuffer;
+    // ÿӦĲuniformmaterial.texture_diffuseNʱ
+    vector<UniformId> mTextureUniforms;
+    // ÿĲʱ豸ȡ
+    vector<std::uint32_t> mTextureSamplers;
     // 
     void _setupMesh();
+    void _release();
 };
 
 SkyBoxMesh Mesh::CreateSkyBox(const string& textureFolderPath) {
@@ -204,7 +268,7 @@ SkyBoxMesh Mesh::CreateSkyBox(const string& textureFolderPath) {
         3,  2,  6,  6,  7,  3, // +Y
     };
 
-    assert(textureFolderPath.length() > 0, "sky box need a texture!");
+    assert(textureFolderPath.length() > 0 && "sky box need a texture!");
 
     vector<std::string> faces;
     faces.emplace_back(textureFolderPath + "/right.jpg");
@@ -214,17 +278,19 @@ SkyBoxMesh Mesh::CreateSkyBox(const string& textureFolderPath) {
     faces.emplace_back(textureFolderPath + "/front.jpg");
     faces.emplace_back(textureFolderPath + "/back.jpg");
 
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+    RenderDevice& device = RenderDevice::Get();
+    unsigned int textureID = device.CreateTextureCube();
+    std::int64_t textureBytes = 0;
 
     int width, height, nrChannels;
     for (unsigned int i = 0; i < faces.size(); i++)
     {
-        unsigned char* data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
+        unsigned char* data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 3);
         if (data)
         {
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+            device.SetTextureCubeFace(textureID, i, width, height, 3, data);
+            RenderStats::Get().AddTextureUpload(static_cast<std::uint64_t>(width) * height * 3);
+            textureBytes += static_cast<std::int64_t>(width) * height * 3;
             stbi_image_free(data);
         }
         else
@@ -233,16 +299,11 @@ SkyBoxMesh Mesh::CreateSkyBox(const string& textureFolderPath) {
             stbi_image_free(data);
         }
     }
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
-    return SkyBoxMesh(vertices, indices, textureID);
+    return SkyBoxMesh(vertices, indices, GpuResources::Get().Add<GpuResourceType::texture>(textureID, textureBytes, textureFolderPath));
 }
 
-Mesh Mesh::CreateCube(float lengthOfSide, const string& texturePath) {
+Mesh Mesh::CreateCube(float lengthOfSide, const string& texturePath, MeshResidency residency) {
     if (lengthOfSide <= 0.0f) {
         return Mesh();
     }
@@ -299,13 +360,13 @@ Mesh Mesh::CreateCube(float lengthOfSide, const string& texturePath) {
     vector<Texture> textures;
 
     if (texturePath.length() > 0) {
-        textures.emplace_back(TextureFromFile(texturePath.c_str()), "texture_diffuse", texturePath.c_str());
+        textures.emplace_back(LoadTexture(texturePath.c_str()), "texture_diffuse", texturePath.c_str());
     }
 
-    return Mesh(vertices, indices, textures);
+    return Mesh(std::move(vertices), std::move(indices), std::move(textures), residency);
 }
 
-Mesh Mesh::CreatePlane(float lengthOfSide, glm::vec3& norm, const string& texturePath) {
+Mesh Mesh::CreatePlane(float lengthOfSide, const glm::vec3& norm, const string& texturePath, MeshResidency residency) {
     if (lengthOfSide <= 0.0f) {
         return Mesh();
     }
@@ -338,69 +399,188 @@ Mesh Mesh::CreatePlane(float lengthOfSide, glm::vec3& norm, const string& textur
     vector<Texture> textures;
 
     if (texturePath.length() > 0) {
-        textures.emplace_back(TextureFromFile(texturePath.c_str()), "texture_diffuse", texturePath.c_str());
+        textures.emplace_back(LoadTexture(texturePath.c_str()), "texture_diffuse", texturePath.c_str());
+    }
+
+    return Mesh(std::move(vertices), std::move(indices), std::move(textures), residency);
+}
+
+Mesh Mesh::CreateSphere(float radius, uint rings, uint segments, const string& texturePath, MeshResidency residency) {
+    if (radius <= 0.0f || rings < 2 || segments < 3) {
+        return Mesh();
+    }
+
+    // γÿһȦβһ㣬֤
+    vector<Vertex> vertices;
+    for (uint i = 0; i <= rings; i++) {
+        float theta = glm::pi<float>() * i / rings;
+        for (uint j = 0; j <= segments; j++) {
+            float phi = 2.0f * glm::pi<float>() * j / segments;
+            glm::vec3 normal(glm::sin(theta) * glm::cos(phi), glm::cos(theta), glm::sin(theta) * glm::sin(phi));
+            vertices.emplace_back(normal.x * radius, normal.y * radius, normal.z * radius,
+                normal.x, normal.y, normal.z,
+                static_cast<float>(j) / segments, 1.0f - static_cast<float>(i) / rings);
+        }
+    }
+
+    // 濴ʱΪ
+    vector<uint> indices;
+    for (uint i = 0; i < rings; i++) {
+        for (uint j = 0; j < segments; j++) {
+            uint current = i * (segments + 1) + j;
+            uint below = current + segments + 1;
+            indices.insert(indices.end(), { current, current + 1, below });
+            indices.insert(indices.end(), { current + 1, below + 1, below });
+        }
+    }
+
+    vector<Texture> textures;
+
+    if (texturePath.length() > 0) {
+        textures.emplace_back(LoadTexture(texturePath.c_str()), "texture_diffuse", texturePath.c_str());
     }
 
-    return Mesh(vertices, indices, textures);
+    return Mesh(std::move(vertices), std::move(indices), std::move(textures), residency);
 }
 
-Mesh::Mesh(const vector<Vertex> &vertices, const vector<uint> &indices, const vector<Texture> &textures):
-    mVertices(vertices),
-    mIndices(indices),
-    mTextures(textures) {
+Mesh::Mesh(vector<Vertex> vertices, vector<uint> indices, vector<Texture> textures, MeshResidency residency):
+    mTextures(std::move(textures)),
+    mVertices(std::move(vertices)),
+    mIndices(std::move(indices)),
+    mResidency(residency) {
     _setupMesh();
+    if (mResidency == MeshResidency::gpuOnly) {
+        ReleaseCpuData();
+    }
+}
+
+Mesh& Mesh::operator=(Mesh&& other) noexcept
+{
+    if (this != &other) {
+        _release();
+        mTextures = std::move(other.mTextures);
+        mVertices = std::move(other.mVertices);
+        mIndices = std::move(other.mIndices);
+        mResidency = other.mResidency;
+        mIndexCount = other.mIndexCount;
+        mBoundsMin = other.mBoundsMin;
+        mBoundsMax = other.mBoundsMax;
+        mVertexArray = other.mVertexArray;
+        mVertexBuffer = other.mVertexBuffer;
+        mIndexBuffer = other.mIndexBuffer;
+        mTextureUniforms = std::move(other.mTextureUniforms);
+        mTextureSamplers = std::move(other.mTextureSamplers);
+        other.mIndexCount = 0;
+        other.mVertexArray = {};
+        other.mVertexBuffer = other.mIndexBuffer = {};
+    }
+    return *this;
+}
+
+void Mesh::ReleaseCpuData()
+{
+    // swap黹ڴ棬clearֻıС
+    vector<Vertex>().swap(mVertices);
+    vector<unsigned int>().swap(mIndices);
+    mResidency = MeshResidency::gpuOnly;
+}
+
+void Mesh::SetSamplerPreset(SamplerPreset preset)
+{
+    RenderDevice& device = RenderDevice::Get();
+    for (uint i = 0; i < mTextures.size(); i++)
+    {
+        mTextures[i].sampler = preset;
+        mTextureSamplers[i] = device.GetSampler(GetSamplerPresetDesc(preset));
+    }
 }
 
 void Mesh::Draw(const Shader &shader)
 {
+    RenderDevice& device = RenderDevice::Get();
+    GpuResources& resources = GpuResources::Get();
+    for (uint i = 0; i < mTextures.size(); i++)
+    {
+        shader.setInt(mTextureUniforms[i], i); // OpenGLÿĸԪ
+        device.BindTexture(i, DeviceTextureType::texture2D, resources.Resolve(mTextures[i].handle), mTextureSamplers[i]);  // ӦԪ
+    }
+
+    // 
+    device.BindVertexArray(resources.Resolve(mVertexArray));
+    device.DrawIndexed(mIndexCount);
+    device.BindVertexArray(0);
+
+    RenderStats& stats = RenderStats::Get();
+    stats.mTextureBinds += mTextures.size();
+    stats.mVertexArrayBinds++;
+    stats.AddDraw(mIndexCount);
+}
+
+void Mesh::Record(CommandBuffer& commandBuffer) const
+{
+    GpuResources& resources = GpuResources::Get();
+    for (uint i = 0; i < mTextures.size(); i++)
+    {
+        commandBuffer.BindTexture(i, resources.Resolve(mTextures[i].handle), mTextureSamplers[i]);
+    }
+    commandBuffer.BindVertexArray(resources.Resolve(mVertexArray));
+    commandBuffer.DrawIndexed(mIndexCount);
+}
+
+void Mesh::_setupMesh()
+{
+    // ȡţdiffuse_textureN е N
     uint diffuseNr = 1;
     uint specularNr = 1;
-    for (uint i = 0; i < mTextures.size(); i++)
+    mTextureUniforms.clear();
+    mTextureSamplers.clear();
+    RenderDevice& device = RenderDevice::Get();
+    for (auto&& texture : mTextures)
     {
-        glActiveTexture(GL_TEXTURE0 + i); // ڰ֮ǰӦԪ
-        // ȡţdiffuse_textureN е N
-        string number;
-        string name = mTextures[i].type;
-        if (name == "texture_diffuse")
+        mTextureSamplers.push_back(device.GetSampler(GetSamplerPresetDesc(texture.sampler)));
+        string name = "material." + texture.type;
+        if (texture.type == "texture_diffuse")
         {
-            number = to_string(diffuseNr++);
+            name += to_string(diffuseNr++);
         }
-        else if (name == "texture_specular")
+        else if (texture.type == "texture_specular")
         {
-            number = to_string(specularNr++);
+            name += to_string(specularNr++);
         }
+        mTextureUniforms.emplace_back(name.c_str());
+    }
 
-        shader.setInt(("material." + name + number).c_str(), i); // OpenGLÿĸԪ
-        glBindTexture(GL_TEXTURE_2D, mTextures[i].id);  // ǰԪ
+    // ΧкͷCPU֮Ҫ
+    mIndexCount = static_cast<uint>(mIndices.size());
+    if (!mVertices.empty()) {
+        mBoundsMin = mBoundsMax = mVertices[0].Position;
+        for (auto&& vertex : mVertices) {
+            mBoundsMin = glm::min(mBoundsMin, vertex.Position);
+            mBoundsMax = glm::max(mBoundsMax, vertex.Position);
+        }
     }
-    glActiveTexture(GL_TEXTURE0);
 
-    // 
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, mIndices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    GpuResources& resources = GpuResources::Get();
+    std::int64_t vertexBytes = mVertices.size() * sizeof(Vertex);
+    std::int64_t indexBytes = mIndices.size() * sizeof(unsigned int);
+    uint vertexBuffer = device.CreateBuffer(DeviceBufferType::vertex, vertexBytes, mVertices.data(), false);
+    uint indexBuffer = device.CreateBuffer(DeviceBufferType::index, indexBytes, mIndices.data(), false);
+    RenderStats::Get().AddBufferUpload(vertexBytes + indexBytes);
+    uint vertexArray = device.CreateVertexArray(vertexBuffer, indexBuffer, {
+        { 0, 3, sizeof(Vertex), 0 },                                    // λ
+        { 1, 3, sizeof(Vertex), offsetof(Vertex, Normal) },             // 㷨
+        { 2, 2, sizeof(Vertex), offsetof(Vertex, TexCoords) },          // 
+    });
+    mVertexBuffer = resources.Add<GpuResourceType::buffer>(vertexBuffer, vertexBytes, "Mesh vertices");
+    mIndexBuffer = resources.Add<GpuResourceType::buffer>(indexBuffer, indexBytes, "Mesh indices");
+    mVertexArray = resources.Add<GpuResourceType::vertexArray>(vertexArray, 0, "Mesh");
 }
 
-void Mesh::_setupMesh()
+void Mesh::_release()
 {
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, mVertices.size() * sizeof(Vertex), &mVertices[0], GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIndices.size() * sizeof(unsigned int), &mIndices[0], GL_STATIC_DRAW);
-    // λ
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-    // 㷨
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
-    // 
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
-
-    glBindVertexArray(0);
+    // ﲻͷ
+    GpuResources& resources = GpuResources::Get();
+    resources.Release(mVertexArray);
+    resources.Release(mVertexBuffer);
+    resources.Release(mIndexBuffer);
 }
@@ -2,6 +2,8 @@
 
 #include <iostream>
 #include <mylib/mesh.h>
+#include <mylib/transform.h>
+#include <mylib/profiler.h>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -10,87 +12,221 @@
 #include <map>
 
 
+// ÿϴObjectBlockеݣshader_4_batch.vsеĲ(std140)һ
+struct ObjectUniforms
+{
+    glm::mat4 mModel;
+    glm::mat4 mNormalMatrix;
+};
+
 class Model
 {
 public:
-    Model(const char* path) { _loadModel(path); }
-    Model(Mesh& mesh) {
+    // ĬֻGPUݣҪCPUϷʶʱʰȡײcpuRetained
+    Model(const char* path, MeshResidency residency = MeshResidency::gpuOnly) : mResidency(residency) { _loadModel(path); }
+    // ģ͹
+    Model(Mesh&& mesh) {
+        for (auto&& texture : mesh.mTextures) {
+            mStoredTextures.emplace(texture.path.C_Str(), texture);
+        }
         mMeshes.emplace_back(std::move(mesh));
+        mMeshNodes.push_back(mNodes.AddNode(TransformHierarchy::kNoParent));
+        mNodes.Update();
+        _updateBounds();
     }
+    ~Model();
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+    Model(Model&&) = default;
 
     void SetLightParameters(Shader& objectShader, LightParameters& lightParams);
     void UpdateLightParam(Shader& objectShader, ModelRenderParam& modelRenderParam);
     void Draw(Shader &shader, ModelRenderParam& modelRenderParam);
+    // ¼ÿı任ͻprogramɵ߼¼
+    void Record(CommandBuffer& commandBuffer, const glm::mat4& modelTransMat) const;
+
+    // preset
+    void SetSamplerPreset(SamplerPreset preset);
+
+    // ģڲĽڵ㼶޸ĺһDrawʱ
+    TransformHierarchy& GetNodes() { return mNodes; }
+
+    // ʱİΧmodelTransMatΪģͱ任õռİΧ
+    void GetWorldBounds(const glm::mat4& modelTransMat, glm::vec3& center, float& radius) const;
+    // ΧĻϵĴСһ֡ҪȣviewportHeightΪӿڸ߶ȣأ
+    void RequestTextures(TextureStreamer& streamer, const ModelRenderParam& modelRenderParam, float viewportHeight) const;
 
 private:
-    map<string, Texture> mStoredTextures;  // мع
+    map<string, Texture> mStoredTextures;  // мعģʱͷ
     vector<Mesh> mMeshes;
+    vector<uint> mMeshNodes;  // ÿĽڵ
+    TransformHierarchy mNodes;  // еĽڵ㼶aiNodeı任
     string mDirectory;  // ģļڵ·
+    glm::vec3 mBoundsCenter = glm::vec3(0.0f);  // ģͿռİΧ
+    float mBoundsRadius = 0.0f;
+    MeshResidency mResidency = MeshResidency::gpuOnly;
 
     void _loadModel(const string &path);
-    void _processNode(aiNode* node, const aiScene* scene);
+    uint _processNode(aiNode* node, const aiScene* scene, int parent);
     Mesh _processMesh(aiMesh* mesh, const aiScene* scene);
     vector<Texture> _loadMaterialTextures(aiMaterial* mat, aiTextureType type, string typeName);
+    void _updateBounds();
 };
 
+Model::~Model()
+{
+    for (auto&& stored : mStoredTextures) {
+        GpuResources::Get().Release(stored.second.handle);
+    }
+}
+
 void Model::SetLightParameters(Shader& objectShader, LightParameters& lightParams) {
     objectShader.use();
-    objectShader.setInt("material.diffuse", lightParams.mMaterial.mDiffuse);
-    objectShader.setInt("material.specular", lightParams.mMaterial.mSpecular);
-    objectShader.setFloat("material.shininess", lightParams.mMaterial.mShininess);
+    objectShader.setInt("material.diffuse"_uid, lightParams.mMaterial.mDiffuse);
+    objectShader.setInt("material.specular"_uid, lightParams.mMaterial.mSpecular);
+    objectShader.setFloat("material.shininess"_uid, lightParams.mMaterial.mShininess);
     
-    objectShader.setVec3("dirLight.direction", lightParams.mDirectLight.mDirection);
-    objectShader.setVec3("dirLight.ambient", lightParams.mDirectLight.mAmbient);
-    objectShader.setVec3("dirLight.diffuse", lightParams.mDirectLight.mDiffuse);
-    objectShader.setVec3("dirLight.specular", lightParams.mDirectLight.mSpecular);
+    objectShader.setVec3("dirLight.direction"_uid, lightParams.mDirectLight.mDirection);
+    objectShader.setVec3("dirLight.ambient"_uid, lightParams.mDirectLight.mAmbient);
+    objectShader.setVec3("dirLight.diffuse"_uid, lightParams.mDirectLight.mDiffuse);
+    objectShader.setVec3("dirLight.specular"_uid, lightParams.mDirectLight.mSpecular);
     
-    objectShader.setVec3("spotLight.position", lightParams.mSpotLight.mPosition);
-    objectShader.setVec3("spotLight.direction", lightParams.mSpotLight.mDirection);
-    objectShader.setVec3("spotLight.ambient", lightParams.mSpotLight.mAmbient);
-    objectShader.setVec3("spotLight.diffuse", lightParams.mSpotLight.mDiffuse);
-    objectShader.setVec3("spotLight.specular", lightParams.mSpotLight.mSpecular);
-    objectShader.setFloat("spotLight.constant", lightParams.mSpotLight.mConstant);
-    objectShader.setFloat("spotLight.linear", lightParams.mSpotLight.mLinear);
-    objectShader.setFloat("spotLight.quadratic", lightParams.mSpotLight.mQuadratic);
-    objectShader.setFloat("spotLight.cutOff", lightParams.mSpotLight.mCutOff);
-    objectShader.setFloat("spotLight.outerCutOff", lightParams.mSpotLight.mOuterCutOff);
+    objectShader.setVec3("spotLight.position"_uid, lightParams.mSpotLight.mPosition);
+    objectShader.setVec3("spotLight.direction"_uid, lightParams.mSpotLight.mDirection);
+    objectShader.setVec3("spotLight.ambient"_uid, lightParams.mSpotLight.mAmbient);
+    objectShader.setVec3("spotLight.diffuse"_uid, lightParams.mSpotLight.mDiffuse);
+    objectShader.setVec3("spotLight.specular"_uid, lightParams.mSpotLight.mSpecular);
+    objectShader.setFloat("spotLight.constant"_uid, lightParams.mSpotLight.mConstant);
+    objectShader.setFloat("spotLight.linear"_uid, lightParams.mSpotLight.mLinear);
+    objectShader.setFloat("spotLight.quadratic"_uid, lightParams.mSpotLight.mQuadratic);
+    objectShader.setFloat("spotLight.cutOff"_uid, lightParams.mSpotLight.mCutOff);
+    objectShader.setFloat("spotLight.outerCutOff"_uid, lightParams.mSpotLight.mOuterCutOff);
 
+    using PointUniforms = LightParameters::PointLightUniforms;
     for (int i = 0; i < lightParams.mPointLights.size(); i++) {
         auto&& pointLight = lightParams.mPointLights[i];
-        std::string pointName = "pointLights[" + to_string(i) + "]";
-        objectShader.setVec3(pointName + ".position", pointLight.mPosition);
-        objectShader.setFloat(pointName + ".constant", pointLight.mConstant);
-        objectShader.setFloat(pointName + ".linear", pointLight.mLinear);
-        objectShader.setFloat(pointName + ".quadratic", pointLight.mQuadratic);
-        objectShader.setVec3(pointName + ".ambient", pointLight.mAmbient);
-        objectShader.setVec3(pointName + ".diffuse", pointLight.mDiffuse);
-        objectShader.setVec3(pointName + ".specular", pointLight.mSpecular);
-    }
-    objectShader.setInt("pointLightCount", lightParams.mPointLights.size());
+        objectShader.setVec3(PointUniforms::kPosition[i], pointLight.mPosition);
+        objectShader.setFloat(PointUniforms::kConstant[i], pointLight.mConstant);
+        objectShader.setFloat(PointUniforms::kLinear[i], pointLight.mLinear);
+        objectShader.setFloat(PointUniforms::kQuadratic[i], pointLight.mQuadratic);
+        objectShader.setVec3(PointUniforms::kAmbient[i], pointLight.mAmbient);
+        objectShader.setVec3(PointUniforms::kDiffuse[i], pointLight.mDiffuse);
+        objectShader.setVec3(PointUniforms::kSpecular[i], pointLight.mSpecular);
+    }
+    objectShader.setInt("pointLightCount"_uid, lightParams.mPointLights.size());
 }
 
 void Model::UpdateLightParam(Shader& objectShader, ModelRenderParam& modelRenderParam) {
-    objectShader.setVec3("viewPos", modelRenderParam.mCameraPos);
-    objectShader.setVec3("spotLight.position", modelRenderParam.mCameraPos);
-    objectShader.setVec3("spotLight.direction", modelRenderParam.mCameraDir);
+    objectShader.setVec3("viewPos"_uid, modelRenderParam.mCameraPos);
+    objectShader.setVec3("spotLight.position"_uid, modelRenderParam.mCameraPos);
+    objectShader.setVec3("spotLight.direction"_uid, modelRenderParam.mCameraDir);
 }
 
 void Model::Draw(Shader &shader, ModelRenderParam& modelRenderParam)
 {
     // 
     shader.use();
-    shader.setMat4("view", modelRenderParam.mViewMat);
-    shader.setMat4("projection", modelRenderParam.mProjMat);
-    shader.setMat4("model", modelRenderParam.mModelTransMat);
+    shader.setMat4("view"_uid, modelRenderParam.mViewMat);
+    shader.setMat4("projection"_uid, modelRenderParam.mProjMat);
+
+    // ֻнڵ仯ʱҪmodel
+    mNodes.Update();
+    uint currentNode = ~0u;
+    for (uint i = 0; i < mMeshes.size(); i++)
+    {
+        if (mMeshNodes[i] != currentNode)
+        {
+            currentNode = mMeshNodes[i];
+            shader.setMat4("model"_uid, modelRenderParam.mModelTransMat * mNodes.GetWorldMatrix(currentNode));
+        }
+        mMeshes[i].Draw(shader);
+    }
+}
+
+void Model::Record(CommandBuffer& commandBuffer, const glm::mat4& modelTransMat) const
+{
+    // ¼ʱڹ߳ϣԲ½ڵ㼶
+    uint currentNode = ~0u;
+    for (uint i = 0; i < mMeshes.size(); i++)
+    {
+        if (mMeshNodes[i] != currentNode)
+        {
+            currentNode = mMeshNodes[i];
+            ObjectUniforms uniforms;
+            uniforms.mModel = modelTransMat * mNodes.GetWorldMatrix(currentNode);
+            uniforms.mNormalMatrix = glm::mat4(glm::transpose(glm::inverse(glm::mat3(uniforms.mModel))));
+            commandBuffer.SetUniformBlock(0, uniforms);
+        }
+        mMeshes[i].Record(commandBuffer);
+    }
+}
+
+void Model::GetWorldBounds(const glm::mat4& modelTransMat, glm::vec3& center, float& radius) const
+{
+    center = glm::vec3(modelTransMat * glm::vec4(mBoundsCenter, 1.0f));
+    // Ǿʱȡ
+    float scale = std::max(std::max(glm::length(glm::vec3(modelTransMat[0])), glm::length(glm::vec3(modelTransMat[1]))),
+        glm::length(glm::vec3(modelTransMat[2])));
+    radius = mBoundsRadius * scale;
+}
 
-    for (Mesh mesh : mMeshes)
+void Model::SetSamplerPreset(SamplerPreset preset)
+{
+    for (auto&& mesh : mMeshes)
+    {
+        mesh.SetSamplerPreset(preset);
+    }
+}
+
+void Model::RequestTextures(TextureStreamer& streamer, const ModelRenderParam& modelRenderParam, float viewportHeight) const
+{
+    glm::vec3 center;
+    float radius;
+    GetWorldBounds(modelRenderParam.mModelTransMat, center, radius);
+    float screenSize = TextureStreamer::CalcScreenSize(center, radius, modelRenderParam.mViewMat, modelRenderParam.mProjMat, viewportHeight);
+    for (auto&& mesh : mMeshes)
+    {
+        for (auto&& texture : mesh.mTextures)
+        {
+            streamer.Request(texture.handle, screenSize);
+        }
+    }
+}
+
+void Model::_updateBounds()
+{
+    // Χе8ڽڵ任İΧУȡΧе
+    // Ѿͷ˶ݣԼİΧУڵתʱ𶥵Դ
+    glm::vec3 boundsMin(std::numeric_limits<float>::max());
+    glm::vec3 boundsMax(-std::numeric_limits<float>::max());
+    for (uint i = 0; i < mMeshes.size(); i++)
     {
-        mesh.Draw(shader);
+        if (mMeshes[i].GetIndexCount() == 0)
+        {
+            continue;
+        }
+        const glm::mat4& world = mNodes.GetWorldMatrix(mMeshNodes[i]);
+        const glm::vec3& meshMin = mMeshes[i].GetBoundsMin();
+        const glm::vec3& meshMax = mMeshes[i].GetBoundsMax();
+        for (int corner = 0; corner < 8; corner++)
+        {
+            glm::vec3 local((corner & 1) ? meshMax.x : meshMin.x, (corner & 2) ? meshMax.y : meshMin.y, (corner & 4) ? meshMax.z : meshMin.z);
+            glm::vec3 position = glm::vec3(world * glm::vec4(local, 1.0f));
+            boundsMin = glm::min(boundsMin, position);
+            boundsMax = glm::max(boundsMax, position);
+        }
     }
+    if (boundsMin.x > boundsMax.x) {
+        return;
+    }
+    mBoundsCenter = (boundsMin + boundsMax) * 0.5f;
+    mBoundsRadius = glm::length(boundsMax - mBoundsCenter);
 }
 
 void Model::_loadModel(const string &path)
 {
+    PROFILE_SCOPE("Model load");
+
     Assimp::Importer import;
     const aiScene* scene = import.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
 
@@ -101,21 +237,39 @@ void Model::_loadModel(const string &path)
     }
     mDirectory = path.substr(0, path.find_last_of('/'));
 
-    _processNode(scene->mRootNode, scene);
+    // 㴦ڵ㣬֤ڵӽڵ֮ǰ
+    vector<pair<aiNode*, int>> nodes = { { scene->mRootNode, TransformHierarchy::kNoParent } };
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        aiNode* node = nodes[i].first;
+        uint nodeIndex = _processNode(node, scene, nodes[i].second);
+        for (uint j = 0; j < node->mNumChildren; j++)
+        {
+            nodes.emplace_back(node->mChildren[j], nodeIndex);
+        }
+    }
+    mNodes.Update();
+    _updateBounds();
 }
 
-void Model::_processNode(aiNode* node, const aiScene* scene)
+uint Model::_processNode(aiNode* node, const aiScene* scene, int parent)
 {
+    // ڵľֲ任
+    aiVector3D scaling, position;
+    aiQuaternion rotation;
+    node->mTransformation.Decompose(scaling, rotation, position);
+    uint nodeIndex = mNodes.AddNode(parent,
+        glm::vec3(position.x, position.y, position.z),
+        glm::quat(rotation.w, rotation.x, rotation.y, rotation.z),
+        glm::vec3(scaling.x, scaling.y, scaling.z));
+
     for (uint i = 0; i < node->mNumMeshes; i++)
     {
         aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
         mMeshes.push_back(_processMesh(mesh, scene));
+        mMeshNodes.push_back(nodeIndex);
     }
-
-    for (uint i = 0; i < node->mNumChildren; i++)
-    {
-        _processNode(node->mChildren[i], scene);
-    }
+    return nodeIndex;
 }
 
 Mesh Model::_processMesh(aiMesh* mesh, const aiScene* scene)
@@ -123,6 +277,8 @@ Mesh Model::_processMesh(aiMesh* mesh, const aiScene* scene)
     vector<Vertex> vertices;
     vector<uint> indices;
     vector<Texture> textures;
+    vertices.reserve(mesh->mNumVertices);
+    indices.reserve(mesh->mNumFaces * 3);
 
     // λáߺ
     for (uint i = 0; i < mesh->mNumVertices; i++)
@@ -162,7 +318,7 @@ Mesh Model::_processMesh(aiMesh* mesh, const aiScene* scene)
         textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
     }
 
-    return Mesh(vertices, indices, textures);
+    return Mesh(std::move(vertices), std::move(indices), std::move(textures), mResidency);
 }
 
 vector<Texture> Model::_loadMaterialTextures(aiMaterial* mat, aiTextureType type, string typeName)
@@ -177,7 +333,7 @@ vector<Texture> Model::_loadMaterialTextures(aiMaterial* mat, aiTextureType type
         if (res == mStoredTextures.end())
         {
             Texture texture;
-            texture.id = TextureFromFile(str.C_Str(), mDirectory.c_str());
+            texture.handle = LoadTexture(str.C_Str(), mDirectory.c_str());
             texture.type = typeName;
             texture.path = str;
             textures.push_back(texture);
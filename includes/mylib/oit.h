@@ -0,0 +1,85 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <iostream>
+#include <mylib/shader_s.h>
+#include <mylib/render_target.h>
+
+
+// Ȩ˳޹͸Weighted Blended OIT
+// ͸һλƵۻĿȨĿϣٺϳɵ͸Ľ
+// GL3.3ûglBlendFunciĿ깲һglBlendFuncSeparate
+//   ۻĿ rgb += color * alpha * w  (GL_ONE, GL_ONE)
+//   ۻĿ a   *= (1 - alpha)        (GL_ZERO, GL_ONE_MINUS_SRC_ALPHA)͸revealage
+//   ȨĿ r   += alpha * w          (GL_ONE, GL_ONE)
+class OITFrameBuffer {
+public:
+    // ۻĿȨĿÿλʱӶȡϳɺ黹
+    OITFrameBuffer(RenderTargetPool& pool) : mPool(pool) {}
+
+    // ʼ͸壺ۻĿ겢û״̬
+    // 벻͸干ģ建壬͸Ȼᱻ͸ڵ
+    void BeginTransparent(RenderTarget* depthStencil);
+    // ͸壺ָĬϵдͻϷʽ
+    void EndTransparent();
+    // ͸ĽϳɵtargetFBOϣquadVAOΪȫı
+    void Composite(Shader& compositeShader, unsigned int quadVAO, unsigned int targetFBO);
+
+private:
+    RenderTargetPool& mPool;
+    RenderTarget* mAccumTarget = nullptr;  // RGBA16FrgbΪȨɫͣaΪ͸ʣҪʽ֤ۼӵľ
+    RenderTarget* mWeightTarget = nullptr;  // R16FȨغ
+};
+
+void OITFrameBuffer::BeginTransparent(RenderTarget* depthStencil)
+{
+    mAccumTarget = mPool.Acquire(RenderTargetDesc(GL_RGBA16F, depthStencil->mWidth, depthStencil->mHeight));
+    mWeightTarget = mPool.Acquire(RenderTargetDesc(GL_R16F, depthStencil->mWidth, depthStencil->mHeight));
+    glBindFramebuffer(GL_FRAMEBUFFER, mPool.GetFramebuffer({ mAccumTarget, mWeightTarget }, depthStencil));
+    glViewport(0, 0, depthStencil->mWidth, depthStencil->mHeight);
+
+    // ۻĿΪ(0,0,0,1)͸ʳʼΪ1ȨĿΪ0
+    const float accumClear[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    const float weightClear[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    glClearBufferfv(GL_COLOR, 0, accumClear);
+    glClearBufferfv(GL_COLOR, 1, weightClear);
+
+    // ֻȲԲдȣ͸֮䲻ڵ
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void OITFrameBuffer::EndTransparent()
+{
+    glDepthMask(GL_TRUE);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void OITFrameBuffer::Composite(Shader& compositeShader, unsigned int quadVAO, unsigned int targetFBO)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFBO);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    compositeShader.use();
+    compositeShader.setInt("accumTexture"_uid, 0);
+    compositeShader.setInt("weightTexture"_uid, 1);
+    // ͨ豸󶨣ͬʱЩԪϵĲ
+    RenderDevice& device = RenderDevice::Get();
+    device.BindTexture(0, DeviceTextureType::texture2D, mAccumTarget->mTexture);
+    device.BindTexture(1, DeviceTextureType::texture2D, mWeightTarget->mTexture);
+
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+
+    glEnable(GL_DEPTH_TEST);
+
+    mPool.Release(mAccumTarget);
+    mPool.Release(mWeightTarget);
+    mAccumTarget = mWeightTarget = nullptr;
+}
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <mylib/shader_s.h>
+#include <mylib/render_target.h>
+
+
+// Ч
+//   Ч grayscale / invert / tonemap ֻǰأϲڵľpassУдĻ
+//   edgeΪ3x3˹ˣɷ룬һpass
+//   gaussianBlurΪɷĸ˹ˣɺһάpassڵһ˫Բ
+enum class PostEffectType { grayscale, invert, tonemap, edge, gaussianBlur };
+
+
+// 
+// ˳ЧBuildЧϲɾٵpassɶӦshader
+//   һ֮ǰЧھÿϼ㣬Чһpassǰ
+//   ûоʱЧϲһpassֻдһĻ
+// мӶȡpass֮佻ʹãһpassֱдĿ֡
+class PostChain {
+public:
+    PostChain(RenderTargetPool& pool) : mPool(pool) {}
+
+    PostChain& Grayscale() { return _add(PostEffectType::grayscale, 0.0f); }
+    PostChain& Invert() { return _add(PostEffectType::invert, 0.0f); }
+    // ָɫӳ䣬1 - exp(-color * exposure)
+    PostChain& Tonemap(float exposure) { return _add(PostEffectType::tonemap, exposure); }
+    PostChain& Edge() { return _add(PostEffectType::edge, 0.0f); }
+    // ˰뾶Ϊ3sigma
+    PostChain& GaussianBlur(float sigma) { return _add(PostEffectType::gaussianBlur, sigma); }
+
+    void Build();
+    // sourceTextureȡдtargetFBOquadVAOΪȫı
+    void Apply(unsigned int sourceTexture, int width, int height, unsigned int quadVAO,
+        unsigned int targetFBO, int targetWidth, int targetHeight);
+
+    std::size_t GetPassCount() const { return mPasses.size(); }
+    const std::string& GetFragmentSource(std::size_t pass) const { return mPasses[pass].mSource; }
+    // ЧpassĻ֣ "grayscale blur | blur invert"
+    std::string GetDescription() const;
+
+private:
+    struct Effect
+    {
+        PostEffectType mType;
+        float mParam;
+    };
+
+    struct Pass
+    {
+        std::vector<int> mPreOps;   // ÿϼЧ
+        int mKernel = -1;           // Ч-1ʱֱӸ
+        int mBlurAxis = 0;          // 0Ϊ1Ϊ
+        std::vector<int> mPostOps;  // ǰЧ
+        std::string mSource;
+    };
+
+    RenderTargetPool& mPool;
+    std::vector<Effect> mEffects;
+    std::vector<Pass> mPasses;
+    std::vector<Shader> mShaders;
+
+    PostChain& _add(PostEffectType type, float param);
+    bool _isPerPixel(int effect) const;
+    std::string _generate(const Pass& pass) const;
+    std::string _ops(const std::vector<int>& ops) const;
+    static std::string _literal(float value);
+};
+
+// ȫıεĶɫshader_4_buffer_1.vsͬ
+const char* const kPostChainVertexSource =
+    "#version 330 core\n"
+    "layout (location = 0) in vec2 aPos;\n"
+    "layout (location = 1) in vec2 aTexCoords;\n"
+    "out vec2 TexCoords;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_Position = vec4(aPos.x, aPos.y, 0.0, 1.0);\n"
+    "    TexCoords = aTexCoords;\n"
+    "}\n";
+
+PostChain& PostChain::_add(PostEffectType type, float param)
+{
+    mEffects.push_back({ type, param });
+    return *this;
+}
+
+bool PostChain::_isPerPixel(int effect) const
+{
+    PostEffectType type = mEffects[effect].mType;
+    return type == PostEffectType::grayscale || type == PostEffectType::invert || type == PostEffectType::tonemap;
+}
+
+void PostChain::Build()
+{
+    mPasses.clear();
+    std::vector<int> pending;
+    for (int i = 0; i < static_cast<int>(mEffects.size()); i++) {
+        if (_isPerPixel(i)) {
+            pending.push_back(i);
+            continue;
+        }
+
+        // ֮ǰЧһڲʱ㣬ϲһpass
+        Pass pass;
+        pass.mKernel = i;
+        if (mPasses.empty()) {
+            pass.mPreOps = pending;
+        }
+        else {
+            mPasses.back().mPostOps.insert(mPasses.back().mPostOps.end(), pending.begin(), pending.end());
+        }
+        pending.clear();
+
+        mPasses.push_back(pass);
+        if (mEffects[i].mType == PostEffectType::gaussianBlur) {
+            Pass vertical;
+            vertical.mKernel = i;
+            vertical.mBlurAxis = 1;
+            mPasses.push_back(vertical);
+        }
+    }
+    if (mPasses.empty()) {
+        mPasses.emplace_back();
+    }
+    mPasses.back().mPostOps.insert(mPasses.back().mPostOps.end(), pending.begin(), pending.end());
+
+    // ɵprogramһ֡Χ֮ɾ
+    mShaders.clear();
+    for (auto&& pass : mPasses) {
+        pass.mSource = _generate(pass);
+        mShaders.push_back(Shader::FromSource(kPostChainVertexSource, pass.mSource));
+    }
+}
+
+std::string PostChain::_literal(float value)
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(7) << value;
+    return out.str();
+}
+
+std::string PostChain::_ops(const std::vector<int>& ops) const
+{
+    std::string code;
+    for (int op : ops) {
+        switch (mEffects[op].mType)
+        {
+        case PostEffectType::grayscale:
+            code += "    c = vec3(dot(c, vec3(0.2126, 0.7152, 0.0722)));\n";
+            break;
+        case PostEffectType::invert:
+            code += "    c = vec3(1.0) - c;\n";
+            break;
+        case PostEffectType::tonemap:
+            code += "    c = vec3(1.0) - exp(-c * " + _literal(mEffects[op].mParam) + ");\n";
+            break;
+        default:
+            break;
+        }
+    }
+    return code;
+}
+
+std::string PostChain::_generate(const Pass& pass) const
+{
+    std::ostringstream fs;
+    fs << "#version 330 core\n"
+        << "out vec4 FragColor;\n"
+        << "in vec2 TexCoords;\n"
+        << "uniform sampler2D screenTexture;\n\n"
+        << "vec3 preOps(vec3 c)\n{\n" << _ops(pass.mPreOps) << "    return c;\n}\n\n"
+        << "vec3 postOps(vec3 c)\n{\n" << _ops(pass.mPostOps) << "    return c;\n}\n\n"
+        << "vec3 fetch(vec2 uv)\n{\n    return preOps(texture(screenTexture, uv).rgb);\n}\n\n"
+        << "void main()\n{\n";
+
+    PostEffectType kernel = pass.mKernel < 0 ? PostEffectType::grayscale : mEffects[pass.mKernel].mType;
+    if (pass.mKernel < 0) {
+        fs << "    vec3 color = fetch(TexCoords);\n";
+    }
+    else if (kernel == PostEffectType::edge) {
+        // ƫΪλֱ޹
+        fs << "    vec3 color = vec3(0.0);\n";
+        for (int y = 1; y >= -1; y--) {
+            for (int x = -1; x <= 1; x++) {
+                const char* weight = (x == 0 && y == 0) ? "-8.0" : "1.0";
+                fs << "    color += " << weight << " * preOps(textureOffset(screenTexture, TexCoords, ivec2("
+                    << x << ", " << y << ")).rgb);\n";
+            }
+        }
+    }
+    else {
+        float sigma = std::max(mEffects[pass.mKernel].mParam, 0.1f);
+        int radius = static_cast<int>(std::ceil(3.0f * sigma));
+        std::vector<float> weights(radius + 1);
+        float sum = 0.0f;
+        for (int i = 0; i <= radius; i++) {
+            weights[i] = std::exp(-0.5f * i * i / (sigma * sigma));
+            sum += i == 0 ? weights[i] : 2.0f * weights[i];
+        }
+        for (auto&& weight : weights) {
+            weight /= sum;
+        }
+
+        // ϲһ˫ԲԵЧÿϵ㣬ʱϲ
+        bool merge = true;
+        for (int op : pass.mPreOps) {
+            merge = merge && mEffects[op].mType != PostEffectType::tonemap;
+        }
+        std::vector<float> tapOffsets(1, 0.0f);
+        std::vector<float> tapWeights(1, weights[0]);
+        for (int i = 1; i <= radius; i += merge ? 2 : 1) {
+            if (!merge || i == radius) {
+                tapOffsets.push_back(static_cast<float>(i));
+                tapWeights.push_back(weights[i]);
+            }
+            else {
+                float weight = weights[i] + weights[i + 1];
+                tapOffsets.push_back((i * weights[i] + (i + 1) * weights[i + 1]) / weight);
+                tapWeights.push_back(weight);
+            }
+        }
+
+        std::size_t taps = tapOffsets.size();
+        fs << "    const float offsets[" << taps << "] = float[](";
+        for (std::size_t i = 0; i < taps; i++) {
+            fs << (i ? ", " : "") << _literal(tapOffsets[i]);
+        }
+        fs << ");\n    const float weights[" << taps << "] = float[](";
+        for (std::size_t i = 0; i < taps; i++) {
+            fs << (i ? ", " : "") << _literal(tapWeights[i]);
+        }
+        fs << ");\n"
+            << "    vec2 texel = " << (pass.mBlurAxis == 0 ? "vec2(1.0, 0.0)" : "vec2(0.0, 1.0)")
+            << " / vec2(textureSize(screenTexture, 0));\n"
+            << "    vec3 color = fetch(TexCoords) * weights[0];\n"
+            << "    for (int i = 1; i < " << taps << "; i++) {\n"
+            << "        color += (fetch(TexCoords + texel * offsets[i]) + fetch(TexCoords - texel * offsets[i])) * weights[i];\n"
+            << "    }\n";
+    }
+    fs << "    FragColor = vec4(postOps(color), 1.0);\n}\n";
+    return fs.str();
+}
+
+void PostChain::Apply(unsigned int sourceTexture, int width, int height, unsigned int quadVAO,
+    unsigned int targetFBO, int targetWidth, int targetHeight)
+{
+    if (mPasses.empty()) {
+        Build();
+    }
+
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    GLboolean blend = glIsEnabled(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(quadVAO);
+
+    unsigned int input = sourceTexture;
+    RenderTarget* inputTarget = nullptr;
+    for (std::size_t i = 0; i < mPasses.size(); i++) {
+        RenderTarget* outputTarget = nullptr;
+        if (i + 1 == mPasses.size()) {
+            glBindFramebuffer(GL_FRAMEBUFFER, targetFBO);
+            glViewport(0, 0, targetWidth, targetHeight);
+        }
+        else {
+            outputTarget = mPool.Acquire(RenderTargetDesc(GL_RGBA8, width, height));
+            glBindFramebuffer(GL_FRAMEBUFFER, mPool.GetFramebuffer({ outputTarget }, nullptr));
+            glViewport(0, 0, width, height);
+        }
+
+        mShaders[i].use();
+        mShaders[i].setInt("screenTexture"_uid, 0);
+        RenderDevice::Get().BindTexture(0, DeviceTextureType::texture2D, input);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+
+        // pass֮ʹãһpass֮мԸ
+        mPool.Release(inputTarget);
+        inputTarget = outputTarget;
+        input = outputTarget ? outputTarget->mTexture : 0;
+    }
+
+    glBindVertexArray(0);
+    if (depthTest) {
+        glEnable(GL_DEPTH_TEST);
+    }
+    if (blend) {
+        glEnable(GL_BLEND);
+    }
+}
+
+std::string PostChain::GetDescription() const
+{
+    static const char* effectNames[] = { "grayscale", "invert", "tonemap", "edge", "blur" };
+    std::ostringstream out;
+    for (std::size_t i = 0; i < mPasses.size(); i++) {
+        const Pass& pass = mPasses[i];
+        out << (i ? " | " : "");
+        for (int op : pass.mPreOps) {
+            out << effectNames[static_cast<int>(mEffects[op].mType)] << " ";
+        }
+        out << (pass.mKernel < 0 ? "copy" : effectNames[static_cast<int>(mEffects[pass.mKernel].mType)]);
+        for (int op : pass.mPostOps) {
+            out << " " << effectNames[static_cast<int>(mEffects[op].mType)];
+        }
+    }
+    return out.str();
+}
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+// һʱ䣬ʱΪ룬ֱַ
+struct ProfileEvent
+{
+    const char* mName;
+    std::uint64_t mBegin;
+    std::uint64_t mEnd;
+    std::uint32_t mThread;  // 0ΪGPUCPU̴߳1ʼ
+};
+
+
+// CPUGPUķֶμʱ
+// CPUÿ̵߳һμ¼ʱעһλ壬ֻ֮߳д룬д벻
+// GPUĿʼͽ¼һGL_TIMESTAMPѯѯúŶȡͨ֡CPUȴGPU
+// ÿ֡һCollectռѾɵ䣬ԵΪChrome tracechrome://tracingPerfettoʱķλ
+class Profiler
+{
+public:
+    // ʱ
+    static const std::size_t kMaxTraceEvents = 200000;
+    // ÿͳƷλʱ
+    static const std::size_t kMaxSamples = 256;
+
+    static Profiler& Get()
+    {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    // ӵһεÿʼ
+    static std::uint64_t Now()
+    {
+        static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+
+    // õǰ߳traceʾ
+    void SetThreadName(const std::string& name);
+    void RecordCpu(const char* name, std::uint64_t begin, std::uint64_t end);
+
+    // ֻGL̵߳ãֵEndGpu
+    std::size_t BeginGpu(const char* name);
+    void EndGpu(std::size_t scope);
+
+    // ռ߳ѾѾɵGPUѯÿ֡һΣ䲻ܿε
+    void Collect();
+
+    void WriteChromeTrace(const std::string& path) const;
+    // ÿĴp50/p95/p99
+    void Report(std::ostream& out) const;
+
+private:
+    struct ThreadBuffer
+    {
+        static const std::size_t kCapacity = 16384;
+
+        ProfileEvent mEvents[kCapacity];
+        std::atomic<std::uint64_t> mWrite{ 0 };
+        std::uint64_t mRead = 0;  // ֻCollectʹ
+        std::uint32_t mThread;
+        std::string mName;
+    };
+
+    struct GpuScope
+    {
+        const char* mName;
+        unsigned int mBeginQuery;
+        unsigned int mEndQuery;
+    };
+
+    struct Samples
+    {
+        std::vector<float> mValues;
+        std::size_t mNext = 0;
+    };
+
+    mutable std::mutex mThreadsMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> mThreads;
+
+    std::vector<GpuScope> mGpuScopes;  // ύ˳Уȴȡ
+    std::vector<unsigned int> mFreeQueries;
+    bool mGpuCalibrated = false;
+    std::int64_t mGpuOffset = 0;  // CPUʱ - GPUʱ
+
+    std::deque<ProfileEvent> mTrace;
+    std::map<std::string, Samples> mSamples;
+    std::uint64_t mDroppedEvents = 0;
+
+    Profiler() = default;
+    ThreadBuffer& _threadBuffer();
+    unsigned int _allocQuery();
+    void _add(const ProfileEvent& event);
+};
+
+
+// CPU䣬ʱʼʱ
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* name) : mName(name), mBegin(Profiler::Now()) {}
+    ~ProfileScope() { Profiler::Get().RecordCpu(mName, mBegin, Profiler::Now()); }
+
+private:
+    const char* mName;
+    std::uint64_t mBegin;
+};
+
+// GPU䣬ʱGLвʱ
+class GpuProfileScope
+{
+public:
+    explicit GpuProfileScope(const char* name) : mScope(Profiler::Get().BeginGpu(name)) {}
+    ~GpuProfileScope() { Profiler::Get().EndGpu(mScope); }
+
+private:
+    std::size_t mScope;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+// ͳCPUʱ
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+// ͬʱͳCPUύʱGPUִкʱ
+#define GPU_PROFILE_SCOPE(name) PROFILE_SCOPE(name); GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(name)
+
+
+Profiler::ThreadBuffer& Profiler::_threadBuffer()
+{
+    static thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(mThreadsMutex);
+        mThreads.emplace_back(new ThreadBuffer());
+        buffer = mThreads.back().get();
+        buffer->mThread = static_cast<std::uint32_t>(mThreads.size());
+        buffer->mName = "thread " + std::to_string(buffer->mThread);
+    }
+    return *buffer;
+}
+
+void Profiler::SetThreadName(const std::string& name)
+{
+    ThreadBuffer& buffer = _threadBuffer();
+    std::lock_guard<std::mutex> lock(mThreadsMutex);
+    buffer.mName = name;
+}
+
+void Profiler::RecordCpu(const char* name, std::uint64_t begin, std::uint64_t end)
+{
+    ThreadBuffer& buffer = _threadBuffer();
+    std::uint64_t index = buffer.mWrite.load(std::memory_order_relaxed);
+    buffer.mEvents[index % ThreadBuffer::kCapacity] = { name, begin, end, buffer.mThread };
+    buffer.mWrite.store(index + 1, std::memory_order_release);
+}
+
+unsigned int Profiler::_allocQuery()
+{
+    if (mFreeQueries.empty()) {
+        unsigned int queries[32];
+        glGenQueries(32, queries);
+        mFreeQueries.insert(mFreeQueries.end(), queries, queries + 32);
+    }
+    unsigned int query = mFreeQueries.back();
+    mFreeQueries.pop_back();
+    return query;
+}
+
+std::size_t Profiler::BeginGpu(const char* name)
+{
+    // GPUʱCPUʱӵ㲻ͬһʹʱһ
+    if (!mGpuCalibrated) {
+        GLint64 gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        mGpuOffset = static_cast<std::int64_t>(Now()) - gpuNow;
+        mGpuCalibrated = true;
+    }
+
+    GpuScope scope = { name, _allocQuery(), _allocQuery() };
+    glQueryCounter(scope.mBeginQuery, GL_TIMESTAMP);
+    mGpuScopes.push_back(scope);
+    return mGpuScopes.size() - 1;
+}
+
+void Profiler::EndGpu(std::size_t scope)
+{
+    glQueryCounter(mGpuScopes[scope].mEndQuery, GL_TIMESTAMP);
+}
+
+void Profiler::_add(const ProfileEvent& event)
+{
+    mTrace.push_back(event);
+    if (mTrace.size() > kMaxTraceEvents) {
+        mTrace.pop_front();
+    }
+
+    std::string key = event.mThread == 0 ? std::string("GPU ") + event.mName : std::string(event.mName);
+    Samples& samples = mSamples[key];
+    float ms = static_cast<float>((event.mEnd - event.mBegin) * 1e-6);
+    if (samples.mValues.size() < kMaxSamples) {
+        samples.mValues.push_back(ms);
+    }
+    else {
+        samples.mValues[samples.mNext] = ms;
+        samples.mNext = (samples.mNext + 1) % kMaxSamples;
+    }
+}
+
+void Profiler::Collect()
+{
+    {
+        std::lock_guard<std::mutex> lock(mThreadsMutex);
+        for (auto&& buffer : mThreads) {
+            std::uint64_t end = buffer->mWrite.load(std::memory_order_acquire);
+            // ռ֮д볬ʱѾ
+            if (end - buffer->mRead > ThreadBuffer::kCapacity) {
+                mDroppedEvents += end - buffer->mRead - ThreadBuffer::kCapacity;
+                buffer->mRead = end - ThreadBuffer::kCapacity;
+            }
+            for (; buffer->mRead < end; buffer->mRead++) {
+                _add(buffer->mEvents[buffer->mRead % ThreadBuffer::kCapacity]);
+            }
+        }
+    }
+
+    // ύ˳ȡûɵĲѯֹͣ
+    std::size_t resolved = 0;
+    for (; resolved < mGpuScopes.size(); resolved++) {
+        GpuScope& scope = mGpuScopes[resolved];
+        GLint available = 0;
+        glGetQueryObjectiv(scope.mEndQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(scope.mBeginQuery, GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(scope.mEndQuery, GL_QUERY_RESULT, &end);
+        _add({ scope.mName, static_cast<std::uint64_t>(begin + mGpuOffset), static_cast<std::uint64_t>(end + mGpuOffset), 0 });
+        mFreeQueries.push_back(scope.mBeginQuery);
+        mFreeQueries.push_back(scope.mEndQuery);
+    }
+    mGpuScopes.erase(mGpuScopes.begin(), mGpuScopes.begin() + resolved);
+}
+
+void Profiler::WriteChromeTrace(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file) {
+        std::cout << "Failed to write profile: " << path << std::endl;
+        return;
+    }
+
+    // ʱ䵥λΪ΢
+    file << "{\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+    {
+        std::lock_guard<std::mutex> lock(mThreadsMutex);
+        for (auto&& buffer : mThreads) {
+            file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->mThread
+                << ",\"args\":{\"name\":\"" << buffer->mName << "\"}}";
+        }
+    }
+    file.setf(std::ios::fixed);
+    file.precision(3);
+    for (auto&& event : mTrace) {
+        file << ",\n{\"name\":\"" << event.mName << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.mThread
+            << ",\"ts\":" << event.mBegin * 1e-3 << ",\"dur\":" << (event.mEnd - event.mBegin) * 1e-3 << "}";
+    }
+    file << "\n]}\n";
+    std::cout << "Profile written to " << path << " (" << mTrace.size() << " events)" << std::endl;
+}
+
+void Profiler::Report(std::ostream& out) const
+{
+    out << "Profile (last " << kMaxSamples << " samples per scope, ms)";
+    if (mDroppedEvents > 0) {
+        out << ", " << mDroppedEvents << " events dropped";
+    }
+    out << std::endl;
+    for (auto&& item : mSamples) {
+        std::vector<float> values = item.second.mValues;
+        std::sort(values.begin(), values.end());
+        auto percentile = [&values](float p) {
+            return values[std::min(values.size() - 1, static_cast<std::size_t>(p * values.size()))];
+        };
+        out << "  " << item.first << ": n " << values.size()
+            << ", p50 " << percentile(0.5f) << ", p95 " << percentile(0.95f) << ", p99 " << percentile(0.99f) << std::endl;
+    }
+}
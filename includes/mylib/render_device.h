@@ -0,0 +1,838 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// gladûмظԹչչöֵͬ
+#ifndef GL_TEXTURE_MAX_ANISOTROPY_EXT
+#define GL_TEXTURE_MAX_ANISOTROPY_EXT 0x84FE
+#define GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT 0x84FF
+#endif
+
+
+// ͼAPI֮Ϻܱһ㣬MeshSkyBoxMeshShaderCommandReplayerֻͨԴύ
+// ֱuint32GL˾GL֣CommandBufferȼ¼ĵطø
+// ԴȨӳɾGpuResourcesйgpu_resources.hDelete*ɾ
+// GLÿӦһGLãԪϵĲ״̬棻պֻͼ¼ҪGL
+enum class DeviceBufferType : std::uint8_t { vertex, index, uniform };
+enum class DeviceTextureType : std::uint8_t { texture2D, cubeMap, texture2DArray };
+enum class UniformType : std::uint8_t { int1, float1, float2, float3, float4, mat2, mat3, mat4 };
+
+inline std::uint32_t GetUniformTypeSize(UniformType type)
+{
+    static const std::uint32_t sizes[] = { 4, 4, 8, 12, 16, 16, 36, 64 };
+    return sizes[static_cast<int>(type)];
+}
+
+// ˷ʽƷʽ͸ԣͬĲ豸ֻһ
+// trilinearmip֮ҲֵmMaxAnisotropy1ʱʹøԹˣ֧ʱ
+enum class SamplerFilter : std::uint8_t { nearest, linear, trilinear };
+enum class SamplerWrap : std::uint8_t { clampToEdge, repeat, mirroredRepeat };
+
+struct SamplerDesc
+{
+    SamplerFilter mFilter = SamplerFilter::trilinear;
+    SamplerWrap mWrap = SamplerWrap::clampToEdge;
+    float mMaxAnisotropy = 1.0f;
+
+    bool operator<(const SamplerDesc& other) const
+    {
+        if (mFilter != other.mFilter) {
+            return mFilter < other.mFilter;
+        }
+        if (mWrap != other.mWrap) {
+            return mWrap < other.mWrap;
+        }
+        return mMaxAnisotropy < other.mMaxAnisotropy;
+    }
+};
+
+// ѡõĲԤ裬бı棨ذ塢棩ø
+enum class SamplerPreset : std::uint8_t { linearClamp, trilinearClamp, trilinearRepeat, anisotropicClamp, anisotropicRepeat };
+
+inline SamplerDesc GetSamplerPresetDesc(SamplerPreset preset)
+{
+    switch (preset)
+    {
+    case SamplerPreset::linearClamp:
+        return { SamplerFilter::linear, SamplerWrap::clampToEdge, 1.0f };
+    case SamplerPreset::trilinearRepeat:
+        return { SamplerFilter::trilinear, SamplerWrap::repeat, 1.0f };
+    case SamplerPreset::anisotropicClamp:
+        return { SamplerFilter::trilinear, SamplerWrap::clampToEdge, 16.0f };
+    case SamplerPreset::anisotropicRepeat:
+        return { SamplerFilter::trilinear, SamplerWrap::repeat, 16.0f };
+    default:
+        return { SamplerFilter::trilinear, SamplerWrap::clampToEdge, 1.0f };
+    }
+}
+
+// ԣfloat
+struct VertexAttribute
+{
+    std::uint32_t mIndex;
+    std::uint32_t mComponents;
+    std::uint32_t mStride;
+    std::uint32_t mOffset;
+};
+
+// Ӻprogramеuniform
+struct DeviceUniform
+{
+    std::string mName;
+    int mLocation;
+};
+
+// 豸õ࣬պ˰
+enum class DeviceCall : std::uint8_t
+{
+    createBuffer,
+    updateBuffer,
+    createVertexArray,
+    createTexture,
+    updateTexture,
+    createProgram,
+    createSampler,
+    deleteObject,
+    fence,
+    getUniformLocation,
+    setUniform,
+    bindProgram,
+    bindVertexArray,
+    bindTexture,
+    bindUniformBuffer,
+    setState,
+    clear,
+    drawIndexed,
+    count,
+};
+
+inline const char* GetDeviceCallName(DeviceCall call)
+{
+    static const char* names[] = {
+        "createBuffer", "updateBuffer", "createVertexArray", "createTexture", "updateTexture", "createProgram",
+        "createSampler", "deleteObject", "fence", "getUniformLocation", "setUniform", "bindProgram", "bindVertexArray", "bindTexture", "bindUniformBuffer",
+        "setState", "clear", "drawIndexed",
+    };
+    return call < DeviceCall::count ? names[static_cast<int>(call)] : "unknown";
+}
+
+
+class RenderDevice
+{
+public:
+    virtual ~RenderDevice() = default;
+
+    // ǰʹõ豸ĬΪGL
+    static RenderDevice& Get() { return *_current(); }
+    // nullptrָΪGLˣ豸ɵ߹
+    static void Set(RenderDevice* device);
+
+    // պûGLģGLĹܣѯ֡ȣҪ
+    virtual bool IsNull() const = 0;
+    virtual std::uint32_t GetUniformBufferAlignment() = 0;
+
+    // 壬dataΪ
+    virtual std::uint32_t CreateBuffer(DeviceBufferType type, std::size_t size, const void* data, bool dynamic) = 0;
+    // ·仺壬ݶÿ֡µĻ
+    virtual void SetBufferData(std::uint32_t buffer, DeviceBufferType type, std::size_t size, const void* data) = 0;
+    virtual void UpdateBuffer(std::uint32_t buffer, DeviceBufferType type, std::size_t offset, std::size_t size, const void* data) = 0;
+    virtual std::uint32_t CreateVertexArray(std::uint32_t vertexBuffer, std::uint32_t indexBuffer, const std::vector<VertexAttribute>& attributes) = 0;
+    // ɾͶ飬Ϊ0ʱʲô
+    virtual void DeleteBuffer(std::uint32_t buffer) = 0;
+    virtual void DeleteVertexArray(std::uint32_t vertexArray) = 0;
+
+    // channelsΪ134dataΪʱϴ0mipmipڴʱȷ
+    // dataΪʱֻ֮SetTextureLevelϴ
+    // ԼĲΪCLAMP_TO_EDGEԹˣֻûа󶨲ʱʹ
+    virtual std::uint32_t CreateTexture2D(int width, int height, int channels, const void* data) = 0;
+    virtual std::uint32_t CreateTextureCube() = 0;
+    // faceΪ05˳Ϊ+X-X+Y-Y+Z-Z
+    virtual void SetTextureCubeFace(std::uint32_t texture, int face, int width, int height, int channels, const void* data) = 0;
+    // 2DһmipΪ0ʱͷһа1ֽڶ
+    virtual void SetTextureLevel(std::uint32_t texture, int level, int width, int height, int channels, const void* data) = 0;
+    // ֻ[baseLevel, maxLevel]֮mipΧ֮ļԲ
+    virtual void SetTextureLevelRange(std::uint32_t texture, int baseLevel, int maxLevel) = 0;
+    virtual void DeleteTexture(std::uint32_t texture) = 0;
+    // ͬͬһ豸йҪɾ
+    std::uint32_t GetSampler(const SamplerDesc& desc);
+
+    // ʧʱϢȻprogram
+    virtual std::uint32_t CreateProgram(const char* vertexCode, const char* fragmentCode) = 0;
+    virtual void DeleteProgram(std::uint32_t program) = 0;
+    virtual int GetUniformLocation(std::uint32_t program, const char* name) = 0;
+    // ӺλõuniformÿԪصг±0Ԫͬ
+    // պûбshaderؿ
+    virtual std::vector<DeviceUniform> GetActiveUniforms(std::uint32_t program) = 0;
+    // õǰprogramuniform
+    virtual void SetUniform(int location, UniformType type, const void* data) = 0;
+
+    virtual void BindProgram(std::uint32_t program) = 0;
+    virtual void BindVertexArray(std::uint32_t vertexArray) = 0;
+    // 󶨺ǰԪΪ0samplerΪ0ʱʹԼĲ
+    virtual void BindTexture(std::uint32_t unit, DeviceTextureType type, std::uint32_t texture, std::uint32_t sampler = 0) = 0;
+    virtual void BindUniformBuffer(std::uint32_t binding, std::uint32_t buffer, std::size_t offset, std::size_t size) = 0;
+
+    // ״̬
+    virtual void SetDepthTest(bool enabled) = 0;
+    virtual void SetDepthWrite(bool enabled) = 0;
+    virtual void SetBlend(bool enabled) = 0;
+    virtual void SetCullFace(bool enabled) = 0;
+
+    // ɫȺģ
+    virtual void Clear(float r, float g, float b, float a) = 0;
+    virtual void DrawIndexed(std::uint32_t indexCount) = 0;
+
+    // ĵǰλòΧ
+    virtual std::uint32_t CreateFence() = 0;
+    // Χ֮ǰִʱtrueͷΧtimeoutΪ0ʱֻѯȴ
+    virtual bool WaitFence(std::uint32_t fence, std::uint64_t timeoutNanoseconds) = 0;
+
+protected:
+    virtual std::uint32_t _createSampler(const SamplerDesc& desc) = 0;
+
+private:
+    std::map<SamplerDesc, std::uint32_t> mSamplers;
+
+    static RenderDevice& _glDevice();
+    static RenderDevice*& _current();
+};
+
+
+// ֱӵGL
+class GLRenderDevice : public RenderDevice
+{
+public:
+    bool IsNull() const override { return false; }
+    std::uint32_t GetUniformBufferAlignment() override;
+
+    std::uint32_t CreateBuffer(DeviceBufferType type, std::size_t size, const void* data, bool dynamic) override;
+    void SetBufferData(std::uint32_t buffer, DeviceBufferType type, std::size_t size, const void* data) override;
+    void UpdateBuffer(std::uint32_t buffer, DeviceBufferType type, std::size_t offset, std::size_t size, const void* data) override;
+    std::uint32_t CreateVertexArray(std::uint32_t vertexBuffer, std::uint32_t indexBuffer, const std::vector<VertexAttribute>& attributes) override;
+    void DeleteBuffer(std::uint32_t buffer) override { glDeleteBuffers(1, &buffer); }
+    void DeleteVertexArray(std::uint32_t vertexArray) override { glDeleteVertexArrays(1, &vertexArray); }
+
+    std::uint32_t CreateTexture2D(int width, int height, int channels, const void* data) override;
+    std::uint32_t CreateTextureCube() override;
+    void SetTextureCubeFace(std::uint32_t texture, int face, int width, int height, int channels, const void* data) override;
+    void SetTextureLevel(std::uint32_t texture, int level, int width, int height, int channels, const void* data) override;
+    void SetTextureLevelRange(std::uint32_t texture, int baseLevel, int maxLevel) override;
+    void DeleteTexture(std::uint32_t texture) override { glDeleteTextures(1, &texture); }
+
+    std::uint32_t CreateProgram(const char* vertexCode, const char* fragmentCode) override;
+    void DeleteProgram(std::uint32_t program) override { glDeleteProgram(program); }
+    int GetUniformLocation(std::uint32_t program, const char* name) override { return glGetUniformLocation(program, name); }
+    std::vector<DeviceUniform> GetActiveUniforms(std::uint32_t program) override;
+    void SetUniform(int location, UniformType type, const void* data) override;
+
+    void BindProgram(std::uint32_t program) override { glUseProgram(program); }
+    void BindVertexArray(std::uint32_t vertexArray) override { glBindVertexArray(vertexArray); }
+    void BindTexture(std::uint32_t unit, DeviceTextureType type, std::uint32_t texture, std::uint32_t sampler) override;
+    void BindUniformBuffer(std::uint32_t binding, std::uint32_t buffer, std::size_t offset, std::size_t size) override
+    {
+        glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, offset, size);
+    }
+
+    void SetDepthTest(bool enabled) override { enabled ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST); }
+    void SetDepthWrite(bool enabled) override { glDepthMask(enabled ? GL_TRUE : GL_FALSE); }
+    void SetBlend(bool enabled) override { enabled ? glEnable(GL_BLEND) : glDisable(GL_BLEND); }
+    void SetCullFace(bool enabled) override { enabled ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE); }
+
+    void Clear(float r, float g, float b, float a) override
+    {
+        glClearColor(r, g, b, a);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    }
+    void DrawIndexed(std::uint32_t indexCount) override { glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0); }
+
+    std::uint32_t CreateFence() override;
+    bool WaitFence(std::uint32_t fence, std::uint64_t timeoutNanoseconds) override;
+
+protected:
+    std::uint32_t _createSampler(const SamplerDesc& desc) override;
+
+private:
+    // ÿԪϰ󶨵Ĳ󲿷󶨲ò¼ÿζ°0
+    static const int kSamplerUnits = 16;
+    std::uint32_t mBoundSamplers[kSamplerUnits] = {};
+    float mMaxAnisotropy = -1.0f;  // ֵ֧ԣ-1Ϊûвѯ
+    // 塢ÿһʱȡ
+    static const int kNameBatch = 16;
+    std::vector<GLuint> mBufferNames;
+    std::vector<GLuint> mVertexArrayNames;
+    std::vector<GLuint> mTextureNames;
+    std::map<std::uint32_t, GLsync> mFences;
+    std::uint32_t mNextFence = 0;
+
+    static GLuint _takeName(std::vector<GLuint>& names, PFNGLGENBUFFERSPROC generate);
+    static GLenum _getTarget(DeviceBufferType type);
+    static GLenum _getTextureTarget(DeviceTextureType type);
+    static GLenum _getFormat(int channels);
+    float _getMaxAnisotropy();
+    static void _checkCompileErrors(unsigned int shader, const std::string& type);
+};
+
+
+// һ¼豸ãmHandleΪĶmValueΪԪuniformλõ
+struct DeviceCommand
+{
+    DeviceCall mCall;
+    std::uint32_t mHandle;
+    std::uint32_t mValue;
+    std::uint32_t mSampler;     // bindTextureͬʱ󶨵Ĳ0ΪʹĲΪ0
+};
+
+// պˣִκͼAPIãֻ¼ʱ
+// ŻԼύ·ҲûGLĵĻг
+class NullRenderDevice : public RenderDevice
+{
+public:
+    bool IsNull() const override { return true; }
+    std::uint32_t GetUniformBufferAlignment() override { return 256; }
+
+    // ¼ᱣÿֻʱڴ
+    void SetRecording(bool recording) { mRecording = recording; }
+    const std::vector<DeviceCommand>& GetCommands() const { return mCommands; }
+    std::uint64_t GetCallCount(DeviceCall call) const { return mCallCounts[static_cast<int>(call)]; }
+    std::uint64_t GetTotalCalls() const;
+    // ϴֽ
+    std::uint64_t GetUploadedBytes() const { return mUploadedBytes; }
+    // ռͼ¼ѷľ
+    void Reset();
+    void Print(std::ostream& out) const;
+
+    std::uint32_t CreateBuffer(DeviceBufferType /*type*/, std::size_t size, const void* data, bool /*dynamic*/) override
+    {
+        mUploadedBytes += data ? size : 0;
+        return _add(DeviceCall::createBuffer, ++mNextHandle, static_cast<std::uint32_t>(size));
+    }
+    void SetBufferData(std::uint32_t buffer, DeviceBufferType /*type*/, std::size_t size, const void* data) override
+    {
+        mUploadedBytes += data ? size : 0;
+        _add(DeviceCall::updateBuffer, buffer, static_cast<std::uint32_t>(size));
+    }
+    void UpdateBuffer(std::uint32_t buffer, DeviceBufferType /*type*/, std::size_t /*offset*/, std::size_t size, const void* /*data*/) override
+    {
+        mUploadedBytes += size;
+        _add(DeviceCall::updateBuffer, buffer, static_cast<std::uint32_t>(size));
+    }
+    std::uint32_t CreateVertexArray(std::uint32_t /*vertexBuffer*/, std::uint32_t /*indexBuffer*/, const std::vector<VertexAttribute>& attributes) override
+    {
+        return _add(DeviceCall::createVertexArray, ++mNextHandle, static_cast<std::uint32_t>(attributes.size()));
+    }
+    void DeleteBuffer(std::uint32_t buffer) override { _add(DeviceCall::deleteObject, buffer, 0); }
+    void DeleteVertexArray(std::uint32_t vertexArray) override { _add(DeviceCall::deleteObject, vertexArray, 0); }
+
+    std::uint32_t CreateTexture2D(int width, int height, int channels, const void* data) override
+    {
+        mUploadedBytes += data ? static_cast<std::uint64_t>(width) * height * channels : 0;
+        return _add(DeviceCall::createTexture, ++mNextHandle, 0);
+    }
+    std::uint32_t CreateTextureCube() override { return _add(DeviceCall::createTexture, ++mNextHandle, 0); }
+    void SetTextureCubeFace(std::uint32_t texture, int face, int width, int height, int channels, const void* data) override
+    {
+        mUploadedBytes += data ? static_cast<std::uint64_t>(width) * height * channels : 0;
+        _add(DeviceCall::updateTexture, texture, face);
+    }
+    void SetTextureLevel(std::uint32_t texture, int level, int width, int height, int channels, const void* data) override
+    {
+        mUploadedBytes += data ? static_cast<std::uint64_t>(width) * height * channels : 0;
+        _add(DeviceCall::updateTexture, texture, level);
+    }
+    void SetTextureLevelRange(std::uint32_t texture, int baseLevel, int /*maxLevel*/) override
+    {
+        _add(DeviceCall::updateTexture, texture, baseLevel);
+    }
+    void DeleteTexture(std::uint32_t texture) override { _add(DeviceCall::deleteObject, texture, 0); }
+
+    std::uint32_t CreateProgram(const char* /*vertexCode*/, const char* /*fragmentCode*/) override
+    {
+        return _add(DeviceCall::createProgram, ++mNextHandle, 0);
+    }
+    void DeleteProgram(std::uint32_t program) override { _add(DeviceCall::deleteObject, program, 0); }
+    // ÿprogramеֵһβѯʱλ
+    int GetUniformLocation(std::uint32_t program, const char* name) override;
+    std::vector<DeviceUniform> GetActiveUniforms(std::uint32_t /*program*/) override { return {}; }
+    void SetUniform(int location, UniformType /*type*/, const void* /*data*/) override { _add(DeviceCall::setUniform, mProgram, location); }
+
+    void BindProgram(std::uint32_t program) override { mProgram = program; _add(DeviceCall::bindProgram, program, 0); }
+    void BindVertexArray(std::uint32_t vertexArray) override { _add(DeviceCall::bindVertexArray, vertexArray, 0); }
+    void BindTexture(std::uint32_t unit, DeviceTextureType /*type*/, std::uint32_t texture, std::uint32_t sampler) override
+    {
+        _add(DeviceCall::bindTexture, texture, unit, sampler);
+    }
+    void BindUniformBuffer(std::uint32_t binding, std::uint32_t buffer, std::size_t /*offset*/, std::size_t /*size*/) override
+    {
+        _add(DeviceCall::bindUniformBuffer, buffer, binding);
+    }
+
+    void SetDepthTest(bool enabled) override { _add(DeviceCall::setState, 0, enabled); }
+    void SetDepthWrite(bool enabled) override { _add(DeviceCall::setState, 1, enabled); }
+    void SetBlend(bool enabled) override { _add(DeviceCall::setState, 2, enabled); }
+    void SetCullFace(bool enabled) override { _add(DeviceCall::setState, 3, enabled); }
+
+    void Clear(float /*r*/, float /*g*/, float /*b*/, float /*a*/) override { _add(DeviceCall::clear, 0, 0); }
+    void DrawIndexed(std::uint32_t indexCount) override { _add(DeviceCall::drawIndexed, 0, indexCount); }
+
+    // ûGPUΧѾͨ
+    std::uint32_t CreateFence() override { return _add(DeviceCall::fence, ++mNextHandle, 0); }
+    bool WaitFence(std::uint32_t /*fence*/, std::uint64_t /*timeoutNanoseconds*/) override { return true; }
+
+protected:
+    std::uint32_t _createSampler(const SamplerDesc& /*desc*/) override { return _add(DeviceCall::createSampler, ++mNextHandle, 0); }
+
+private:
+    bool mRecording = false;
+    std::vector<DeviceCommand> mCommands;
+    std::uint64_t mCallCounts[static_cast<int>(DeviceCall::count)] = {};
+    std::uint64_t mUploadedBytes = 0;
+    std::uint32_t mNextHandle = 0;
+    std::uint32_t mProgram = 0;
+    // ÿprogramuniformλãʱֱconst char*Ƚϣҵʱstd::string
+    std::map<std::uint32_t, std::map<std::string, int, std::less<>>> mUniformLocations;
+    int mUniformLocationCount = 0;
+
+    std::uint32_t _add(DeviceCall call, std::uint32_t handle, std::uint32_t value, std::uint32_t sampler = 0)
+    {
+        mCallCounts[static_cast<int>(call)]++;
+        if (mRecording) {
+            mCommands.push_back({ call, handle, value, sampler });
+        }
+        return handle;
+    }
+};
+
+
+RenderDevice& RenderDevice::_glDevice()
+{
+    static GLRenderDevice device;
+    return device;
+}
+
+RenderDevice*& RenderDevice::_current()
+{
+    static RenderDevice* device = &_glDevice();
+    return device;
+}
+
+void RenderDevice::Set(RenderDevice* device)
+{
+    _current() = device ? device : &_glDevice();
+}
+
+std::uint32_t RenderDevice::GetSampler(const SamplerDesc& desc)
+{
+    auto found = mSamplers.find(desc);
+    if (found != mSamplers.end()) {
+        return found->second;
+    }
+    std::uint32_t sampler = _createSampler(desc);
+    mSamplers.emplace(desc, sampler);
+    return sampler;
+}
+
+std::uint32_t GLRenderDevice::GetUniformBufferAlignment()
+{
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    return static_cast<std::uint32_t>(alignment);
+}
+
+GLuint GLRenderDevice::_takeName(std::vector<GLuint>& names, PFNGLGENBUFFERSPROC generate)
+{
+    if (names.empty()) {
+        names.resize(kNameBatch);
+        generate(kNameBatch, names.data());
+        // Ӻǰȡֺʱͬ˳
+        std::reverse(names.begin(), names.end());
+    }
+    GLuint name = names.back();
+    names.pop_back();
+    return name;
+}
+
+GLenum GLRenderDevice::_getTarget(DeviceBufferType type)
+{
+    switch (type)
+    {
+    case DeviceBufferType::vertex:
+        return GL_ARRAY_BUFFER;
+    case DeviceBufferType::index:
+        return GL_ELEMENT_ARRAY_BUFFER;
+    default:
+        return GL_UNIFORM_BUFFER;
+    }
+}
+
+GLenum GLRenderDevice::_getTextureTarget(DeviceTextureType type)
+{
+    switch (type)
+    {
+    case DeviceTextureType::cubeMap:
+        return GL_TEXTURE_CUBE_MAP;
+    case DeviceTextureType::texture2DArray:
+        return GL_TEXTURE_2D_ARRAY;
+    default:
+        return GL_TEXTURE_2D;
+    }
+}
+
+GLenum GLRenderDevice::_getFormat(int channels)
+{
+    switch (channels)
+    {
+    case 1:
+        return GL_RED;
+    case 3:
+        return GL_RGB;
+    case 4:
+        return GL_RGBA;
+    default:
+        std::cout << "Error on channels: " << channels << std::endl;
+        return GL_ZERO;
+    }
+}
+
+std::uint32_t GLRenderDevice::CreateBuffer(DeviceBufferType type, std::size_t size, const void* data, bool dynamic)
+{
+    // ʱ¼ǰVAOУǰȽ
+    if (type == DeviceBufferType::index) {
+        glBindVertexArray(0);
+    }
+    GLuint buffer = _takeName(mBufferNames, glGenBuffers);
+    glBindBuffer(_getTarget(type), buffer);
+    glBufferData(_getTarget(type), size, data, dynamic ? GL_STREAM_DRAW : GL_STATIC_DRAW);
+    return buffer;
+}
+
+void GLRenderDevice::SetBufferData(std::uint32_t buffer, DeviceBufferType type, std::size_t size, const void* data)
+{
+    glBindBuffer(_getTarget(type), buffer);
+    glBufferData(_getTarget(type), size, data, GL_STREAM_DRAW);
+}
+
+void GLRenderDevice::UpdateBuffer(std::uint32_t buffer, DeviceBufferType type, std::size_t offset, std::size_t size, const void* data)
+{
+    glBindBuffer(_getTarget(type), buffer);
+    glBufferSubData(_getTarget(type), offset, size, data);
+}
+
+std::uint32_t GLRenderDevice::CreateVertexArray(std::uint32_t vertexBuffer, std::uint32_t indexBuffer, const std::vector<VertexAttribute>& attributes)
+{
+    GLuint vertexArray = _takeName(mVertexArrayNames, glGenVertexArrays);
+    glBindVertexArray(vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    for (auto&& attribute : attributes) {
+        glEnableVertexAttribArray(attribute.mIndex);
+        glVertexAttribPointer(attribute.mIndex, attribute.mComponents, GL_FLOAT, GL_FALSE, attribute.mStride, (void*)(std::size_t)attribute.mOffset);
+    }
+    glBindVertexArray(0);
+    return vertexArray;
+}
+
+std::uint32_t GLRenderDevice::CreateTexture2D(int width, int height, int channels, const void* data)
+{
+    GLuint texture = _takeName(mTextureNames, glGenTextures);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if (data) {
+        // GL 3.3ûglTexStorage2DmipMAX_LEVEL̶mipӴ
+        int levelCount = 1;
+        while ((std::max(width, height) >> levelCount) > 0) {
+            levelCount++;
+        }
+        GLenum format = _getFormat(channels);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    // ƺ͹˷ʽãʱGetSamplerõĲ
+    return texture;
+}
+
+std::uint32_t GLRenderDevice::CreateTextureCube()
+{
+    GLuint texture = _takeName(mTextureNames, glGenTextures);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    return texture;
+}
+
+void GLRenderDevice::SetTextureCubeFace(std::uint32_t texture, int face, int width, int height, int channels, const void* data)
+{
+    GLenum format = _getFormat(channels);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+}
+
+void GLRenderDevice::SetTextureLevel(std::uint32_t texture, int level, int width, int height, int channels, const void* data)
+{
+    // СmipȲ4ıĬϵ4ֽڶ
+    GLenum format = _getFormat(channels);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, level, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void GLRenderDevice::SetTextureLevelRange(std::uint32_t texture, int baseLevel, int maxLevel)
+{
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, baseLevel);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+}
+
+std::uint32_t GLRenderDevice::CreateProgram(const char* vertexCode, const char* fragmentCode)
+{
+    // ɫ
+    unsigned int vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertex, 1, &vertexCode, NULL);
+    glCompileShader(vertex);
+    // ӡеĻ
+    _checkCompileErrors(vertex, "VERTEX");
+
+    // ƬɫҲ
+    unsigned int fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragment, 1, &fragmentCode, NULL);
+    glCompileShader(fragment);
+    _checkCompileErrors(fragment, "FRAGMENT");
+
+    // ɫ
+    unsigned int program = glCreateProgram();
+    glAttachShader(program, vertex);
+    glAttachShader(program, fragment);
+    glLinkProgram(program);
+    // ӡӴеĻ
+    _checkCompileErrors(program, "PROGRAM");
+
+    // ɾɫѾӵǵĳˣѾҪ
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+    return program;
+}
+
+std::vector<DeviceUniform> GLRenderDevice::GetActiveUniforms(std::uint32_t program)
+{
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<char> buffer(std::max(maxLength, 1));
+
+    std::vector<DeviceUniform> uniforms;
+    for (GLint i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(program, i, static_cast<GLsizei>(buffer.size()), &length, &size, &type, buffer.data());
+        std::string name(buffer.data(), length);
+        // uniform blockеuniformûλ
+        int location = glGetUniformLocation(program, name.c_str());
+        if (location < 0) {
+            continue;
+        }
+        if (name.size() < 3 || name.compare(name.size() - 3, 3, "[0]") != 0) {
+            uniforms.push_back({ name, location });
+            continue;
+        }
+
+        // ֻг0ԪأԪصλõѯ
+        std::string baseName = name.substr(0, name.size() - 3);
+        uniforms.push_back({ baseName, location });
+        uniforms.push_back({ name, location });
+        for (GLint element = 1; element < size; element++) {
+            std::string elementName = baseName + "[" + std::to_string(element) + "]";
+            uniforms.push_back({ elementName, glGetUniformLocation(program, elementName.c_str()) });
+        }
+    }
+    return uniforms;
+}
+
+void GLRenderDevice::SetUniform(int location, UniformType type, const void* data)
+{
+    const float* values = static_cast<const float*>(data);
+    switch (type)
+    {
+    case UniformType::int1:
+        glUniform1i(location, *static_cast<const int*>(data));
+        break;
+    case UniformType::float1:
+        glUniform1f(location, values[0]);
+        break;
+    case UniformType::float2:
+        glUniform2fv(location, 1, values);
+        break;
+    case UniformType::float3:
+        glUniform3fv(location, 1, values);
+        break;
+    case UniformType::float4:
+        glUniform4fv(location, 1, values);
+        break;
+    case UniformType::mat2:
+        glUniformMatrix2fv(location, 1, GL_FALSE, values);
+        break;
+    case UniformType::mat3:
+        glUniformMatrix3fv(location, 1, GL_FALSE, values);
+        break;
+    case UniformType::mat4:
+        glUniformMatrix4fv(location, 1, GL_FALSE, values);
+        break;
+    default:
+        break;
+    }
+}
+
+void GLRenderDevice::BindTexture(std::uint32_t unit, DeviceTextureType type, std::uint32_t texture, std::uint32_t sampler)
+{
+    // ԪϣҪлĵԪ
+    if (unit >= kSamplerUnits || mBoundSamplers[unit] != sampler) {
+        glBindSampler(unit, sampler);
+        if (unit < kSamplerUnits) {
+            mBoundSamplers[unit] = sampler;
+        }
+    }
+    GLenum target = _getTextureTarget(type);
+    if (unit == 0) {
+        glBindTexture(target, texture);
+        return;
+    }
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(target, texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+std::uint32_t GLRenderDevice::_createSampler(const SamplerDesc& desc)
+{
+    static const GLint wraps[] = { GL_CLAMP_TO_EDGE, GL_REPEAT, GL_MIRRORED_REPEAT };
+    static const GLint minFilters[] = { GL_NEAREST, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR };
+    GLuint sampler;
+    glGenSamplers(1, &sampler);
+    GLint wrap = wraps[static_cast<int>(desc.mWrap)];
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, wrap);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, wrap);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_R, wrap);
+    glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, minFilters[static_cast<int>(desc.mFilter)]);
+    glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, desc.mFilter == SamplerFilter::nearest ? GL_NEAREST : GL_LINEAR);
+    float anisotropy = std::min(desc.mMaxAnisotropy, _getMaxAnisotropy());
+    if (anisotropy > 1.0f) {
+        glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropy);
+    }
+    return sampler;
+}
+
+float GLRenderDevice::_getMaxAnisotropy()
+{
+    if (mMaxAnisotropy >= 0.0f) {
+        return mMaxAnisotropy;
+    }
+    // ԹGL 4.6֮ǰչgladûмֱӲչб
+    mMaxAnisotropy = 1.0f;
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++) {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (name && (std::strcmp(name, "GL_EXT_texture_filter_anisotropic") == 0 || std::strcmp(name, "GL_ARB_texture_filter_anisotropic") == 0)) {
+            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &mMaxAnisotropy);
+            break;
+        }
+    }
+    return mMaxAnisotropy;
+}
+
+std::uint32_t GLRenderDevice::CreateFence()
+{
+    mFences[++mNextFence] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    return mNextFence;
+}
+
+bool GLRenderDevice::WaitFence(std::uint32_t fence, std::uint64_t timeoutNanoseconds)
+{
+    auto found = mFences.find(fence);
+    if (found == mFences.end()) {
+        return true;
+    }
+    // ȴʱȰύGPUΧԶᵽ
+    GLenum result = glClientWaitSync(found->second, timeoutNanoseconds > 0 ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeoutNanoseconds);
+    if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+        return false;
+    }
+    glDeleteSync(found->second);
+    mFences.erase(found);
+    return true;
+}
+
+void GLRenderDevice::_checkCompileErrors(unsigned int shader, const std::string& type)
+{
+    int success;
+    char infoLog[1024];
+    if (type != "PROGRAM")
+    {
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (!success)
+        {
+            glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+            std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+        }
+    }
+    else
+    {
+        glGetProgramiv(shader, GL_LINK_STATUS, &success);
+        if (!success)
+        {
+            glGetProgramInfoLog(shader, 1024, NULL, infoLog);
+            std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+        }
+    }
+}
+
+
+int NullRenderDevice::GetUniformLocation(std::uint32_t program, const char* name)
+{
+    _add(DeviceCall::getUniformLocation, program, 0);
+    auto&& locations = mUniformLocations[program];
+    auto found = locations.find(name);
+    if (found != locations.end()) {
+        return found->second;
+    }
+    locations.emplace(name, mUniformLocationCount);
+    return mUniformLocationCount++;
+}
+
+std::uint64_t NullRenderDevice::GetTotalCalls() const
+{
+    std::uint64_t total = 0;
+    for (auto&& count : mCallCounts) {
+        total += count;
+    }
+    return total;
+}
+
+void NullRenderDevice::Reset()
+{
+    mCommands.clear();
+    std::fill(mCallCounts, mCallCounts + static_cast<int>(DeviceCall::count), 0);
+    mUploadedBytes = 0;
+}
+
+void NullRenderDevice::Print(std::ostream& out) const
+{
+    for (int i = 0; i < static_cast<int>(DeviceCall::count); i++) {
+        if (mCallCounts[i] > 0) {
+            out << GetDeviceCallName(static_cast<DeviceCall>(i)) << ": " << mCallCounts[i] << std::endl;
+        }
+    }
+    out << "total: " << GetTotalCalls() << ", uploaded bytes: " << mUploadedBytes << std::endl;
+}
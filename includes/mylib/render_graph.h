@@ -0,0 +1,466 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <mylib/render_target.h>
+#include <mylib/render_stats.h>
+
+
+// ȾͼԴľÿд붼õµİ汾֮passҪʹ¾
+// ֻһ֡Ч
+struct RenderGraphHandle
+{
+    int mIndex = -1;
+
+    bool IsValid() const { return mIndex >= 0; }
+};
+
+// passʼʱԭݵĴʽ
+//   load     ֮ǰpassдݣԴһαдʱûݿԱԶΪdontCare
+//   clear    Ϊֵָ
+//   dontCare passḲأҪ
+enum class RenderGraphLoadOp { load, clear, dontCare };
+
+class RenderGraph;
+
+// passʱʹã¼passдԴ
+class RenderGraphBuilder
+{
+public:
+    // Ϊ
+    RenderGraphHandle Read(RenderGraphHandle handle);
+    // Ϊɫȸд룬д°汾
+    // clearValueȸΪ(, ģ, 0, 0)
+    RenderGraphHandle Write(RenderGraphHandle handle, RenderGraphLoadOp loadOp = RenderGraphLoadOp::load,
+        const glm::vec4& clearValue = glm::vec4(0.0f));
+    // passʹҲ޳ضͳ
+    void SetSideEffect();
+
+private:
+    RenderGraph& mGraph;
+    int mPass;
+
+    RenderGraphBuilder(RenderGraph& graph, int pass) : mGraph(graph), mPass(pass) {}
+    friend class RenderGraph;
+};
+
+
+// ֡ͼÿ֡passԼǶдCompileExecute
+//   ޳ûԴĬ֡壩иõpasspassִ
+//   ˳passֻܶȡѾԴ汾˳һϷִ˳򣬰˳ִʣµpass
+//   passдĸϳ֡壬LoadOpգպͶδݵloadᱻȥ
+//   ʱԴһʹǰӶȡһʹú黹ڲصԴ˹
+class RenderGraph
+{
+public:
+    using SetupFunc = std::function<void(RenderGraphBuilder&)>;
+    using ExecuteFunc = std::function<void(const RenderGraph&)>;
+
+    RenderGraph(RenderTargetPool& pool) : mPool(pool) {}
+
+    // ÿ֡ʼʱһ֡passԴ
+    void Reset();
+
+    // ʱִֻͬڼ
+    RenderGraphHandle CreateTexture(const std::string& name, const RenderTargetDesc& desc);
+    // ⲿдpassᱻ޳
+    RenderGraphHandle ImportTexture(const std::string& name, RenderTarget* target);
+    // Ĭ֡壬ֻܵΪɫд
+    RenderGraphHandle ImportBackbuffer(const std::string& name, int width, int height);
+
+    // setupãдԴexecuteExecuteʱ
+    void AddPass(const std::string& name, const SetupFunc& setup, const ExecuteFunc& execute);
+
+    void Compile();
+    void Execute();
+
+    // ִڼȡԴӦ
+    unsigned int GetTexture(RenderGraphHandle handle) const;
+    RenderTarget* GetTarget(RenderGraphHandle handle) const;
+
+    // ϴExecuteִк޳passյĸԼȥպload
+    std::uint32_t GetExecutedCount() const { return mExecutedCount; }
+    std::uint32_t GetCulledCount() const { return mCulledCount; }
+    std::uint32_t GetClearCount() const { return mClearCount; }
+    std::uint32_t GetSkippedLoadCount() const { return mSkippedLoadCount; }
+    // ÿpassĸʹʽ
+    void Report(std::ostream& out) const;
+
+private:
+    // 汾ӦͬһԴ
+    struct Resource
+    {
+        std::string mName;
+        RenderTargetDesc mDesc;
+        RenderTarget* mTarget = nullptr;
+        bool mImported = false;
+        bool mBackbuffer = false;
+        int mBackbufferWidth = 0;
+        int mBackbufferHeight = 0;
+        int mFirstPass = -1;  // һκһʹpass
+        int mLastPass = -1;
+
+        Resource(const std::string& name, const RenderTargetDesc& desc) : mName(name), mDesc(desc) {}
+    };
+
+    // Դһ汾
+    struct Node
+    {
+        int mResource;
+        int mVersion;
+        int mWriter = -1;   // д汾pass
+        int mRefCount = 0;  // ȡ汾pass
+    };
+
+    struct Attachment
+    {
+        int mNode;  // дİ汾
+        RenderGraphLoadOp mLoadOp;
+        glm::vec4 mClearValue;
+    };
+
+    struct Pass
+    {
+        std::string mName;
+        ExecuteFunc mExecute;
+        std::vector<int> mReads;
+        std::vector<Attachment> mWrites;
+        bool mSideEffect = false;
+        bool mCulled = false;
+        int mRefCount = 0;
+    };
+
+    RenderTargetPool& mPool;
+    std::vector<Resource> mResources;
+    std::vector<Node> mNodes;
+    std::vector<Pass> mPasses;
+    bool mCompiled = false;
+
+    std::uint32_t mExecutedCount = 0;
+    std::uint32_t mCulledCount = 0;
+    std::uint32_t mClearCount = 0;
+    std::uint32_t mSkippedLoadCount = 0;
+
+    int _addNode(int resource, int version);
+    bool _isDepth(const Resource& resource) const;
+    void _beginPass(Pass& pass);
+
+    friend class RenderGraphBuilder;
+};
+
+RenderGraphHandle RenderGraphBuilder::Read(RenderGraphHandle handle)
+{
+    mGraph.mPasses[mPass].mReads.push_back(handle.mIndex);
+    return handle;
+}
+
+RenderGraphHandle RenderGraphBuilder::Write(RenderGraphHandle handle, RenderGraphLoadOp loadOp, const glm::vec4& clearValue)
+{
+    const RenderGraph::Node& node = mGraph.mNodes[handle.mIndex];
+    for (auto&& other : mGraph.mNodes) {
+        if (other.mResource == node.mResource && other.mVersion > node.mVersion) {
+            std::cout << "Render graph: pass " << mGraph.mPasses[mPass].mName << " writes an old version of "
+                << mGraph.mResources[node.mResource].mName << std::endl;
+            break;
+        }
+    }
+
+    // ԭʱһ汾
+    if (loadOp == RenderGraphLoadOp::load) {
+        mGraph.mPasses[mPass].mReads.push_back(handle.mIndex);
+    }
+
+    RenderGraphHandle result;
+    result.mIndex = mGraph._addNode(node.mResource, node.mVersion + 1);
+    mGraph.mNodes[result.mIndex].mWriter = mPass;
+    mGraph.mPasses[mPass].mWrites.push_back({ result.mIndex, loadOp, clearValue });
+    return result;
+}
+
+void RenderGraphBuilder::SetSideEffect()
+{
+    mGraph.mPasses[mPass].mSideEffect = true;
+}
+
+void RenderGraph::Reset()
+{
+    mResources.clear();
+    mNodes.clear();
+    mPasses.clear();
+    mCompiled = false;
+}
+
+int RenderGraph::_addNode(int resource, int version)
+{
+    Node node;
+    node.mResource = resource;
+    node.mVersion = version;
+    mNodes.push_back(node);
+    return static_cast<int>(mNodes.size()) - 1;
+}
+
+RenderGraphHandle RenderGraph::CreateTexture(const std::string& name, const RenderTargetDesc& desc)
+{
+    mResources.emplace_back(name, desc);
+    RenderGraphHandle handle;
+    handle.mIndex = _addNode(static_cast<int>(mResources.size()) - 1, 0);
+    return handle;
+}
+
+RenderGraphHandle RenderGraph::ImportTexture(const std::string& name, RenderTarget* target)
+{
+    mResources.emplace_back(name, RenderTargetDesc(target->mInternalFormat, target->mWidth, target->mHeight, target->mSamples));
+    mResources.back().mTarget = target;
+    mResources.back().mImported = true;
+    RenderGraphHandle handle;
+    handle.mIndex = _addNode(static_cast<int>(mResources.size()) - 1, 0);
+    return handle;
+}
+
+RenderGraphHandle RenderGraph::ImportBackbuffer(const std::string& name, int width, int height)
+{
+    mResources.emplace_back(name, RenderTargetDesc(GL_RGBA8, width, height));
+    mResources.back().mImported = true;
+    mResources.back().mBackbuffer = true;
+    mResources.back().mBackbufferWidth = width;
+    mResources.back().mBackbufferHeight = height;
+    RenderGraphHandle handle;
+    handle.mIndex = _addNode(static_cast<int>(mResources.size()) - 1, 0);
+    return handle;
+}
+
+void RenderGraph::AddPass(const std::string& name, const SetupFunc& setup, const ExecuteFunc& execute)
+{
+    mPasses.emplace_back();
+    mPasses.back().mName = name;
+    mPasses.back().mExecute = execute;
+    RenderGraphBuilder builder(*this, static_cast<int>(mPasses.size()) - 1);
+    setup(builder);
+}
+
+bool RenderGraph::_isDepth(const Resource& resource) const
+{
+    GLenum format = resource.mDesc.mInternalFormat;
+    return format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH_COMPONENT16
+        || format == GL_DEPTH_COMPONENT24 || format == GL_DEPTH_COMPONENT32F;
+}
+
+void RenderGraph::Compile()
+{
+    // üpassΪдİ汾汾Ϊȡpass
+    for (auto&& node : mNodes) {
+        node.mRefCount = 0;
+    }
+    for (auto&& pass : mPasses) {
+        pass.mCulled = false;
+        pass.mRefCount = static_cast<int>(pass.mWrites.size());
+        for (int read : pass.mReads) {
+            mNodes[read].mRefCount++;
+        }
+    }
+
+    // ûбȡʱԴ汾ʼ޳д뵼ԴиõpassǱ
+    std::vector<int> unused;
+    for (int i = 0; i < static_cast<int>(mNodes.size()); i++) {
+        if (mNodes[i].mRefCount == 0 && !mResources[mNodes[i].mResource].mImported) {
+            unused.push_back(i);
+        }
+    }
+    while (!unused.empty()) {
+        Node& node = mNodes[unused.back()];
+        unused.pop_back();
+        if (node.mWriter < 0) {
+            continue;
+        }
+
+        Pass& writer = mPasses[node.mWriter];
+        if (--writer.mRefCount > 0 || writer.mSideEffect) {
+            continue;
+        }
+        writer.mCulled = true;
+        for (int read : writer.mReads) {
+            if (--mNodes[read].mRefCount == 0 && !mResources[mNodes[read].mResource].mImported) {
+                unused.push_back(read);
+            }
+        }
+    }
+
+    // ʣµpassʱԴ
+    for (auto&& resource : mResources) {
+        resource.mFirstPass = resource.mLastPass = -1;
+    }
+    for (int i = 0; i < static_cast<int>(mPasses.size()); i++) {
+        Pass& pass = mPasses[i];
+        if (pass.mCulled) {
+            continue;
+        }
+        auto use = [&](int nodeIndex) {
+            Resource& resource = mResources[mNodes[nodeIndex].mResource];
+            if (resource.mFirstPass < 0) {
+                resource.mFirstPass = i;
+            }
+            resource.mLastPass = i;
+        };
+        for (int read : pass.mReads) {
+            use(read);
+        }
+        for (auto&& write : pass.mWrites) {
+            use(write.mNode);
+        }
+    }
+    mCompiled = true;
+}
+
+void RenderGraph::_beginPass(Pass& pass)
+{
+    if (pass.mWrites.empty()) {
+        return;
+    }
+
+    std::vector<RenderTarget*> colors;
+    RenderTarget* depthStencil = nullptr;
+    bool backbuffer = false;
+    int width = 0;
+    int height = 0;
+    for (auto&& write : pass.mWrites) {
+        Resource& resource = mResources[mNodes[write.mNode].mResource];
+        if (resource.mBackbuffer) {
+            backbuffer = true;
+            width = resource.mBackbufferWidth;
+            height = resource.mBackbufferHeight;
+        }
+        else if (_isDepth(resource)) {
+            depthStencil = resource.mTarget;
+        }
+        else {
+            colors.push_back(resource.mTarget);
+        }
+    }
+
+    if (backbuffer) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+    else {
+        RenderTarget* first = colors.empty() ? depthStencil : colors.front();
+        width = first->mWidth;
+        height = first->mHeight;
+
+        // GetFramebufferֻinitializer_list٣չ
+        unsigned int fbo = 0;
+        switch (colors.size())
+        {
+        case 0: fbo = mPool.GetFramebuffer({}, depthStencil); break;
+        case 1: fbo = mPool.GetFramebuffer({ colors[0] }, depthStencil); break;
+        case 2: fbo = mPool.GetFramebuffer({ colors[0], colors[1] }, depthStencil); break;
+        case 3: fbo = mPool.GetFramebuffer({ colors[0], colors[1], colors[2] }, depthStencil); break;
+        default: fbo = mPool.GetFramebuffer({ colors[0], colors[1], colors[2], colors[3] }, depthStencil); break;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    }
+    glViewport(0, 0, width, height);
+
+    // һдİ汾ûпԱݣloadͬdontCare
+    GLint colorIndex = 0;
+    for (auto&& write : pass.mWrites) {
+        const Node& node = mNodes[write.mNode];
+        Resource& resource = mResources[node.mResource];
+        bool depth = !resource.mBackbuffer && _isDepth(resource);
+        RenderGraphLoadOp loadOp = write.mLoadOp;
+        if (loadOp == RenderGraphLoadOp::load && node.mVersion == 1 && !resource.mImported) {
+            loadOp = RenderGraphLoadOp::dontCare;
+            mSkippedLoadCount++;
+        }
+
+        if (loadOp == RenderGraphLoadOp::clear) {
+            if (depth) {
+                glDepthMask(GL_TRUE);
+                if (resource.mDesc.mInternalFormat == GL_DEPTH24_STENCIL8) {
+                    glStencilMask(0xFF);
+                    glClearBufferfi(GL_DEPTH_STENCIL, 0, write.mClearValue.x, static_cast<GLint>(write.mClearValue.y));
+                }
+                else {
+                    glClearBufferfv(GL_DEPTH, 0, &write.mClearValue.x);
+                }
+            }
+            else {
+                glClearBufferfv(GL_COLOR, colorIndex, &write.mClearValue.x);
+            }
+            mClearCount++;
+        }
+        if (!depth) {
+            colorIndex++;
+        }
+    }
+}
+
+void RenderGraph::Execute()
+{
+    if (!mCompiled) {
+        Compile();
+    }
+
+    mExecutedCount = mCulledCount = mClearCount = mSkippedLoadCount = 0;
+    for (int i = 0; i < static_cast<int>(mPasses.size()); i++) {
+        Pass& pass = mPasses[i];
+        if (pass.mCulled) {
+            mCulledCount++;
+            continue;
+        }
+
+        // һʹõʱԴӶȡ
+        for (auto&& resource : mResources) {
+            if (!resource.mImported && resource.mFirstPass == i) {
+                resource.mTarget = mPool.Acquire(resource.mDesc);
+            }
+        }
+
+        _beginPass(pass);
+        RenderStats::Get().BeginPass(pass.mName);
+        pass.mExecute(*this);
+        RenderStats::Get().EndPass();
+        mExecutedCount++;
+
+        // һʹú黹֮passԸ
+        for (auto&& resource : mResources) {
+            if (!resource.mImported && resource.mLastPass == i) {
+                mPool.Release(resource.mTarget);
+                resource.mTarget = nullptr;
+            }
+        }
+    }
+}
+
+RenderTarget* RenderGraph::GetTarget(RenderGraphHandle handle) const
+{
+    return mResources[mNodes[handle.mIndex].mResource].mTarget;
+}
+
+unsigned int RenderGraph::GetTexture(RenderGraphHandle handle) const
+{
+    RenderTarget* target = GetTarget(handle);
+    return target ? target->mTexture : 0;
+}
+
+void RenderGraph::Report(std::ostream& out) const
+{
+    static const char* loadOpNames[] = { "load", "clear", "dontCare" };
+    out << "Render graph: " << mExecutedCount << " passes executed, " << mCulledCount << " culled"
+        << ", " << mClearCount << " clears, " << mSkippedLoadCount << " loads skipped" << std::endl;
+    for (auto&& pass : mPasses) {
+        out << "  " << pass.mName << (pass.mCulled ? " (culled)" : "");
+        for (int read : pass.mReads) {
+            const Node& node = mNodes[read];
+            out << " r:" << mResources[node.mResource].mName << "#" << node.mVersion;
+        }
+        for (auto&& write : pass.mWrites) {
+            const Node& node = mNodes[write.mNode];
+            out << " w:" << mResources[node.mResource].mName << "#" << node.mVersion
+                << "(" << loadOpNames[static_cast<int>(write.mLoadOp)] << ")";
+        }
+        out << std::endl;
+    }
+}
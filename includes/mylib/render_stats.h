@@ -0,0 +1,313 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+// ۼӵȾ
+// ״̬лΪʵʵõprogramVAO󶨴ϴֽΪCPU
+struct RenderCounters
+{
+    std::uint64_t mDrawCalls = 0;
+    std::uint64_t mTriangles = 0;
+    std::uint64_t mProgramBinds = 0;
+    std::uint64_t mVertexArrayBinds = 0;
+    std::uint64_t mTextureBinds = 0;
+    std::uint64_t mUniformUploads = 0;
+    std::uint64_t mUniformBytes = 0;
+    std::uint64_t mBufferUploadBytes = 0;
+    std::uint64_t mTextureUploadBytes = 0;
+
+    // ÿ֣ʱΪ
+    struct Field
+    {
+        const char* mName;
+        std::uint64_t RenderCounters::* mMember;
+    };
+    static const std::vector<Field>& GetFields();
+
+    std::uint64_t GetStateChanges() const { return mProgramBinds + mVertexArrayBinds + mTextureBinds; }
+
+    RenderCounters& operator+=(const RenderCounters& other);
+    RenderCounters operator-(const RenderCounters& other) const;
+};
+
+// һpassеļͬһ֡ͬpassϲ
+struct RenderPassStats
+{
+    std::string mName;
+    RenderCounters mCounters;
+};
+
+// һ֡ͳƣԴΪһ֡ʱĹֵ
+struct RenderFrameStats
+{
+    std::uint64_t mFrame = 0;
+    RenderCounters mCounters;
+    std::vector<RenderPassStats> mPasses;
+    std::int64_t mBufferMemory = 0;
+    std::int64_t mTextureMemory = 0;
+};
+
+class RenderStatsExporter;
+
+// ÿ֡Ⱦͳƣɻơ󶨡uniformϴݵĵطֱۼӣֻмӷһֱ
+// ÿ֡ʱEndFrameһ֡ļ浽GetLastFrameȻ
+// ԴǴʱСƵģ֡
+struct RenderStats : RenderCounters
+{
+    std::int64_t mBufferMemory = 0;
+    std::int64_t mTextureMemory = 0;
+
+    static RenderStats& Get()
+    {
+        static RenderStats stats;
+        return stats;
+    }
+
+    // ֻһ֡ļ
+    void Reset();
+
+    void AddDraw(std::uint64_t indexCount)
+    {
+        mDrawCalls++;
+        mTriangles += indexCount / 3;
+    }
+    void AddUniform(std::uint64_t bytes)
+    {
+        mUniformUploads++;
+        mUniformBytes += bytes;
+    }
+    void AddBufferUpload(std::uint64_t bytes) { mBufferUploadBytes += bytes; }
+    void AddTextureUpload(std::uint64_t bytes) { mTextureUploadBytes += bytes; }
+    // ʱΪɾʱΪ
+    void AddBufferMemory(std::int64_t bytes) { mBufferMemory += bytes; }
+    void AddTextureMemory(std::int64_t bytes) { mTextureMemory += bytes; }
+
+    // ֮ļǵpassֱEndPassһBeginPass֧Ƕ
+    void BeginPass(const std::string& name);
+    void EndPass();
+
+    void EndFrame();
+    const RenderFrameStats& GetLastFrame() const { return mLastFrame; }
+
+    // ɵ߳Уnullptrֹͣ
+    void SetExporter(RenderStatsExporter* exporter) { mExporter = exporter; }
+
+private:
+    RenderFrameStats mLastFrame;
+    // һ֡passֻòͷţÿ֡
+    std::vector<RenderPassStats> mPasses;
+    std::size_t mPassCount = 0;
+    int mCurrentPass = -1;
+    RenderCounters mPassStart;
+    std::uint64_t mFrame = 0;
+    RenderStatsExporter* mExporter = nullptr;
+};
+
+// ͳƶдļȹ߶ȡ
+// ÿmInterval֡дһЩ֡ƽֵչΪ.jsonʱÿдһJSONΪCSVÿpassһУ֡passΪframe
+class RenderStatsExporter
+{
+public:
+    ~RenderStatsExporter() { Close(); }
+
+    bool Open(const std::string& path, int interval = 60);
+    void Close();
+    void Write(const RenderFrameStats& frame);
+
+private:
+    std::ofstream mFile;
+    bool mJson = false;
+    int mInterval = 60;
+    int mFrames = 0;
+    RenderCounters mTotal;
+    std::vector<RenderPassStats> mPassTotals;
+
+    void _flush(const RenderFrameStats& last);
+    void _writeCounters(const RenderCounters& counters);
+};
+
+
+const std::vector<RenderCounters::Field>& RenderCounters::GetFields()
+{
+    static const std::vector<Field> fields = {
+        { "draw_calls", &RenderCounters::mDrawCalls },
+        { "triangles", &RenderCounters::mTriangles },
+        { "program_binds", &RenderCounters::mProgramBinds },
+        { "vertex_array_binds", &RenderCounters::mVertexArrayBinds },
+        { "texture_binds", &RenderCounters::mTextureBinds },
+        { "uniform_uploads", &RenderCounters::mUniformUploads },
+        { "uniform_bytes", &RenderCounters::mUniformBytes },
+        { "buffer_upload_bytes", &RenderCounters::mBufferUploadBytes },
+        { "texture_upload_bytes", &RenderCounters::mTextureUploadBytes },
+    };
+    return fields;
+}
+
+RenderCounters& RenderCounters::operator+=(const RenderCounters& other)
+{
+    for (auto&& field : GetFields()) {
+        this->*field.mMember += other.*field.mMember;
+    }
+    return *this;
+}
+
+RenderCounters RenderCounters::operator-(const RenderCounters& other) const
+{
+    RenderCounters result = *this;
+    for (auto&& field : GetFields()) {
+        result.*field.mMember -= other.*field.mMember;
+    }
+    return result;
+}
+
+void RenderStats::Reset()
+{
+    static_cast<RenderCounters&>(*this) = RenderCounters();
+    mPassCount = 0;
+    mCurrentPass = -1;
+}
+
+void RenderStats::BeginPass(const std::string& name)
+{
+    EndPass();
+    for (std::size_t i = 0; i < mPassCount; i++) {
+        if (mPasses[i].mName == name) {
+            mCurrentPass = static_cast<int>(i);
+            break;
+        }
+    }
+    if (mCurrentPass < 0) {
+        if (mPassCount == mPasses.size()) {
+            mPasses.emplace_back();
+        }
+        mPasses[mPassCount].mName = name;
+        mPasses[mPassCount].mCounters = RenderCounters();
+        mCurrentPass = static_cast<int>(mPassCount++);
+    }
+    mPassStart = *this;
+}
+
+void RenderStats::EndPass()
+{
+    if (mCurrentPass >= 0) {
+        mPasses[mCurrentPass].mCounters += *this - mPassStart;
+        mCurrentPass = -1;
+    }
+}
+
+void RenderStats::EndFrame()
+{
+    EndPass();
+    mLastFrame.mFrame = mFrame++;
+    mLastFrame.mCounters = *this;
+    mLastFrame.mPasses.assign(mPasses.begin(), mPasses.begin() + mPassCount);
+    mLastFrame.mBufferMemory = mBufferMemory;
+    mLastFrame.mTextureMemory = mTextureMemory;
+    if (mExporter) {
+        mExporter->Write(mLastFrame);
+    }
+    Reset();
+}
+
+
+bool RenderStatsExporter::Open(const std::string& path, int interval)
+{
+    Close();
+    mFile.open(path);
+    if (!mFile) {
+        std::cout << "Failed to open render stats log: " << path << std::endl;
+        return false;
+    }
+    mJson = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    mInterval = interval > 0 ? interval : 1;
+    mFrames = 0;
+    mTotal = RenderCounters();
+    mPassTotals.clear();
+
+    if (!mJson) {
+        mFile << "frame,pass";
+        for (auto&& field : RenderCounters::GetFields()) {
+            mFile << "," << field.mName;
+        }
+        mFile << ",buffer_memory,texture_memory" << std::endl;
+    }
+    return true;
+}
+
+void RenderStatsExporter::Close()
+{
+    if (mFile.is_open()) {
+        mFile.close();
+    }
+}
+
+void RenderStatsExporter::Write(const RenderFrameStats& frame)
+{
+    if (!mFile.is_open()) {
+        return;
+    }
+    mTotal += frame.mCounters;
+    for (auto&& pass : frame.mPasses) {
+        auto found = std::find_if(mPassTotals.begin(), mPassTotals.end(), [&pass](const RenderPassStats& total) { return total.mName == pass.mName; });
+        if (found == mPassTotals.end()) {
+            mPassTotals.push_back({ pass.mName, RenderCounters() });
+            found = mPassTotals.end() - 1;
+        }
+        found->mCounters += pass.mCounters;
+    }
+    if (++mFrames >= mInterval) {
+        _flush(frame);
+    }
+}
+
+void RenderStatsExporter::_writeCounters(const RenderCounters& counters)
+{
+    // дʱÿ֡ƽֵ
+    bool first = true;
+    for (auto&& field : RenderCounters::GetFields()) {
+        double value = static_cast<double>(counters.*field.mMember) / mFrames;
+        if (mJson) {
+            mFile << (first ? "" : ",") << "\"" << field.mName << "\":" << value;
+        }
+        else {
+            mFile << "," << value;
+        }
+        first = false;
+    }
+}
+
+void RenderStatsExporter::_flush(const RenderFrameStats& last)
+{
+    if (mJson) {
+        mFile << "{\"frame\":" << last.mFrame << ",\"frames\":" << mFrames << ",\"buffer_memory\":" << last.mBufferMemory
+            << ",\"texture_memory\":" << last.mTextureMemory << ",\"counters\":{";
+        _writeCounters(mTotal);
+        mFile << "},\"passes\":{";
+        for (std::size_t i = 0; i < mPassTotals.size(); i++) {
+            mFile << (i > 0 ? "," : "") << "\"" << mPassTotals[i].mName << "\":{";
+            _writeCounters(mPassTotals[i].mCounters);
+            mFile << "}";
+        }
+        mFile << "}}" << std::endl;
+    }
+    else {
+        mFile << last.mFrame << ",frame";
+        _writeCounters(mTotal);
+        mFile << "," << last.mBufferMemory << "," << last.mTextureMemory << std::endl;
+        for (auto&& pass : mPassTotals) {
+            mFile << last.mFrame << "," << pass.mName;
+            _writeCounters(pass.mCounters);
+            mFile << "," << last.mBufferMemory << "," << last.mTextureMemory << std::endl;
+        }
+    }
+
+    mFrames = 0;
+    mTotal = RenderCounters();
+    mPassTotals.clear();
+}
@@ -0,0 +1,343 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include <mylib/render_stats.h>
+
+
+// ȾĿΪ0ʱʹöصķֱʳmScaleֱʱ仯Զ´С
+struct RenderTargetDesc
+{
+    GLenum mInternalFormat;
+    int mWidth = 0;
+    int mHeight = 0;
+    float mScale = 1.0f;
+    int mSamples = 1;
+
+    RenderTargetDesc(GLenum internalFormat, float scale = 1.0f, int samples = 1)
+        : mInternalFormat(internalFormat), mScale(scale), mSamples(samples) {
+    }
+    RenderTargetDesc(GLenum internalFormat, int width, int height, int samples = 1)
+        : mInternalFormat(internalFormat), mWidth(width), mHeight(height), mSamples(samples) {
+    }
+};
+
+// еһɶشɾ
+struct RenderTarget
+{
+    unsigned int mTexture;
+    GLenum mInternalFormat;
+    int mWidth;
+    int mHeight;
+    int mSamples;
+    std::size_t mBytes;
+
+    bool mInUse = false;
+    std::uint64_t mLastUsedFrame = 0;
+};
+
+
+// ȾĿ
+// (ʽ, С, )Releaseͬһ֡ڿԱͬAcquireã
+// ڲصʱĿ˹ͬһԴ棻GL3.3޷òͬʽԴ棬ֻͬʱ
+// ֡尴ϻ棬ɾʱһɾ
+// ֱʱ仯ɴСٱʹãм֡Զɾ
+class RenderTargetPool
+{
+public:
+    // г֡ᱻɾ
+    static const std::uint64_t kMaxIdleFrames = 3;
+
+    RenderTargetPool(int width, int height) : mWidth(width), mHeight(height) {}
+    ~RenderTargetPool();
+
+    // ڴС仯ʱãѾĿ´Acquireʱ´С´
+    void SetResolution(int width, int height);
+    int GetWidth() const { return mWidth; }
+    int GetHeight() const { return mHeight; }
+
+    // ÿ֡ʼʱãɾʱе
+    void BeginFrame();
+
+    RenderTarget* Acquire(const RenderTargetDesc& desc);
+    void Release(RenderTarget* target);
+
+    // ȡЩΪ֡壬depthStencilΪ
+    unsigned int GetFramebuffer(std::initializer_list<RenderTarget*> colors, RenderTarget* depthStencil);
+
+    // ǰͷֵԴռãReportʽС͸õĴԼǰѾɾҲᱣ
+    std::size_t GetAllocatedBytes() const { return mAllocatedBytes; }
+    std::size_t GetPeakBytes() const { return mPeakBytes; }
+    void Report(std::ostream& out) const;
+
+private:
+    int mWidth;
+    int mHeight;
+    std::uint64_t mFrame = 0;
+
+    std::vector<std::unique_ptr<RenderTarget>> mTargets;
+    std::map<std::vector<unsigned int>, unsigned int> mFramebuffers;  // IDһΪ -> ֡
+
+    std::size_t mAllocatedBytes = 0;
+    std::size_t mPeakBytes = 0;
+    std::uint32_t mCreatedCount = 0;
+    std::uint32_t mReusedCount = 0;
+
+    struct Usage
+    {
+        std::uint32_t mCreated = 0;
+        std::uint32_t mReused = 0;
+    };
+    typedef std::tuple<GLenum, int, int, int> UsageKey;  // ʽ, , , 
+    std::map<UsageKey, Usage> mUsages;
+
+    void _createTexture(RenderTarget& target);
+    void _destroy(std::size_t index);
+    static std::size_t _bytesPerPixel(GLenum internalFormat);
+    static bool _isDepthFormat(GLenum internalFormat);
+};
+
+RenderTargetPool::~RenderTargetPool()
+{
+    while (!mTargets.empty()) {
+        _destroy(mTargets.size() - 1);
+    }
+}
+
+void RenderTargetPool::SetResolution(int width, int height)
+{
+    // СʱСΪ0ԭķֱ
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    mWidth = width;
+    mHeight = height;
+}
+
+void RenderTargetPool::BeginFrame()
+{
+    mFrame++;
+    for (std::size_t i = mTargets.size(); i > 0; i--) {
+        RenderTarget& target = *mTargets[i - 1];
+        if (!target.mInUse && mFrame - target.mLastUsedFrame > kMaxIdleFrames) {
+            _destroy(i - 1);
+        }
+    }
+}
+
+RenderTarget* RenderTargetPool::Acquire(const RenderTargetDesc& desc)
+{
+    int width = desc.mWidth > 0 ? desc.mWidth : std::max(1, static_cast<int>(mWidth * desc.mScale));
+    int height = desc.mHeight > 0 ? desc.mHeight : std::max(1, static_cast<int>(mHeight * desc.mScale));
+
+    // һвͬ
+    for (auto&& target : mTargets) {
+        if (!target->mInUse && target->mInternalFormat == desc.mInternalFormat
+            && target->mWidth == width && target->mHeight == height && target->mSamples == desc.mSamples) {
+            target->mInUse = true;
+            target->mLastUsedFrame = mFrame;
+            mReusedCount++;
+            mUsages[UsageKey(desc.mInternalFormat, width, height, desc.mSamples)].mReused++;
+            return target.get();
+        }
+    }
+
+    std::unique_ptr<RenderTarget> target(new RenderTarget());
+    target->mInternalFormat = desc.mInternalFormat;
+    target->mWidth = width;
+    target->mHeight = height;
+    target->mSamples = desc.mSamples;
+    target->mBytes = _bytesPerPixel(desc.mInternalFormat) * width * height * desc.mSamples;
+    target->mInUse = true;
+    target->mLastUsedFrame = mFrame;
+    _createTexture(*target);
+
+    mAllocatedBytes += target->mBytes;
+    RenderStats::Get().AddTextureMemory(target->mBytes);
+    mPeakBytes = std::max(mPeakBytes, mAllocatedBytes);
+    mCreatedCount++;
+    mUsages[UsageKey(desc.mInternalFormat, width, height, desc.mSamples)].mCreated++;
+    mTargets.push_back(std::move(target));
+    return mTargets.back().get();
+}
+
+void RenderTargetPool::Release(RenderTarget* target)
+{
+    if (target) {
+        target->mInUse = false;
+        target->mLastUsedFrame = mFrame;
+    }
+}
+
+void RenderTargetPool::_createTexture(RenderTarget& target)
+{
+    bool depth = _isDepthFormat(target.mInternalFormat);
+    GLenum format = depth ? (target.mInternalFormat == GL_DEPTH24_STENCIL8 ? GL_DEPTH_STENCIL : GL_DEPTH_COMPONENT) : GL_RGBA;
+    GLenum type = target.mInternalFormat == GL_DEPTH24_STENCIL8 ? GL_UNSIGNED_INT_24_8 : (depth ? GL_FLOAT : GL_UNSIGNED_BYTE);
+
+    glGenTextures(1, &target.mTexture);
+    if (target.mSamples > 1) {
+        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, target.mTexture);
+        glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, target.mSamples, target.mInternalFormat, target.mWidth, target.mHeight, GL_TRUE);
+        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+        return;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, target.mTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, target.mInternalFormat, target.mWidth, target.mHeight, 0, format, type, NULL);
+    // ʹ
+    GLint filter = depth ? GL_NEAREST : GL_LINEAR;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void RenderTargetPool::_destroy(std::size_t index)
+{
+    RenderTarget& target = *mTargets[index];
+
+    // ɾ֡
+    for (auto it = mFramebuffers.begin(); it != mFramebuffers.end();) {
+        if (std::find(it->first.begin(), it->first.end(), target.mTexture) != it->first.end()) {
+            glDeleteFramebuffers(1, &it->second);
+            it = mFramebuffers.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    glDeleteTextures(1, &target.mTexture);
+    mAllocatedBytes -= target.mBytes;
+    RenderStats::Get().AddTextureMemory(-static_cast<std::int64_t>(target.mBytes));
+    mTargets.erase(mTargets.begin() + index);
+}
+
+unsigned int RenderTargetPool::GetFramebuffer(std::initializer_list<RenderTarget*> colors, RenderTarget* depthStencil)
+{
+    std::vector<unsigned int> key;
+    for (auto&& color : colors) {
+        key.push_back(color->mTexture);
+    }
+    key.push_back(depthStencil ? depthStencil->mTexture : 0);
+
+    auto it = mFramebuffers.find(key);
+    if (it != mFramebuffers.end()) {
+        return it->second;
+    }
+
+    unsigned int fbo;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    std::vector<GLenum> drawBuffers;
+    for (auto&& color : colors) {
+        GLenum attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(drawBuffers.size());
+        GLenum textureTarget = color->mSamples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, textureTarget, color->mTexture, 0);
+        drawBuffers.push_back(attachment);
+    }
+    if (depthStencil) {
+        GLenum attachment = depthStencil->mInternalFormat == GL_DEPTH24_STENCIL8 ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+        GLenum textureTarget = depthStencil->mSamples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, textureTarget, depthStencil->mTexture, 0);
+    }
+    if (drawBuffers.empty()) {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    }
+    else {
+        glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+    }
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "Create pooled frame buffer error!" << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    mFramebuffers[key] = fbo;
+    return fbo;
+}
+
+std::size_t RenderTargetPool::_bytesPerPixel(GLenum internalFormat)
+{
+    switch (internalFormat)
+    {
+    case GL_R8:
+        return 1;
+    case GL_R16F:
+    case GL_RG8:
+    case GL_DEPTH_COMPONENT16:
+        return 2;
+    case GL_RGB8:
+    case GL_RGB:
+    case GL_DEPTH_COMPONENT24:
+        return 3;
+    case GL_RGBA8:
+    case GL_RGBA:
+    case GL_R32F:
+    case GL_RG16F:
+    case GL_R11F_G11F_B10F:
+    case GL_DEPTH24_STENCIL8:
+    case GL_DEPTH_COMPONENT32F:
+        return 4;
+    case GL_RGB16F:
+        return 6;
+    case GL_RGBA16F:
+    case GL_RG32F:
+        return 8;
+    case GL_RGBA32F:
+        return 16;
+    default:
+        return 4;
+    }
+}
+
+bool RenderTargetPool::_isDepthFormat(GLenum internalFormat)
+{
+    return internalFormat == GL_DEPTH24_STENCIL8 || internalFormat == GL_DEPTH_COMPONENT16
+        || internalFormat == GL_DEPTH_COMPONENT24 || internalFormat == GL_DEPTH_COMPONENT32F;
+}
+
+void RenderTargetPool::Report(std::ostream& out) const
+{
+    out << "Render targets: " << mTargets.size() << " allocated, " << mAllocatedBytes / 1024 << " KB"
+        << ", peak " << mPeakBytes / 1024 << " KB"
+        << ", created " << mCreatedCount << ", reused " << mReusedCount << std::endl;
+    for (auto&& usage : mUsages) {
+        GLenum internalFormat;
+        int width, height, samples;
+        std::tie(internalFormat, width, height, samples) = usage.first;
+        out << "  0x" << std::hex << internalFormat << std::dec << " " << width << "x" << height;
+        if (samples > 1) {
+            out << " x" << samples;
+        }
+        out << ": created " << usage.second.mCreated << ", reused " << usage.second.mReused;
+
+        // ǰ
+        std::size_t allocated = 0, inUse = 0, bytes = 0;
+        for (auto&& target : mTargets) {
+            if (target->mInternalFormat == internalFormat && target->mWidth == width && target->mHeight == height && target->mSamples == samples) {
+                allocated++;
+                inUse += target->mInUse ? 1 : 0;
+                bytes += target->mBytes;
+            }
+        }
+        if (allocated > 0) {
+            out << ", " << allocated << " allocated " << bytes / 1024 << " KB";
+            if (inUse > 0) {
+                out << " (" << inUse << " in use)";
+            }
+        }
+        out << std::endl;
+    }
+}
@@ -7,13 +7,40 @@
 #include <sstream>
 #include <iostream>
 #include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
 #include <mylib/camera.h>
+#include <mylib/profiler.h>
+#include <mylib/render_stats.h>
+#include <mylib/render_device.h>
+#include <mylib/gpu_resources.h>
+#include <mylib/uniform_id.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 
 struct LightParameters
 {
+    // ˥ϵԴӰ뾶þķ˥5/256
+    static float CalcInfluenceRadius(float constant, float linear, float quadratic, const glm::vec3& diffuse)
+    {
+        float lightMax = std::max(std::max(diffuse.r, diffuse.g), diffuse.b);
+        float threshold = constant - (256.0f / 5.0f) * lightMax;
+        // Ϊ0ʱѾֵԴǺڵģԴӰκεط
+        if (threshold >= 0.0f) {
+            return 0.0f;
+        }
+        if (quadratic <= 0.0f) {
+            return linear > 0.0f ? -threshold / linear : std::numeric_limits<float>::max();
+        }
+        float discriminant = linear * linear - 4.0f * quadratic * threshold;
+        if (discriminant < 0.0f) {
+            return 0.0f;
+        }
+        return std::max((-linear + std::sqrt(discriminant)) / (2.0f * quadratic), 0.0f);
+    }
+
     struct MaterialParam
     {
     public:
@@ -65,6 +92,10 @@ struct LightParameters
         PointLight(glm::vec3 position)
             : PointLight(position, 1.0f, 0.09f, 0.032f, glm::vec3(0.05f), glm::vec3(1.8f, 0.0f, 0.0f), glm::vec3(1.0f)) {
         }
+
+        float GetInfluenceRadius() const {
+            return CalcInfluenceRadius(mConstant, mLinear, mQuadratic, mDiffuse);
+        }
     };
 
     struct SpotLight
@@ -87,6 +118,23 @@ struct LightParameters
             : mPosition(position), mDirection(direction), mAmbient(ambient), mDiffuse(diffuse), mSpecular(specular),
             mConstant(constant), mLinear(linear), mQuadratic(quadratic), mCutOff(cutOff), mOuterCutOff(outerCutOff) {
         }
+
+        float GetInfluenceRadius() const {
+            return CalcInfluenceRadius(mConstant, mLinear, mQuadratic, mDiffuse);
+        }
+    };
+
+    // pointLightsÿԱUniformIdshaderеNR_POINT_LIGHTSһ
+    struct PointLightUniforms
+    {
+        static constexpr std::size_t kCount = 4;
+        static constexpr std::array<UniformId, kCount> kPosition = MakeUniformIdArray<kCount>("pointLights", ".position");
+        static constexpr std::array<UniformId, kCount> kConstant = MakeUniformIdArray<kCount>("pointLights", ".constant");
+        static constexpr std::array<UniformId, kCount> kLinear = MakeUniformIdArray<kCount>("pointLights", ".linear");
+        static constexpr std::array<UniformId, kCount> kQuadratic = MakeUniformIdArray<kCount>("pointLights", ".quadratic");
+        static constexpr std::array<UniformId, kCount> kAmbient = MakeUniformIdArray<kCount>("pointLights", ".ambient");
+        static constexpr std::array<UniformId, kCount> kDiffuse = MakeUniformIdArray<kCount>("pointLights", ".diffuse");
+        static constexpr std::array<UniformId, kCount> kSpecular = MakeUniformIdArray<kCount>("pointLights", ".specular");
     };
 
     MaterialParam mMaterial;
@@ -96,7 +144,7 @@ struct LightParameters
 
     LightParameters(MaterialParam& material, DirectLight& directLight, std::vector<PointLight>& pointLights, SpotLight& spotLight)
         : mMaterial(material), mDirectLight(directLight), mSpotLight(spotLight) {
-        int pointCount = std::min(pointLights.size(), (size_t)4);
+        int pointCount = std::min(pointLights.size(), PointLightUniforms::kCount);
         if (pointCount == 0) {
             std::cout << "Must contain a point param at least" << std::endl;
             return;
@@ -136,36 +184,53 @@ public:
 };
 
 
+// ɫӵprogramֻƶʱͷ
 class Shader
 {
 public:
-    // shaderID
-    unsigned int mID;
-
     // ȡɫ
     Shader(const char* vertexPath, const char* fragmentPath);
+    ~Shader() { GpuResources::Get().Release(mProgram); }
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+    Shader(Shader&& other) noexcept { *this = std::move(other); }
+    Shader& operator=(Shader&& other) noexcept;
+    // ֱԴ빹ɫʱɵshader
+    static Shader FromSource(const std::string& vertexCode, const std::string& fragmentCode);
+    // shaderIDͷźΪ0
+    unsigned int GetID() const { return GpuResources::Get().Resolve(mProgram); }
+    // Ƭɫļ·Դ빹ʱΪ
+    const std::string& GetFragmentPath() const { return mFragmentPath; }
     // ʹ/
     void use();
-    // uniformߺ
-    void setBool(const std::string& name, bool value) const;
-    void setInt(const std::string& name, int value) const;
-    void setFloat(const std::string& name, float value) const;
-    void setVec2(const std::string& name, const glm::vec2& value) const;
-    void setVec2(const std::string& name, float x, float y) const;
-    void setVec3(const std::string& name, const glm::vec3& value) const;
-    void setVec3(const std::string& name, float x, float y, float z) const;
-    void setVec4(const std::string& name, const glm::vec4& value) const;
-    void setVec4(const std::string& name, float x, float y, float z, float w) const;
-    void setMat2(const std::string& name, const glm::mat2& mat) const;
-    void setMat3(const std::string& name, const glm::mat3& mat) const;
-    void setMat4(const std::string& name, const glm::mat4& mat) const;
+    // uniformߺַֿ"name"_uidڱڼϣʱ
+    void setBool(UniformName name, bool value) const;
+    void setInt(UniformName name, int value) const;
+    void setFloat(UniformName name, float value) const;
+    void setVec2(UniformName name, const glm::vec2& value) const;
+    void setVec2(UniformName name, float x, float y) const;
+    void setVec3(UniformName name, const glm::vec3& value) const;
+    void setVec3(UniformName name, float x, float y, float z) const;
+    void setVec4(UniformName name, const glm::vec4& value) const;
+    void setVec4(UniformName name, float x, float y, float z, float w) const;
+    void setMat2(UniformName name, const glm::mat2& mat) const;
+    void setMat3(UniformName name, const glm::mat3& mat) const;
+    void setMat4(UniformName name, const glm::mat4& mat) const;
 private:
-    // utility function for checking shader compilation/linking errors.
-    void checkCompileErrors(unsigned int shader, std::string type);
+    Shader() = default;
+    // 벢ɫlabelй©
+    void compile(const char* vShaderCode, const char* fShaderCode, const std::string& label);
+    void setUniform(const UniformName& name, UniformType type, const void* data) const;
+    int getLocation(const UniformName& name) const;
+
+    ProgramHandle mProgram;
+    std::string mFragmentPath;
+    // Ӻuniform(ֹϣ, λ)ϣ
+    std::vector<std::pair<std::uint32_t, int>> mUniformLocations;
 };
 
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath)
+Shader::Shader(const char* vertexPath, const char* fragmentPath) : mFragmentPath(fragmentPath)
 {
     // 1. ļ·лȡ/Ƭɫ
     std::string vertexCode;
@@ -196,116 +261,129 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
         std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
         return;
     }
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-
-    // 2. ɫ
-    unsigned int vertex, fragment;
-
-    // ɫ
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    // ӡеĻ
-    checkCompileErrors(vertex, "VERTEX");
-
-    // ƬɫҲ
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    checkCompileErrors(fragment, "FRAGMENT");
-
-    // ɫ
-    mID = glCreateProgram();
-    glAttachShader(mID, vertex);
-    glAttachShader(mID, fragment);
-    glLinkProgram(mID);
-    // ӡӴеĻ
-    checkCompileErrors(mID, "PROGRAM");
-
-    // ɾɫѾӵǵĳˣѾҪ
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    compile(vertexCode.c_str(), fragmentCode.c_str(), vertexPath);
+}
+
+Shader Shader::FromSource(const std::string& vertexCode, const std::string& fragmentCode)
+{
+    Shader shader;
+    shader.compile(vertexCode.c_str(), fragmentCode.c_str(), "generated shader");
+    return shader;
+}
+
+Shader& Shader::operator=(Shader&& other) noexcept
+{
+    if (this != &other) {
+        GpuResources::Get().Release(mProgram);
+        mProgram = other.mProgram;
+        mFragmentPath = std::move(other.mFragmentPath);
+        mUniformLocations = std::move(other.mUniformLocations);
+        other.mProgram = {};
+    }
+    return *this;
+}
+
+void Shader::compile(const char* vShaderCode, const char* fShaderCode, const std::string& label)
+{
+    PROFILE_SCOPE("Shader compile");
+    RenderDevice& device = RenderDevice::Get();
+    std::uint32_t program = device.CreateProgram(vShaderCode, fShaderCode);
+    GpuResources::Get().Release(mProgram);
+    mProgram = GpuResources::Get().Add<GpuResourceType::program>(program, 0, label);
+
+    // ֵĹϣuniformλãϣͻʱֶUniformIdãͻĹϣֻһλΪ-1
+    std::vector<DeviceUniform> uniforms = device.GetActiveUniforms(program);
+    std::vector<std::pair<std::uint32_t, const DeviceUniform*>> hashes;
+    for (auto&& uniform : uniforms) {
+        hashes.emplace_back(UniformId(uniform.mName.c_str()).mHash, &uniform);
+    }
+    std::sort(hashes.begin(), hashes.end(), [](auto&& a, auto&& b) { return a.first < b.first; });
+    mUniformLocations.clear();
+    for (std::size_t i = 0; i < hashes.size(); i++) {
+        if (!mUniformLocations.empty() && mUniformLocations.back().first == hashes[i].first) {
+            std::cout << "ERROR::SHADER::UNIFORM_HASH_COLLISION: " << hashes[i - 1].second->mName << " and " << hashes[i].second->mName << std::endl;
+            mUniformLocations.back().second = -1;
+            continue;
+        }
+        mUniformLocations.emplace_back(hashes[i].first, hashes[i].second->mLocation);
+    }
 }
 
 void Shader::use()
 {
-    glUseProgram(mID);
+    RenderDevice::Get().BindProgram(GetID());
+    RenderStats::Get().mProgramBinds++;
 }
 
-void Shader::setBool(const std::string& name, bool value) const
+int Shader::getLocation(const UniformName& name) const
 {
-    glUniform1i(glGetUniformLocation(mID, name.c_str()), (int)value);
+    auto found = std::lower_bound(mUniformLocations.begin(), mUniformLocations.end(), std::make_pair(name.mId.mHash, std::numeric_limits<int>::min()));
+    if (found != mUniformLocations.end() && found->first == name.mId.mHash) {
+        return found->second;
+    }
+    // ûзϢʱպˣֲѯshaderûõuniformΪ-1ʱᱻ
+    if (mUniformLocations.empty() && name.mText) {
+        return RenderDevice::Get().GetUniformLocation(GetID(), name.mText);
+    }
+    return -1;
 }
-void Shader::setInt(const std::string& name, int value) const
+
+void Shader::setUniform(const UniformName& name, UniformType type, const void* data) const
 {
-    glUniform1i(glGetUniformLocation(mID, name.c_str()), value);
+    RenderDevice::Get().SetUniform(getLocation(name), type, data);
+    RenderStats::Get().AddUniform(GetUniformTypeSize(type));
 }
-void Shader::setFloat(const std::string& name, float value) const
+
+void Shader::setBool(UniformName name, bool value) const
 {
-    glUniform1f(glGetUniformLocation(mID, name.c_str()), value);
+    int intValue = value;
+    setUniform(name, UniformType::int1, &intValue);
 }
-// ------------------------------------------------------------------------
-void Shader::setVec2(const std::string& name, const glm::vec2& value) const
+void Shader::setInt(UniformName name, int value) const
 {
-    glUniform2fv(glGetUniformLocation(mID, name.c_str()), 1, glm::value_ptr(value));
+    setUniform(name, UniformType::int1, &value);
 }
-void Shader::setVec2(const std::string& name, float x, float y) const
+void Shader::setFloat(UniformName name, float value) const
 {
-    glUniform2f(glGetUniformLocation(mID, name.c_str()), x, y);
+    setUniform(name, UniformType::float1, &value);
 }
 // ------------------------------------------------------------------------
-void Shader::setVec3(const std::string& name, const glm::vec3& value) const
+void Shader::setVec2(UniformName name, const glm::vec2& value) const
 {
-    glUniform3fv(glGetUniformLocation(mID, name.c_str()), 1, glm::value_ptr(value));
+    setUniform(name, UniformType::float2, glm::value_ptr(value));
 }
-void Shader::setVec3(const std::string& name, float x, float y, float z) const
+void Shader::setVec2(UniformName name, float x, float y) const
 {
-    glUniform3f(glGetUniformLocation(mID, name.c_str()), x, y, z);
+    setVec2(name, glm::vec2(x, y));
 }
 // ------------------------------------------------------------------------
-void Shader::setVec4(const std::string& name, const glm::vec4& value) const
+void Shader::setVec3(UniformName name, const glm::vec3& value) const
 {
-    glUniform4fv(glGetUniformLocation(mID, name.c_str()), 1, glm::value_ptr(value));
+    setUniform(name, UniformType::float3, glm::value_ptr(value));
 }
-void Shader::setVec4(const std::string& name, float x, float y, float z, float w) const
+void Shader::setVec3(UniformName name, float x, float y, float z) const
 {
-    glUniform4f(glGetUniformLocation(mID, name.c_str()), x, y, z, w);
+    setVec3(name, glm::vec3(x, y, z));
 }
 // ------------------------------------------------------------------------
-void Shader::setMat2(const std::string& name, const glm::mat2& mat) const
+void Shader::setVec4(UniformName name, const glm::vec4& value) const
 {
-    glUniformMatrix2fv(glGetUniformLocation(mID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    setUniform(name, UniformType::float4, glm::value_ptr(value));
 }
-void Shader::setMat3(const std::string& name, const glm::mat3& mat) const
+void Shader::setVec4(UniformName name, float x, float y, float z, float w) const
 {
-    glUniformMatrix3fv(glGetUniformLocation(mID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    setVec4(name, glm::vec4(x, y, z, w));
 }
-void Shader::setMat4(const std::string& name, const glm::mat4& mat) const
+// ------------------------------------------------------------------------
+void Shader::setMat2(UniformName name, const glm::mat2& mat) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(mID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    setUniform(name, UniformType::mat2, glm::value_ptr(mat));
 }
-
-void Shader::checkCompileErrors(unsigned int shader, std::string type)
+void Shader::setMat3(UniformName name, const glm::mat3& mat) const
 {
-    int success;
-    char infoLog[1024];
-    if (type != "PROGRAM")
-    {
-        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-        if (!success)
-        {
-            glGetShaderInfoLog(shader, 1024, NULL, infoLog);
-            std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
-        }
-    }
-    else
-    {
-        glGetProgramiv(shader, GL_LINK_STATUS, &success);
-        if (!success)
-        {
-            glGetProgramInfoLog(shader, 1024, NULL, infoLog);
-            std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
-        }
-    }
+    setUniform(name, UniformType::mat3, glm::value_ptr(mat));
+}
+void Shader::setMat4(UniformName name, const glm::mat4& mat) const
+{
+    setUniform(name, UniformType::mat4, glm::value_ptr(mat));
 }
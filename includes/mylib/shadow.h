@@ -0,0 +1,265 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <mylib/shader_s.h>
+
+
+// ļӰ
+// ׶尴ֳɼΣÿðΧһͶӰӰͼȫһ
+// ÿ㣺̬ĻʹõӰ
+//   㸲ǵķΧȰΧһȦĶ뵽أֻаΧƳ淶ΧԴ仯
+//   ߵInvalidateStaticʱȾ̬
+//   ÿ֡ѻ㸴ƵӰ㣬ƶ̬
+// ͶӰֻڻƶʱ仯Ƕ뵽أƶתʱӰԵ˸
+class CascadedShadowMap {
+public:
+    static const std::uint32_t kMaxCascades = 4;
+
+    // shadowDistanceΪӰԶ룬splitLambdaھȻֺͶֵ֮
+    CascadedShadowMap(int resolution = 2048, std::uint32_t cascadeCount = 4, float shadowDistance = 50.0f, float splitLambda = 0.75f);
+
+    // ÿͶӰlightDirectionΪķ
+    void Update(const glm::vec3& lightDirection, const ModelRenderParam& cameraParam);
+    // ̬仯ãһRenderʱȾл
+    void InvalidateStatic();
+
+    // ȾӰͼdrawStaticdrawDynamicĲΪ(Shader& depthShader, ModelRenderParam& lightParam)
+    // lightParamviewprojectionѾΪԴľֻģͱ任
+    template<typename StaticFunc, typename DynamicFunc>
+    void Render(Shader& depthShader, const ModelRenderParam& cameraParam, const StaticFunc& drawStatic, const DynamicFunc& drawDynamic);
+
+    // Ӱunitshaderеļ
+    void Bind(Shader& shader, int unit);
+
+    // һRenderȾľ̬
+    std::uint32_t GetStaticRenderCount() const { return mStaticRenderCount; }
+
+private:
+    struct Cascade
+    {
+        float mSplitFar;           // ͼռеԶ
+        float mRadius;             // 㸲ǵİ뾶
+        glm::vec3 mCacheCenter;    // ڹԴռе
+        float mDepthRange;         // ڹԴϵİ볤
+        glm::mat4 mLightSpace;
+        bool mStaticValid = false;
+    };
+
+    int mResolution;
+    std::uint32_t mCascadeCount;
+    float mShadowDistance;
+    float mSplitLambda;
+
+    Cascade mCascades[kMaxCascades];
+    glm::vec3 mLightDirection = glm::vec3(0.0f);
+    glm::mat4 mLightView = glm::mat4(1.0f);
+    glm::mat4 mCameraView = glm::mat4(1.0f);
+    std::uint32_t mStaticRenderCount = 0;
+
+    unsigned int mStaticTexture;
+    unsigned int mShadowTexture;
+    unsigned int mStaticFBOs[kMaxCascades];
+    unsigned int mShadowFBOs[kMaxCascades];
+
+    unsigned int _createDepthArray(bool compare);
+};
+
+CascadedShadowMap::CascadedShadowMap(int resolution, std::uint32_t cascadeCount, float shadowDistance, float splitLambda)
+    : mResolution(resolution), mCascadeCount(std::min(cascadeCount, kMaxCascades)), mShadowDistance(shadowDistance), mSplitLambda(splitLambda)
+{
+    mStaticTexture = _createDepthArray(false);
+    mShadowTexture = _createDepthArray(true);
+
+    glGenFramebuffers(mCascadeCount, mStaticFBOs);
+    glGenFramebuffers(mCascadeCount, mShadowFBOs);
+    for (std::uint32_t i = 0; i < mCascadeCount; i++) {
+        glBindFramebuffer(GL_FRAMEBUFFER, mStaticFBOs[i]);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, mStaticTexture, 0, i);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "Create shadow cache frame buffer error!" << std::endl;
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, mShadowFBOs[i]);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, mShadowTexture, 0, i);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "Create shadow frame buffer error!" << std::endl;
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+unsigned int CascadedShadowMap::_createDepthArray(bool compare)
+{
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, mResolution, mResolution, mCascadeCount, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, compare ? GL_LINEAR : GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, compare ? GL_LINEAR : GL_NEAREST);
+    // Ӱͼ֮ûڵ
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    const float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+    if (compare) {
+        // ӲȱȽϣԹ˵õ2x2PCF
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    return texture;
+}
+
+void CascadedShadowMap::InvalidateStatic()
+{
+    for (std::uint32_t i = 0; i < mCascadeCount; i++) {
+        mCascades[i].mStaticValid = false;
+    }
+}
+
+void CascadedShadowMap::Update(const glm::vec3& lightDirection, const ModelRenderParam& cameraParam)
+{
+    mCameraView = cameraParam.mViewMat;
+
+    // Դ仯л涼ʧЧ
+    glm::vec3 direction = glm::normalize(lightDirection);
+    if (direction != mLightDirection) {
+        mLightDirection = direction;
+        glm::vec3 up = std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        mLightView = glm::lookAt(glm::vec3(0.0f), direction, up);
+        InvalidateStatic();
+    }
+
+    // ͶӰȡƽҰ
+    const glm::mat4& proj = cameraParam.mProjMat;
+    float nearPlane = proj[3][2] / (proj[2][2] - 1.0f);
+    float tanHalfY = 1.0f / proj[1][1];
+    float tanHalfX = 1.0f / proj[0][0];
+    glm::mat4 invView = glm::inverse(cameraParam.mViewMat);
+
+    float splitNear = nearPlane;
+    for (std::uint32_t i = 0; i < mCascadeCount; i++) {
+        Cascade& cascade = mCascades[i];
+
+        // ֺ;ȻֵĲֵ
+        float t = static_cast<float>(i + 1) / mCascadeCount;
+        float logSplit = nearPlane * std::pow(mShadowDistance / nearPlane, t);
+        float uniformSplit = nearPlane + (mShadowDistance - nearPlane) * t;
+        float splitFar = mSplitLambda * logSplit + (1.0f - mSplitLambda) * uniformSplit;
+        cascade.mSplitFar = splitFar;
+
+        // ׶һεİΧֻ;йأתʱ뾶
+        glm::vec3 corners[8];
+        for (int c = 0; c < 8; c++) {
+            float depth = (c & 4) ? splitFar : splitNear;
+            corners[c] = glm::vec3(invView * glm::vec4(
+                ((c & 1) ? 1.0f : -1.0f) * tanHalfX * depth, ((c & 2) ? 1.0f : -1.0f) * tanHalfY * depth, -depth, 1.0f));
+        }
+        glm::vec3 center(0.0f);
+        for (auto&& corner : corners) {
+            center += corner / 8.0f;
+        }
+        float radius = 0.0f;
+        for (auto&& corner : corners) {
+            radius = std::max(radius, glm::length(corner - center));
+        }
+        // 뾶ȡ⸡»淴ƶ
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+        splitNear = splitFar;
+
+        // า25%ΧڷΧƶʱҪȾ
+        // Դ϶mShadowDistanceΧ֮ҲͶӰ
+        float cacheRadius = radius * 1.25f;
+        float depthRange = cacheRadius + mShadowDistance;
+        glm::vec3 lightCenter = glm::vec3(mLightView * glm::vec4(center, 1.0f));
+        bool inside = cascade.mStaticValid && cascade.mRadius == cacheRadius
+            && std::abs(lightCenter.x - cascade.mCacheCenter.x) + radius <= cacheRadius
+            && std::abs(lightCenter.y - cascade.mCacheCenter.y) + radius <= cacheRadius
+            && std::abs(lightCenter.z - cascade.mCacheCenter.z) <= mShadowDistance * 0.5f;
+        if (inside) {
+            continue;
+        }
+
+        // Ķ뵽
+        float texelSize = 2.0f * cacheRadius / mResolution;
+        cascade.mRadius = cacheRadius;
+        cascade.mDepthRange = depthRange;
+        cascade.mCacheCenter = glm::vec3(std::floor(lightCenter.x / texelSize) * texelSize,
+            std::floor(lightCenter.y / texelSize) * texelSize, lightCenter.z);
+        glm::mat4 lightProj = glm::ortho(cascade.mCacheCenter.x - cacheRadius, cascade.mCacheCenter.x + cacheRadius,
+            cascade.mCacheCenter.y - cacheRadius, cascade.mCacheCenter.y + cacheRadius,
+            -cascade.mCacheCenter.z - depthRange, -cascade.mCacheCenter.z + depthRange);
+        cascade.mLightSpace = lightProj * mLightView;
+        cascade.mStaticValid = false;
+    }
+}
+
+template<typename StaticFunc, typename DynamicFunc>
+void CascadedShadowMap::Render(Shader& depthShader, const ModelRenderParam& cameraParam, const StaticFunc& drawStatic, const DynamicFunc& drawDynamic)
+{
+    // ݺ͵ذĵҲҪͶӰԲ޳öƫƼӰ
+    glViewport(0, 0, mResolution, mResolution);
+    glEnable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_BLEND);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(2.0f, 4.0f);
+
+    mStaticRenderCount = 0;
+    ModelRenderParam lightParam = cameraParam;
+    lightParam.mViewMat = glm::mat4(1.0f);
+    for (std::uint32_t i = 0; i < mCascadeCount; i++) {
+        Cascade& cascade = mCascades[i];
+        lightParam.mProjMat = cascade.mLightSpace;
+
+        if (!cascade.mStaticValid) {
+            glBindFramebuffer(GL_FRAMEBUFFER, mStaticFBOs[i]);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            drawStatic(depthShader, lightParam);
+            cascade.mStaticValid = true;
+            mStaticRenderCount++;
+        }
+
+        // ƻ㣬ٵӶ̬
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, mStaticFBOs[i]);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mShadowFBOs[i]);
+        glBlitFramebuffer(0, 0, mResolution, mResolution, 0, 0, mResolution, mResolution, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, mShadowFBOs[i]);
+        drawDynamic(depthShader, lightParam);
+    }
+
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glEnable(GL_CULL_FACE);
+    glEnable(GL_BLEND);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void CascadedShadowMap::Bind(Shader& shader, int unit)
+{
+    // Ƚģʽϣв
+    RenderDevice::Get().BindTexture(unit, DeviceTextureType::texture2DArray, mShadowTexture);
+
+    shader.setInt("shadowMap"_uid, unit);
+    shader.setInt("cascadeCount"_uid, static_cast<int>(mCascadeCount));
+    shader.setMat4("shadowCameraView"_uid, mCameraView);
+    static constexpr auto kLightSpaceMatrices = MakeUniformIdArray<kMaxCascades>("lightSpaceMatrices", "");
+    static constexpr auto kCascadeSplits = MakeUniformIdArray<kMaxCascades>("cascadeSplits", "");
+    static constexpr auto kCascadeTexelSizes = MakeUniformIdArray<kMaxCascades>("cascadeTexelSizes", "");
+    for (std::uint32_t i = 0; i < mCascadeCount; i++) {
+        shader.setMat4(kLightSpaceMatrices[i], mCascades[i].mLightSpace);
+        shader.setFloat(kCascadeSplits[i], mCascades[i].mSplitFar);
+        // ߷ƫȡһصĴС
+        shader.setFloat(kCascadeTexelSizes[i], 2.0f * mCascades[i].mRadius / mResolution);
+    }
+}
@@ -0,0 +1,769 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <stb_image.h>
+#include <mylib/shader_s.h>
+#include <mylib/mesh.h>
+#include <mylib/job_system.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFT_RASTER_SSE2 1
+#endif
+
+
+// դõ4·㣬֧SSE2ʱʹSIMD
+struct SoftFloat4
+{
+#ifdef SOFT_RASTER_SSE2
+    __m128 mValue;
+
+    SoftFloat4() = default;
+    SoftFloat4(__m128 value) : mValue(value) {}
+    SoftFloat4(float value) : mValue(_mm_set1_ps(value)) {}
+    SoftFloat4(float x, float y, float z, float w) : mValue(_mm_setr_ps(x, y, z, w)) {}
+
+    static SoftFloat4 Load(const float* values) { return _mm_loadu_ps(values); }
+    void Store(float* values) const { _mm_storeu_ps(values, mValue); }
+    friend SoftFloat4 operator+(SoftFloat4 a, SoftFloat4 b) { return _mm_add_ps(a.mValue, b.mValue); }
+    friend SoftFloat4 operator*(SoftFloat4 a, SoftFloat4 b) { return _mm_mul_ps(a.mValue, b.mValue); }
+    // ȽϽΪÿ·룬Maskȡÿ·Ľi·Ӧiλ
+    friend SoftFloat4 operator>(SoftFloat4 a, SoftFloat4 b) { return _mm_cmpgt_ps(a.mValue, b.mValue); }
+    friend SoftFloat4 operator<(SoftFloat4 a, SoftFloat4 b) { return _mm_cmplt_ps(a.mValue, b.mValue); }
+    friend SoftFloat4 operator==(SoftFloat4 a, SoftFloat4 b) { return _mm_cmpeq_ps(a.mValue, b.mValue); }
+    friend SoftFloat4 operator&(SoftFloat4 a, SoftFloat4 b) { return _mm_and_ps(a.mValue, b.mValue); }
+    friend SoftFloat4 operator|(SoftFloat4 a, SoftFloat4 b) { return _mm_or_ps(a.mValue, b.mValue); }
+    int Mask() const { return _mm_movemask_ps(mValue); }
+#else
+    float mValue[4];
+
+    SoftFloat4() = default;
+    SoftFloat4(float value) : mValue{ value, value, value, value } {}
+    SoftFloat4(float x, float y, float z, float w) : mValue{ x, y, z, w } {}
+
+    static SoftFloat4 Load(const float* values) { return SoftFloat4(values[0], values[1], values[2], values[3]); }
+    void Store(float* values) const { std::memcpy(values, mValue, sizeof(mValue)); }
+    template<typename Op>
+    static SoftFloat4 _apply(const SoftFloat4& a, const SoftFloat4& b, Op op)
+    {
+        return SoftFloat4(op(a.mValue[0], b.mValue[0]), op(a.mValue[1], b.mValue[1]), op(a.mValue[2], b.mValue[2]), op(a.mValue[3], b.mValue[3]));
+    }
+    static float _mask(bool value) { float mask; std::uint32_t bits = value ? ~0u : 0u; std::memcpy(&mask, &bits, 4); return mask; }
+    static bool _bit(float value) { std::uint32_t bits; std::memcpy(&bits, &value, 4); return bits != 0; }
+    friend SoftFloat4 operator+(SoftFloat4 a, SoftFloat4 b) { return _apply(a, b, [](float x, float y) { return x + y; }); }
+    friend SoftFloat4 operator*(SoftFloat4 a, SoftFloat4 b) { return _apply(a, b, [](float x, float y) { return x * y; }); }
+    friend SoftFloat4 operator>(SoftFloat4 a, SoftFloat4 b) { return _apply(a, b, [](float x, float y) { return _mask(x > y); }); }
+    friend SoftFloat4 operator<(SoftFloat4 a, SoftFloat4 b) { return _apply(a, b, [](float x, float y) { return _mask(x < y); }); }
+    friend SoftFloat4 operator==(SoftFloat4 a, SoftFloat4 b) { return _apply(a, b, [](float x, float y) { return _mask(x == y); }); }
+    friend SoftFloat4 operator&(SoftFloat4 a, SoftFloat4 b) { return _apply(a, b, [](float x, float y) { return _mask(_bit(x) && _bit(y)); }); }
+    friend SoftFloat4 operator|(SoftFloat4 a, SoftFloat4 b) { return _apply(a, b, [](float x, float y) { return _mask(_bit(x) || _bit(y)); }); }
+    int Mask() const { return _bit(mValue[0]) | _bit(mValue[1]) << 1 | _bit(mValue[2]) << 2 | _bit(mValue[3]) << 3; }
+#endif
+};
+
+
+// դõRGBA8ʱúʽ˲mipƷʽTextureFromFileһΪCLAMP_TO_EDGE
+class SoftTexture {
+public:
+    bool Load(const std::string& path);
+    int GetWidth() const { return mLevels.empty() ? 0 : mLevels[0].mWidth; }
+    int GetHeight() const { return mLevels.empty() ? 0 : mLevels[0].mHeight; }
+    // lodΪmip֮Բֵ
+    glm::vec4 Sample(const glm::vec2& uv, float lod) const;
+
+private:
+    struct Level
+    {
+        int mWidth;
+        int mHeight;
+        std::vector<std::uint8_t> mTexels;
+    };
+    std::vector<Level> mLevels;
+
+    glm::vec4 _bilinear(const Level& level, const glm::vec2& uv) const;
+};
+
+bool SoftTexture::Load(const std::string& path)
+{
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load(true);
+    std::uint8_t* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+    if (!data) {
+        std::cout << "Failed to load texture: " << path << std::endl;
+        return false;
+    }
+
+    // GLĸʽתһ£ͨΪ(r, 0, 0, 1)ͨalphaΪ1
+    Level base = { width, height, std::vector<std::uint8_t>(static_cast<std::size_t>(width) * height * 4) };
+    for (std::size_t i = 0; i < static_cast<std::size_t>(width) * height; i++) {
+        const std::uint8_t* src = data + i * channels;
+        std::uint8_t* dst = &base.mTexels[i * 4];
+        dst[0] = src[0];
+        dst[1] = channels > 1 ? src[1] : 0;
+        dst[2] = channels > 2 ? src[2] : 0;
+        dst[3] = channels > 3 ? src[3] : 255;
+    }
+    stbi_image_free(data);
+
+    mLevels.clear();
+    mLevels.push_back(std::move(base));
+    while (mLevels.back().mWidth > 1 || mLevels.back().mHeight > 1) {
+        const Level& src = mLevels.back();
+        Level dst = { std::max(1, src.mWidth / 2), std::max(1, src.mHeight / 2), {} };
+        dst.mTexels.resize(static_cast<std::size_t>(dst.mWidth) * dst.mHeight * 4);
+        for (int y = 0; y < dst.mHeight; y++) {
+            int y0 = std::min(y * 2, src.mHeight - 1);
+            int y1 = std::min(y * 2 + 1, src.mHeight - 1);
+            for (int x = 0; x < dst.mWidth; x++) {
+                int x0 = std::min(x * 2, src.mWidth - 1);
+                int x1 = std::min(x * 2 + 1, src.mWidth - 1);
+                for (int c = 0; c < 4; c++) {
+                    int sum = src.mTexels[(y0 * src.mWidth + x0) * 4 + c] + src.mTexels[(y0 * src.mWidth + x1) * 4 + c]
+                        + src.mTexels[(y1 * src.mWidth + x0) * 4 + c] + src.mTexels[(y1 * src.mWidth + x1) * 4 + c];
+                    dst.mTexels[(y * dst.mWidth + x) * 4 + c] = static_cast<std::uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+        mLevels.push_back(std::move(dst));
+    }
+    return true;
+}
+
+glm::vec4 SoftTexture::_bilinear(const Level& level, const glm::vec2& uv) const
+{
+    float x = uv.x * level.mWidth - 0.5f;
+    float y = uv.y * level.mHeight - 0.5f;
+    float fx = std::floor(x);
+    float fy = std::floor(y);
+    int x0 = std::min(std::max(static_cast<int>(fx), 0), level.mWidth - 1);
+    int y0 = std::min(std::max(static_cast<int>(fy), 0), level.mHeight - 1);
+    int x1 = std::min(std::max(static_cast<int>(fx) + 1, 0), level.mWidth - 1);
+    int y1 = std::min(std::max(static_cast<int>(fy) + 1, 0), level.mHeight - 1);
+    float tx = x - fx;
+    float ty = y - fy;
+
+    auto texel = [&level](int x, int y) {
+        const std::uint8_t* t = &level.mTexels[(static_cast<std::size_t>(y) * level.mWidth + x) * 4];
+        return glm::vec4(t[0], t[1], t[2], t[3]);
+    };
+    glm::vec4 top = glm::mix(texel(x0, y0), texel(x1, y0), tx);
+    glm::vec4 bottom = glm::mix(texel(x0, y1), texel(x1, y1), tx);
+    return glm::mix(top, bottom, ty) * (1.0f / 255.0f);
+}
+
+glm::vec4 SoftTexture::Sample(const glm::vec2& uv, float lod) const
+{
+    if (mLevels.empty()) {
+        return glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+    lod = std::min(std::max(lod, 0.0f), static_cast<float>(mLevels.size() - 1));
+    int level = static_cast<int>(lod);
+    float t = lod - level;
+    glm::vec4 color = _bilinear(mLevels[level], uv);
+    if (t > 0.0f) {
+        color = glm::mix(color, _bilinear(mLevels[level + 1], uv), t);
+    }
+    return color;
+}
+
+
+// ·Ѿص
+class SoftTextureCache {
+public:
+    // ʧʱnullptr
+    const SoftTexture* Load(const std::string& path);
+
+private:
+    std::map<std::string, std::unique_ptr<SoftTexture>> mTextures;
+};
+
+const SoftTexture* SoftTextureCache::Load(const std::string& path)
+{
+    auto found = mTextures.find(path);
+    if (found == mTextures.end()) {
+        std::unique_ptr<SoftTexture> texture(new SoftTexture());
+        if (!texture->Load(path)) {
+            texture.reset();
+        }
+        found = mTextures.emplace(path, std::move(texture)).first;
+    }
+    return found->second.get();
+}
+
+
+// shaderĹ̶ܰ汾ʱGetSoftShaderModeʹõShaderõ
+// phongΪ⡢Դ͸ľ۹ƣunlitֱɫ
+enum class SoftShading { phong, unlit };
+// opaqueϣalphaTestalphaС0.1أalphaBlendalphaϣGL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHAһ
+enum class SoftBlendMode { opaque, alphaTest, alphaBlend };
+
+struct SoftShaderMode
+{
+    SoftShading mShading = SoftShading::phong;
+    SoftBlendMode mBlendMode = SoftBlendMode::opaque;
+};
+
+// ƬɫļҶӦɫʽûжӦ汾shaderphongϴʾһ
+SoftShaderMode GetSoftShaderMode(const Shader& shader)
+{
+    static const std::pair<const char*, SoftShaderMode> modes[] = {
+        { "shader_2_obj.fs", { SoftShading::phong, SoftBlendMode::opaque } },
+        { "shader_2_light.fs", { SoftShading::unlit, SoftBlendMode::opaque } },
+        { "shader_3_obj_2.fs", { SoftShading::unlit, SoftBlendMode::alphaTest } },
+        { "shader_3_obj_3.fs", { SoftShading::unlit, SoftBlendMode::alphaBlend } },
+    };
+    // ֻȽ·һΣÿλƶңԲµַ
+    const std::string& path = shader.GetFragmentPath();
+    for (auto&& mode : modes) {
+        std::size_t length = std::strlen(mode.first);
+        if (path.size() >= length && path.compare(path.size() - length, length, mode.first) == 0
+            && (path.size() == length || path[path.size() - length - 1] == '/' || path[path.size() - length - 1] == '\\')) {
+            return mode.second;
+        }
+    }
+    static bool warned = false;
+    if (!warned) {
+        warned = true;
+        std::cout << "SoftRenderer: no software version of " << (path.empty() ? "generated shader" : path) << ", using phong" << std::endl;
+    }
+    return SoftShaderMode();
+}
+
+// Ĳʣ
+struct SoftMaterial
+{
+    const SoftTexture* mDiffuse = nullptr;    // ΪʱʹmColor
+    const SoftTexture* mSpecular = nullptr;   // Ϊʱûо⣬GLûаʱΪ0һ
+    glm::vec4 mColor = glm::vec4(1.0f);
+    float mShininess = 32.0f;
+};
+
+
+// դõ񣬴MeshCPUݸƣMeshҪMeshResidency::cpuRetained
+struct SoftMesh
+{
+    struct SoftVertex
+    {
+        glm::vec3 mPosition;
+        glm::vec3 mNormal;
+        glm::vec2 mTexCoords;
+    };
+
+    std::vector<SoftVertex> mVertices;
+    std::vector<std::uint32_t> mIndices;
+    SoftMaterial mMaterial;
+
+    SoftMesh() = default;
+    // һtexture_diffusetexture_specularΪʵdirectoryΪ·Ŀ¼
+    SoftMesh(const Mesh& mesh, SoftTextureCache& textures, const std::string& directory = "");
+};
+
+SoftMesh::SoftMesh(const Mesh& mesh, SoftTextureCache& textures, const std::string& directory)
+    : mIndices(mesh.GetIndices().begin(), mesh.GetIndices().end())
+{
+    if (mesh.GetIndexCount() > 0 && mesh.GetIndices().empty()) {
+        std::cout << "SoftMesh: mesh has no CPU data, create it with MeshResidency::cpuRetained" << std::endl;
+    }
+    mVertices.reserve(mesh.GetVertices().size());
+    for (auto&& vertex : mesh.GetVertices()) {
+        mVertices.push_back({ vertex.Position, vertex.Normal, vertex.TexCoords });
+    }
+    for (auto&& texture : mesh.mTextures) {
+        std::string path = directory.empty() ? std::string(texture.path.C_Str()) : directory + '/' + texture.path.C_Str();
+        if (texture.type == "texture_diffuse" && !mMaterial.mDiffuse) {
+            mMaterial.mDiffuse = textures.Load(path);
+        }
+        else if (texture.type == "texture_specular" && !mMaterial.mSpecular) {
+            mMaterial.mSpecular = textures.Load(path);
+        }
+    }
+}
+
+
+// դͳ
+struct SoftRasterStats
+{
+    std::uint64_t mTriangles = 0;        // üͱ޳
+    std::uint64_t mBinnedTriangles = 0;  // ͼ֮
+    std::uint64_t mShadedPixels = 0;     // ͨȲԺɫ
+};
+
+
+// ͼĶ߳դ
+// Drawֻ任ƽü޳ȻΰΧзֵ64x64ͼ
+// RenderʱÿͼΪһJobSystemϲдͼڰύ˳դԻϵ˳GLһ
+// դÿδһе4أSIMDߺȣȲԣֻͨɫ
+// ϵGLһ£0棬ReadPixelsĽֱӺglReadPixelsȽ
+class SoftRenderer {
+public:
+    static const int kTileSize = 64;
+
+    SoftRenderer(int width, int height, JobSystem& jobSystem);
+
+    void Resize(int width, int height);
+    int GetWidth() const { return mWidth; }
+    int GetHeight() const { return mHeight; }
+
+    // ӦglEnable(GL_CULL_FACE)ʱΪ
+    void SetCullBackFace(bool cull) { mCullBackFace = cull; }
+    // رʱֻ0ûʹmipGLһ
+    void SetMipmapping(bool enabled) { mMipmapping = enabled; }
+    // ղ۹ƵλúͷSetCameraиModel::UpdateLightParamһ
+    void SetLights(const LightParameters& lights);
+    void SetCamera(const ModelRenderParam& modelRenderParam);
+
+    // ɫȺһ֡
+    void Clear(const glm::vec4& color);
+    // Model::DrawһָõshaderɫͻϷʽshader
+    void Draw(const SoftMesh& mesh, const Shader& shader, const glm::mat4& model);
+    // դύ
+    void Render();
+
+    // RGB8µУglReadPixels(GL_RGB, GL_UNSIGNED_BYTE)GL_PACK_ALIGNMENTΪ1ʱͬ
+    void ReadPixels(std::vector<std::uint8_t>& pixels) const;
+    const SoftRasterStats& GetStats() const { return mStats; }
+
+private:
+    // 任Ķ㣬Ѿ1/w͸Уֵ
+    struct ClipVertex
+    {
+        glm::vec4 mClip;
+        glm::vec3 mWorldPos;
+        glm::vec3 mNormal;
+        glm::vec2 mTexCoords;
+    };
+
+    struct Edge
+    {
+        // E(x, y) = mSign * (mA * x + (mB * y + mC))εĹ߰ͬĶ˳㣬ֻ֤
+        float mA, mB, mC, mSign;
+        bool mTopLeft;
+    };
+
+    struct Triangle
+    {
+        Edge mEdges[3];                     // mEdges[i]ΪiĶԱߣڲΪ
+        float mInvArea;
+        float mZ[3];
+        float mInvW[3];
+        glm::vec3 mWorldPos[3];             // ѳ1/w
+        glm::vec3 mNormal[3];
+        glm::vec2 mTexCoords[3];
+        glm::vec2 mDuvDx, mDuvDy;           // uv/wĻĵ
+        float mDqDx, mDqDy;                 // 1/wĻĵ
+        const SoftMaterial* mMaterial;
+        SoftShaderMode mMode;
+    };
+
+    JobSystem& mJobSystem;
+    int mWidth = 0;
+    int mHeight = 0;
+    int mTilesX = 0;
+    int mTilesY = 0;
+    int mStride = 0;                        // 尴ͼС룬4һдʱԽ
+    std::vector<float> mColor;              // RGBA01ÿдʱ8λ
+    std::vector<float> mDepth;
+
+    bool mCullBackFace = true;
+    bool mMipmapping = true;
+    std::unique_ptr<LightParameters> mLights;   // ûʱphongΪɫ
+    glm::mat4 mViewProj = glm::mat4(1.0f);
+    glm::vec3 mCameraPos = glm::vec3(0.0f);
+
+    std::vector<Triangle> mTriangles;
+    std::vector<std::vector<std::uint32_t>> mBins;
+    std::vector<ClipVertex> mClipVertices;
+    std::vector<std::uint64_t> mTileShadedPixels;
+    SoftRasterStats mStats;
+
+    void _setupTriangle(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c, const SoftMaterial& material, const SoftShaderMode& mode);
+    void _rasterizeTile(int tile);
+    glm::vec4 _shade(const Triangle& triangle, float l0, float l1, float l2) const;
+};
+
+SoftRenderer::SoftRenderer(int width, int height, JobSystem& jobSystem) : mJobSystem(jobSystem)
+{
+    Resize(width, height);
+}
+
+void SoftRenderer::Resize(int width, int height)
+{
+    mWidth = width;
+    mHeight = height;
+    mTilesX = (width + kTileSize - 1) / kTileSize;
+    mTilesY = (height + kTileSize - 1) / kTileSize;
+    mStride = mTilesX * kTileSize;
+    mColor.assign(static_cast<std::size_t>(mStride) * mTilesY * kTileSize * 4, 0.0f);
+    mDepth.assign(static_cast<std::size_t>(mStride) * mTilesY * kTileSize, 1.0f);
+    mBins.assign(static_cast<std::size_t>(mTilesX) * mTilesY, {});
+    mTileShadedPixels.assign(mBins.size(), 0);
+}
+
+void SoftRenderer::SetLights(const LightParameters& lights)
+{
+    mLights.reset(new LightParameters(lights));
+}
+
+void SoftRenderer::SetCamera(const ModelRenderParam& modelRenderParam)
+{
+    mViewProj = modelRenderParam.mProjMat * modelRenderParam.mViewMat;
+    mCameraPos = modelRenderParam.mCameraPos;
+    if (mLights) {
+        mLights->mSpotLight.mPosition = modelRenderParam.mCameraPos;
+        mLights->mSpotLight.mDirection = modelRenderParam.mCameraDir;
+    }
+}
+
+void SoftRenderer::Clear(const glm::vec4& color)
+{
+    // ɫͬ8λ
+    glm::vec4 quantized = glm::floor(glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f) / 255.0f;
+    for (std::size_t i = 0; i < mColor.size(); i += 4) {
+        mColor[i] = quantized.r;
+        mColor[i + 1] = quantized.g;
+        mColor[i + 2] = quantized.b;
+        mColor[i + 3] = quantized.a;
+    }
+    std::fill(mDepth.begin(), mDepth.end(), 1.0f);
+    mTriangles.clear();
+    for (auto&& bin : mBins) {
+        bin.clear();
+    }
+    mStats = SoftRasterStats();
+}
+
+void SoftRenderer::Draw(const SoftMesh& mesh, const Shader& shader, const glm::mat4& model)
+{
+    SoftShaderMode mode = GetSoftShaderMode(shader);
+    glm::mat4 mvp = mViewProj * model;
+    glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+
+    // 任ʱ
+    mClipVertices.resize(mesh.mVertices.size());
+    auto transform = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const SoftMesh::SoftVertex& vertex = mesh.mVertices[i];
+            ClipVertex& out = mClipVertices[i];
+            out.mClip = mvp * glm::vec4(vertex.mPosition, 1.0f);
+            out.mWorldPos = glm::vec3(model * glm::vec4(vertex.mPosition, 1.0f));
+            out.mNormal = normalMatrix * vertex.mNormal;
+            out.mTexCoords = vertex.mTexCoords;
+        }
+    };
+    if (mesh.mVertices.size() > 4096) {
+        mJobSystem.ParallelFor(mesh.mVertices.size(), 1024, transform);
+    }
+    else {
+        transform(0, mesh.mVertices.size());
+    }
+
+    for (std::size_t i = 0; i + 2 < mesh.mIndices.size(); i += 3) {
+        const ClipVertex* input[3] = {
+            &mClipVertices[mesh.mIndices[i]], &mClipVertices[mesh.mIndices[i + 1]], &mClipVertices[mesh.mIndices[i + 2]] };
+
+        // ýƽz = -wüıΣƽɰΧкȲԴ
+        ClipVertex clipped[4];
+        int count = 0;
+        for (int v = 0; v < 3; v++) {
+            const ClipVertex& current = *input[v];
+            const ClipVertex& next = *input[(v + 1) % 3];
+            float currentDistance = current.mClip.z + current.mClip.w;
+            float nextDistance = next.mClip.z + next.mClip.w;
+            if (currentDistance >= 0.0f) {
+                clipped[count++] = current;
+            }
+            if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f)) {
+                float t = currentDistance / (currentDistance - nextDistance);
+                ClipVertex& out = clipped[count++];
+                out.mClip = glm::mix(current.mClip, next.mClip, t);
+                out.mWorldPos = glm::mix(current.mWorldPos, next.mWorldPos, t);
+                out.mNormal = glm::mix(current.mNormal, next.mNormal, t);
+                out.mTexCoords = glm::mix(current.mTexCoords, next.mTexCoords, t);
+            }
+        }
+        for (int v = 1; v + 1 < count; v++) {
+            _setupTriangle(clipped[0], clipped[v], clipped[v + 1], mesh.mMaterial, mode);
+        }
+    }
+}
+
+void SoftRenderer::_setupTriangle(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c, const SoftMaterial& material, const SoftShaderMode& mode)
+{
+    const ClipVertex* vertices[3] = { &a, &b, &c };
+    glm::vec2 screen[3];
+    Triangle triangle;
+    for (int i = 0; i < 3; i++) {
+        const ClipVertex& vertex = *vertices[i];
+        if (vertex.mClip.w <= 0.0f) {
+            return;
+        }
+        float invW = 1.0f / vertex.mClip.w;
+        screen[i] = glm::vec2((vertex.mClip.x * invW * 0.5f + 0.5f) * mWidth, (vertex.mClip.y * invW * 0.5f + 0.5f) * mHeight);
+        triangle.mZ[i] = vertex.mClip.z * invW * 0.5f + 0.5f;
+        triangle.mInvW[i] = invW;
+        triangle.mWorldPos[i] = vertex.mWorldPos * invW;
+        triangle.mNormal[i] = vertex.mNormal * invW;
+        triangle.mTexCoords[i] = vertex.mTexCoords * invW;
+    }
+
+    // Ϊʱʱ룬
+    float area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) - (screen[2].x - screen[0].x) * (screen[1].y - screen[0].y);
+    if (area == 0.0f || (mCullBackFace && area < 0.0f)) {
+        return;
+    }
+    float orientation = area > 0.0f ? 1.0f : -1.0f;
+    triangle.mInvArea = 1.0f / std::abs(area);
+
+    for (int i = 0; i < 3; i++) {
+        glm::vec2 from = screen[(i + 1) % 3];
+        glm::vec2 to = screen[(i + 2) % 3];
+        // ʱڲڱߵࣻA > 0ΪߣA == 0B < 0Ϊϱ
+        float a = (from.y - to.y) * orientation;
+        float b = (to.x - from.x) * orientation;
+        Edge& edge = triangle.mEdges[i];
+        edge.mTopLeft = a > 0.0f || (a == 0.0f && b < 0.0f);
+        // ߰Ķ˳ϵ
+        bool swap = to.x < from.x || (to.x == from.x && to.y < from.y);
+        glm::vec2 p0 = swap ? to : from;
+        glm::vec2 p1 = swap ? from : to;
+        edge.mA = p0.y - p1.y;
+        edge.mB = p1.x - p0.x;
+        edge.mC = -(edge.mA * p0.x + edge.mB * p0.y);
+        edge.mSign = (swap ? -1.0f : 1.0f) * orientation;
+    }
+
+    // ͸УֵҪĵl_i = E_i / 
+    glm::vec3 dldx, dldy;
+    for (int i = 0; i < 3; i++) {
+        dldx[i] = triangle.mEdges[i].mA * triangle.mEdges[i].mSign * triangle.mInvArea;
+        dldy[i] = triangle.mEdges[i].mB * triangle.mEdges[i].mSign * triangle.mInvArea;
+    }
+    triangle.mDuvDx = triangle.mTexCoords[0] * dldx[0] + triangle.mTexCoords[1] * dldx[1] + triangle.mTexCoords[2] * dldx[2];
+    triangle.mDuvDy = triangle.mTexCoords[0] * dldy[0] + triangle.mTexCoords[1] * dldy[1] + triangle.mTexCoords[2] * dldy[2];
+    triangle.mDqDx = glm::dot(glm::vec3(triangle.mInvW[0], triangle.mInvW[1], triangle.mInvW[2]), dldx);
+    triangle.mDqDy = glm::dot(glm::vec3(triangle.mInvW[0], triangle.mInvW[1], triangle.mInvW[2]), dldy);
+    triangle.mMaterial = &material;
+    triangle.mMode = mode;
+
+    // Χиǵͼ
+    float minX = std::min(std::min(screen[0].x, screen[1].x), screen[2].x);
+    float maxX = std::max(std::max(screen[0].x, screen[1].x), screen[2].x);
+    float minY = std::min(std::min(screen[0].y, screen[1].y), screen[2].y);
+    float maxY = std::max(std::max(screen[0].y, screen[1].y), screen[2].y);
+    if (maxX < 0.0f || maxY < 0.0f || minX >= mWidth || minY >= mHeight) {
+        return;
+    }
+    int tileMinX = static_cast<int>(std::max(minX, 0.0f)) / kTileSize;
+    int tileMaxX = static_cast<int>(std::min(maxX, mWidth - 1.0f)) / kTileSize;
+    int tileMinY = static_cast<int>(std::max(minY, 0.0f)) / kTileSize;
+    int tileMaxY = static_cast<int>(std::min(maxY, mHeight - 1.0f)) / kTileSize;
+
+    mTriangles.push_back(triangle);
+    mStats.mTriangles++;
+
+    std::uint32_t index = static_cast<std::uint32_t>(mTriangles.size() - 1);
+    for (int ty = tileMinY; ty <= tileMaxY; ty++) {
+        for (int tx = tileMinX; tx <= tileMaxX; tx++) {
+            // ͼĸǶĳߵʱ
+            float x0 = tx * kTileSize + 0.5f, x1 = x0 + kTileSize - 1.0f;
+            float y0 = ty * kTileSize + 0.5f, y1 = y0 + kTileSize - 1.0f;
+            bool outside = false;
+            for (auto&& edge : triangle.mEdges) {
+                float maxEdge = std::max(std::max(edge.mSign * (edge.mA * x0 + (edge.mB * y0 + edge.mC)), edge.mSign * (edge.mA * x1 + (edge.mB * y0 + edge.mC))),
+                    std::max(edge.mSign * (edge.mA * x0 + (edge.mB * y1 + edge.mC)), edge.mSign * (edge.mA * x1 + (edge.mB * y1 + edge.mC))));
+                if (maxEdge < 0.0f) {
+                    outside = true;
+                    break;
+                }
+            }
+            if (!outside) {
+                mBins[ty * mTilesX + tx].push_back(index);
+                mStats.mBinnedTriangles++;
+            }
+        }
+    }
+}
+
+void SoftRenderer::Render()
+{
+    std::fill(mTileShadedPixels.begin(), mTileShadedPixels.end(), 0);
+    mJobSystem.ParallelFor(mBins.size(), 1, [this](std::size_t begin, std::size_t end) {
+        for (std::size_t tile = begin; tile < end; tile++) {
+            _rasterizeTile(static_cast<int>(tile));
+        }
+    });
+    for (auto&& count : mTileShadedPixels) {
+        mStats.mShadedPixels += count;
+    }
+}
+
+void SoftRenderer::_rasterizeTile(int tile)
+{
+    int tileX = (tile % mTilesX) * kTileSize;
+    int tileY = (tile / mTilesX) * kTileSize;
+    int tileEndX = std::min(tileX + kTileSize, mWidth);
+    int tileEndY = std::min(tileY + kTileSize, mHeight);
+    const SoftFloat4 laneOffsets(0.5f, 1.5f, 2.5f, 3.5f);
+    const SoftFloat4 zero(0.0f);
+    std::uint64_t shadedPixels = 0;
+
+    for (auto&& index : mBins[tile]) {
+        const Triangle& triangle = mTriangles[index];
+        bool earlyDepthWrite = triangle.mMode.mBlendMode != SoftBlendMode::alphaTest;
+        SoftFloat4 topLeft[3];
+        for (int i = 0; i < 3; i++) {
+            topLeft[i] = triangle.mEdges[i].mTopLeft ? SoftFloat4(0.0f) > SoftFloat4(-1.0f) : zero > zero;
+        }
+
+        for (int y = tileY; y < tileEndY; y++) {
+            float centerY = y + 0.5f;
+            float rowC[3];
+            for (int i = 0; i < 3; i++) {
+                rowC[i] = triangle.mEdges[i].mB * centerY + triangle.mEdges[i].mC;
+            }
+            float* depthRow = &mDepth[static_cast<std::size_t>(y) * mStride];
+            for (int x = tileX; x < tileEndX; x += 4) {
+                SoftFloat4 centerX = SoftFloat4(static_cast<float>(x)) + laneOffsets;
+                SoftFloat4 edges[3];
+                SoftFloat4 inside = zero == zero;
+                for (int i = 0; i < 3; i++) {
+                    const Edge& edge = triangle.mEdges[i];
+                    edges[i] = (SoftFloat4(edge.mA) * centerX + SoftFloat4(rowC[i])) * SoftFloat4(edge.mSign);
+                    inside = inside & ((edges[i] > zero) | ((edges[i] == zero) & topLeft[i]));
+                }
+                if (inside.Mask() == 0) {
+                    continue;
+                }
+
+                // ĻռԲֵȲɫ
+                SoftFloat4 invArea(triangle.mInvArea);
+                SoftFloat4 z = (edges[0] * SoftFloat4(triangle.mZ[0]) + edges[1] * SoftFloat4(triangle.mZ[1])
+                    + edges[2] * SoftFloat4(triangle.mZ[2])) * invArea;
+                // ӿڿȵز
+                int mask = (inside & (z < SoftFloat4::Load(depthRow + x))).Mask() & ((1 << std::min(tileEndX - x, 4)) - 1);
+                if (mask == 0) {
+                    continue;
+                }
+
+                float laneZ[4], laneEdges[3][4];
+                z.Store(laneZ);
+                for (int i = 0; i < 3; i++) {
+                    edges[i].Store(laneEdges[i]);
+                }
+                for (int lane = 0; lane < 4; lane++) {
+                    if (!(mask & (1 << lane))) {
+                        continue;
+                    }
+                    int px = x + lane;
+                    if (earlyDepthWrite) {
+                        depthRow[px] = laneZ[lane];
+                    }
+                    glm::vec4 color = _shade(triangle, laneEdges[0][lane] * triangle.mInvArea,
+                        laneEdges[1][lane] * triangle.mInvArea, laneEdges[2][lane] * triangle.mInvArea);
+                    if (triangle.mMode.mBlendMode == SoftBlendMode::alphaTest) {
+                        if (color.a < 0.1f) {
+                            continue;
+                        }
+                        depthRow[px] = laneZ[lane];
+                    }
+
+                    float* dst = &mColor[(static_cast<std::size_t>(y) * mStride + px) * 4];
+                    color = glm::clamp(color, 0.0f, 1.0f);
+                    if (triangle.mMode.mBlendMode == SoftBlendMode::alphaBlend) {
+                        color = color * color.a + glm::vec4(dst[0], dst[1], dst[2], dst[3]) * (1.0f - color.a);
+                    }
+                    // 8λɫһ
+                    for (int c = 0; c < 4; c++) {
+                        dst[c] = std::floor(color[c] * 255.0f + 0.5f) * (1.0f / 255.0f);
+                    }
+                    shadedPixels++;
+                }
+            }
+        }
+    }
+    mTileShadedPixels[tile] = shadedPixels;
+}
+
+glm::vec4 SoftRenderer::_shade(const Triangle& triangle, float l0, float l1, float l2) const
+{
+    const SoftMaterial& material = *triangle.mMaterial;
+    float q = l0 * triangle.mInvW[0] + l1 * triangle.mInvW[1] + l2 * triangle.mInvW[2];
+    float w = 1.0f / q;
+    glm::vec2 uv = (triangle.mTexCoords[0] * l0 + triangle.mTexCoords[1] * l1 + triangle.mTexCoords[2] * l2) * w;
+
+    // Ļĵd(uv) = (d(uv/w) - uv * d(1/w)) * w
+    glm::vec2 uvDx = (triangle.mDuvDx - uv * triangle.mDqDx) * w;
+    glm::vec2 uvDy = (triangle.mDuvDy - uv * triangle.mDqDy) * w;
+    // ÿԼĳߴ绻صmip;ͼĳߴԲͬ
+    auto textureLod = [&](const SoftTexture& texture) {
+        if (!mMipmapping) {
+            return 0.0f;
+        }
+        glm::vec2 size(texture.GetWidth(), texture.GetHeight());
+        glm::vec2 dx = uvDx * size;
+        glm::vec2 dy = uvDy * size;
+        float rho = std::max(glm::dot(dx, dx), glm::dot(dy, dy));
+        return rho > 1.0f ? 0.5f * std::log2(rho) : 0.0f;
+    };
+    glm::vec4 diffuseColor = material.mDiffuse ? material.mDiffuse->Sample(uv, textureLod(*material.mDiffuse)) * material.mColor : material.mColor;
+    if (triangle.mMode.mShading == SoftShading::unlit) {
+        return diffuseColor;
+    }
+    if (!mLights) {
+        return glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    glm::vec3 specularColor = material.mSpecular ? glm::vec3(material.mSpecular->Sample(uv, textureLod(*material.mSpecular))) : glm::vec3(0.0f);
+    glm::vec3 fragPos = (triangle.mWorldPos[0] * l0 + triangle.mWorldPos[1] * l1 + triangle.mWorldPos[2] * l2) * w;
+    glm::vec3 normal = glm::normalize((triangle.mNormal[0] * l0 + triangle.mNormal[1] * l1 + triangle.mNormal[2] * l2) * w);
+    glm::vec3 viewDir = glm::normalize(mCameraPos - fragPos);
+    glm::vec3 albedo(diffuseColor);
+
+    // shader_2_obj.fsļһ
+    auto phong = [&](const glm::vec3& lightDir, const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular) {
+        float diff = std::max(glm::dot(normal, lightDir), 0.0f);
+        glm::vec3 reflectDir = glm::reflect(-lightDir, normal);
+        float spec = std::pow(std::max(glm::dot(viewDir, reflectDir), 0.0f), material.mShininess);
+        return ambient * albedo + diffuse * diff * albedo + specular * spec * specularColor;
+    };
+    auto attenuation = [&fragPos](const glm::vec3& position, float constant, float linear, float quadratic) {
+        float distance = glm::length(position - fragPos);
+        return 1.0f / (constant + linear * distance + quadratic * (distance * distance));
+    };
+
+    const LightParameters::DirectLight& dirLight = mLights->mDirectLight;
+    glm::vec3 result = phong(glm::normalize(-dirLight.mDirection), dirLight.mAmbient, dirLight.mDiffuse, dirLight.mSpecular);
+    for (auto&& light : mLights->mPointLights) {
+        result += phong(glm::normalize(light.mPosition - fragPos), light.mAmbient, light.mDiffuse, light.mSpecular)
+            * attenuation(light.mPosition, light.mConstant, light.mLinear, light.mQuadratic);
+    }
+    const LightParameters::SpotLight& spotLight = mLights->mSpotLight;
+    glm::vec3 spotDir = glm::normalize(spotLight.mPosition - fragPos);
+    float theta = glm::dot(spotDir, glm::normalize(-spotLight.mDirection));
+    float intensity = glm::clamp((theta - spotLight.mOuterCutOff) / (spotLight.mCutOff - spotLight.mOuterCutOff), 0.0f, 1.0f);
+    result += phong(spotDir, spotLight.mAmbient, spotLight.mDiffuse, spotLight.mSpecular)
+        * attenuation(spotLight.mPosition, spotLight.mConstant, spotLight.mLinear, spotLight.mQuadratic) * intensity;
+    return glm::vec4(result, 1.0f);
+}
+
+void SoftRenderer::ReadPixels(std::vector<std::uint8_t>& pixels) const
+{
+    pixels.resize(static_cast<std::size_t>(mWidth) * mHeight * 3);
+    for (int y = 0; y < mHeight; y++) {
+        for (int x = 0; x < mWidth; x++) {
+            const float* src = &mColor[(static_cast<std::size_t>(y) * mStride + x) * 4];
+            std::uint8_t* dst = &pixels[(static_cast<std::size_t>(y) * mWidth + x) * 3];
+            for (int c = 0; c < 3; c++) {
+                dst[c] = static_cast<std::uint8_t>(src[c] * 255.0f + 0.5f);
+            }
+        }
+    }
+}
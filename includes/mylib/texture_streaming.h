@@ -0,0 +1,510 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+#include <stb_image.h>
+#include <mylib/job_system.h>
+#include <mylib/render_device.h>
+#include <mylib/render_stats.h>
+#include <mylib/gpu_resources.h>
+#include <mylib/frame_arena.h>
+
+
+// ͣʱֻפСļmipβϸmipĻҪľں̨ϴ
+// ÿ֡ʱõRequest֡ʱUpdateϴɵmipΪҪϸmip룬
+// ԴԤʱʹõ˳ͷһ֡òϸmip
+// GL 3.3ûвɱ洢glTexStorageÿmip䣬BASE_LEVEL/MAX_LEVELƲΧͷʱһΪ0x0
+// JobSystemĹִ߳УLoadһУֻͷź
+class TextureStreamer
+{
+public:
+    // βmip߳غʼճפԤ
+    static const int kTailSize = 64;
+    // ͬʱں̨ϸmipƽʱռõڴ
+    static const int kMaxPendingRequests = 4;
+
+    TextureStreamer(JobSystem& jobSystem, std::int64_t budgetBytes);
+    ~TextureStreamer();
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // úTextureFromFileͣnullptrָΪʱϴȫmip
+    static TextureStreamer* GetCurrent() { return _current(); }
+    static void SetCurrent(TextureStreamer* streamer) { _current() = streamer; }
+
+    // ں̨βmipǰΪ1x1Ļɫ
+    TextureHandle Load(const std::string& path);
+    // һ֡õľȣĻϸscreenPixelsأξĿΪuvExtent
+    // ѾͷŵֱӺ
+    void Request(TextureHandle texture, float screenPixels, float uvExtent = 1.0f);
+    // ֡ʱ
+    void Update();
+    // ȴк̨ɲϴҪȷĽͼͲ
+    void Flush();
+
+    std::int64_t GetBudget() const { return mBudget; }
+    void SetBudget(std::int64_t budgetBytes) { mBudget = budgetBytes; }
+    // פϸmipֽβmipͳ
+    std::int64_t GetResidentBytes() const { return mResidentBytes; }
+    std::int64_t GetTailBytes() const { return mTailBytes; }
+    // detailedʱÿһ
+    void Print(std::ostream& out, bool detailed = false) const;
+
+    // width x heightĻϸscreenPixelsʱҪϸmip
+    static int CalcRequiredLevel(int width, int height, float screenPixels, float uvExtent = 1.0f);
+    // ΧͶӰĻϵֱأʱfloatֵ
+    static float CalcScreenSize(const glm::vec3& center, float radius, const glm::mat4& view, const glm::mat4& projection, float viewportHeight);
+
+private:
+    // һκ̨룬Ϊ[mFirstLevel, mEndLevel)֮ÿmip
+    struct StreamRequest
+    {
+        std::string mPath;
+        int mWidth;
+        int mHeight;
+        int mChannels;
+        int mFirstLevel;
+        int mEndLevel;
+        std::int64_t mBytes;
+        std::vector<std::vector<std::uint8_t>> mLevels;
+        bool mFailed = false;
+        std::atomic<bool> mDone{ false };
+    };
+
+    struct Entry
+    {
+        std::string mPath;
+        TextureHandle mHandle;
+        std::uint32_t mTexture;         // mHandleЧʱGL
+        int mWidth;
+        int mHeight;
+        int mChannels;
+        int mLevelCount;
+        int mTailLevel;                 // ʼճפĵһ
+        int mResidentLevel;             // ϴϸһmLevelCountʱû
+        int mRequestedLevel;            // mLastUsedFrameһ֡Ҫϸһ
+        std::uint64_t mLastUsedFrame;
+        std::unique_ptr<StreamRequest> mPending;
+    };
+
+    JobSystem& mJobSystem;
+    std::int64_t mBudget;
+    std::int64_t mResidentBytes = 0;
+    std::int64_t mTailBytes = 0;
+    std::int64_t mPendingBytes = 0;
+    int mPendingCount = 0;
+    std::uint64_t mFrame = 1;
+    std::uint64_t mStreamedLevels = 0;
+    std::uint64_t mEvictedLevels = 0;
+    std::vector<Entry> mEntries;
+    std::map<std::uint32_t, std::size_t> mEntryIndices;  // Ĳ۵mEntries±
+
+    static TextureStreamer*& _current();
+    static std::int64_t _getLevelBytes(const Entry& entry, int firstLevel, int endLevel);
+    // һ֮֡Ҫϸһһ֡ûõֻҪβ
+    int _getNeededLevel(const Entry& entry) const;
+
+    void _issue(Entry& entry, int firstLevel);
+    void _finish(Entry& entry);
+    void _finishCompleted();
+    // ƳӵѾͷŵ
+    void _removeReleased();
+    // ͷòϸmipֱٷbytesֽڣŲʱfalse
+    bool _reserve(std::int64_t bytes);
+    void _evictLevel(Entry& entry);
+
+    static void _decodeJob(JobSystem& jobSystem, Job& job, const void* data);
+    static void _decode(StreamRequest& request);
+    static std::vector<std::uint8_t> _downsample(const std::vector<std::uint8_t>& source, int width, int height, int channels);
+};
+
+
+TextureStreamer::TextureStreamer(JobSystem& jobSystem, std::int64_t budgetBytes)
+    : mJobSystem(jobSystem), mBudget(budgetBytes)
+{
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    if (_current() == this) {
+        _current() = nullptr;
+    }
+    // ̻߳дĽǽͷ
+    for (auto&& entry : mEntries) {
+        while (entry.mPending && !entry.mPending->mDone.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+TextureStreamer*& TextureStreamer::_current()
+{
+    static TextureStreamer* streamer = nullptr;
+    return streamer;
+}
+
+std::int64_t TextureStreamer::_getLevelBytes(const Entry& entry, int firstLevel, int endLevel)
+{
+    std::int64_t bytes = 0;
+    for (int level = firstLevel; level < endLevel; level++) {
+        bytes += static_cast<std::int64_t>(std::max(1, entry.mWidth >> level)) * std::max(1, entry.mHeight >> level) * entry.mChannels;
+    }
+    return bytes;
+}
+
+int TextureStreamer::_getNeededLevel(const Entry& entry) const
+{
+    return entry.mLastUsedFrame == mFrame ? entry.mRequestedLevel : entry.mTailLevel;
+}
+
+int TextureStreamer::CalcRequiredLevel(int width, int height, float screenPixels, float uvExtent)
+{
+    int size = std::max(width, height);
+    int maxLevel = 0;
+    while ((size >> maxLevel) > 1) {
+        maxLevel++;
+    }
+    // ĻÿظǵÿһҪmipһ
+    float ratio = size * uvExtent / std::max(screenPixels, 1.0f);
+    if (!(ratio > 1.0f)) {
+        return 0;
+    }
+    return std::min(static_cast<int>(std::floor(std::log2(ratio))), maxLevel);
+}
+
+float TextureStreamer::CalcScreenSize(const glm::vec3& center, float radius, const glm::mat4& view, const glm::mat4& projection, float viewportHeight)
+{
+    float distance = -glm::vec3(view * glm::vec4(center, 1.0f)).z;
+    if (distance <= radius) {
+        return std::numeric_limits<float>::max();
+    }
+    // ֱ2rͶӰNDCΪ2r * P[1][1] / dNDCĸ߶2ӦviewportHeight
+    return radius * projection[1][1] * viewportHeight / distance;
+}
+
+TextureHandle TextureStreamer::Load(const std::string& path)
+{
+    RenderDevice& device = RenderDevice::Get();
+    int width, height, channels;
+    if (!stbi_info(path.c_str(), &width, &height, &channels)) {
+        std::cout << "Failed to load texture: " << path << std::endl;
+        return GpuResources::Get().Add<GpuResourceType::texture>(device.CreateTexture2D(0, 0, 4, nullptr), 0, path);
+    }
+    // Ҷȼ͸ȰRGBAϴ
+    channels = channels == 2 ? 4 : channels;
+
+    Entry entry;
+    entry.mPath = path;
+    entry.mWidth = width;
+    entry.mHeight = height;
+    entry.mChannels = channels;
+    entry.mLevelCount = 1;
+    while ((std::max(width, height) >> entry.mLevelCount) > 0) {
+        entry.mLevelCount++;
+    }
+    entry.mTailLevel = 0;
+    while (std::max(width >> entry.mTailLevel, height >> entry.mTailLevel) > kTailSize) {
+        entry.mTailLevel++;
+    }
+    entry.mResidentLevel = entry.mLevelCount;
+    entry.mRequestedLevel = entry.mTailLevel;
+    entry.mLastUsedFrame = 0;
+
+    // ǰֻһ1x1ռλ
+    const std::uint8_t placeholder[4] = { 128, 128, 128, 255 };
+    entry.mTexture = device.CreateTexture2D(width, height, channels, nullptr);
+    device.SetTextureLevel(entry.mTexture, entry.mLevelCount - 1, 1, 1, channels, placeholder);
+    device.SetTextureLevelRange(entry.mTexture, entry.mLevelCount - 1, entry.mLevelCount - 1);
+    // С͵mip仯
+    entry.mHandle = GpuResources::Get().Add<GpuResourceType::texture>(entry.mTexture, 0, path);
+
+    mEntryIndices[entry.mHandle.mIndex] = mEntries.size();
+    mEntries.push_back(std::move(entry));
+    _issue(mEntries.back(), mEntries.back().mTailLevel);
+    return mEntries.back().mHandle;
+}
+
+void TextureStreamer::Request(TextureHandle texture, float screenPixels, float uvExtent)
+{
+    auto found = mEntryIndices.find(texture.mIndex);
+    if (found == mEntryIndices.end() || mEntries[found->second].mHandle != texture) {
+        return;
+    }
+    Entry& entry = mEntries[found->second];
+    int level = std::min(CalcRequiredLevel(entry.mWidth, entry.mHeight, screenPixels, uvExtent), entry.mTailLevel);
+    if (entry.mLastUsedFrame != mFrame) {
+        entry.mLastUsedFrame = mFrame;
+        entry.mRequestedLevel = level;
+    }
+    else {
+        entry.mRequestedLevel = std::min(entry.mRequestedLevel, level);
+    }
+}
+
+void TextureStreamer::Update()
+{
+    _finishCompleted();
+    _removeReleased();
+
+    // ԤСͷòmipǳʹһʼͷҪmip
+    while (!_reserve(0)) {
+        Entry* victim = nullptr;
+        for (auto&& entry : mEntries) {
+            if (!entry.mPending && entry.mResidentLevel < entry.mTailLevel
+                && (!victim || _getLevelBytes(entry, entry.mResidentLevel, entry.mResidentLevel + 1) > _getLevelBytes(*victim, victim->mResidentLevel, victim->mResidentLevel + 1))) {
+                victim = &entry;
+            }
+        }
+        if (!victim) {
+            break;
+        }
+        _evictLevel(*victim);
+    }
+
+    // һ֡Ҫϸmipȱļ
+    FrameVector<Entry*> candidates;
+    for (auto&& entry : mEntries) {
+        if (!entry.mPending && entry.mResidentLevel <= entry.mTailLevel && _getNeededLevel(entry) < entry.mResidentLevel) {
+            candidates.push_back(&entry);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Entry* a, const Entry* b) {
+        return a->mResidentLevel - a->mRequestedLevel > b->mResidentLevel - b->mRequestedLevel;
+    });
+    for (Entry* entry : candidates) {
+        if (mPendingCount >= kMaxPendingRequests) {
+            break;
+        }
+        // Ԥ㲻ʱͷòmipȻͼ
+        int level = entry->mRequestedLevel;
+        while (level < entry->mResidentLevel && !_reserve(_getLevelBytes(*entry, level, entry->mResidentLevel))) {
+            level++;
+        }
+        if (level < entry->mResidentLevel) {
+            _issue(*entry, level);
+        }
+    }
+    mFrame++;
+}
+
+void TextureStreamer::Flush()
+{
+    while (mPendingCount > 0) {
+        _finishCompleted();
+        if (mPendingCount > 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TextureStreamer::_finishCompleted()
+{
+    for (auto&& entry : mEntries) {
+        if (entry.mPending && entry.mPending->mDone.load(std::memory_order_acquire)) {
+            _finish(entry);
+        }
+    }
+}
+
+void TextureStreamer::_removeReleased()
+{
+    GpuResources& resources = GpuResources::Get();
+    for (std::size_t i = 0; i < mEntries.size();) {
+        Entry& entry = mEntries[i];
+        // ڽĵɺƳ߳дĽ
+        if (entry.mPending || resources.IsValid(entry.mHandle)) {
+            i++;
+            continue;
+        }
+        // ԴGpuResourcesɾʱ۳ֻԼͳ
+        if (entry.mResidentLevel <= entry.mTailLevel) {
+            mResidentBytes -= _getLevelBytes(entry, entry.mResidentLevel, entry.mTailLevel);
+            mTailBytes -= _getLevelBytes(entry, entry.mTailLevel, entry.mLevelCount);
+        }
+        // ۿѾ¼صʹãֻɾָԼ±
+        auto found = mEntryIndices.find(entry.mHandle.mIndex);
+        if (found != mEntryIndices.end() && found->second == i) {
+            mEntryIndices.erase(found);
+        }
+        if (i + 1 != mEntries.size()) {
+            entry = std::move(mEntries.back());
+            mEntryIndices[entry.mHandle.mIndex] = i;
+        }
+        mEntries.pop_back();
+    }
+}
+
+bool TextureStreamer::_reserve(std::int64_t bytes)
+{
+    while (mResidentBytes + mPendingBytes + bytes > mBudget) {
+        // ûõġòϸmipҲڽ
+        Entry* victim = nullptr;
+        for (auto&& entry : mEntries) {
+            if (!entry.mPending && entry.mResidentLevel < _getNeededLevel(entry) && (!victim || entry.mLastUsedFrame < victim->mLastUsedFrame)) {
+                victim = &entry;
+            }
+        }
+        if (!victim) {
+            return false;
+        }
+        _evictLevel(*victim);
+    }
+    return true;
+}
+
+void TextureStreamer::_evictLevel(Entry& entry)
+{
+    // СΧͷһ
+    RenderDevice& device = RenderDevice::Get();
+    int level = entry.mResidentLevel++;
+    device.SetTextureLevelRange(entry.mTexture, entry.mResidentLevel, entry.mLevelCount - 1);
+    device.SetTextureLevel(entry.mTexture, level, 0, 0, entry.mChannels, nullptr);
+    std::int64_t bytes = _getLevelBytes(entry, level, level + 1);
+    mResidentBytes -= bytes;
+    GpuResources::Get().AddBytes(entry.mHandle, -bytes);
+    mEvictedLevels++;
+}
+
+void TextureStreamer::_issue(Entry& entry, int firstLevel)
+{
+    entry.mPending.reset(new StreamRequest());
+    StreamRequest& request = *entry.mPending;
+    request.mPath = entry.mPath;
+    request.mWidth = entry.mWidth;
+    request.mHeight = entry.mHeight;
+    request.mChannels = entry.mChannels;
+    request.mFirstLevel = firstLevel;
+    request.mEndLevel = std::min(entry.mResidentLevel, entry.mLevelCount);
+    request.mBytes = _getLevelBytes(entry, request.mFirstLevel, request.mEndLevel);
+    // βԤ
+    if (entry.mResidentLevel <= entry.mTailLevel) {
+        mPendingBytes += request.mBytes;
+    }
+    mPendingCount++;
+
+    StreamRequest* data = &request;
+    Job* job = mJobSystem.CreateJob(&TextureStreamer::_decodeJob, data);
+    mJobSystem.Run(job);
+    // ûй߳ʱִֻ
+    if (mJobSystem.GetThreadCount() == 1) {
+        mJobSystem.Wait(job);
+    }
+}
+
+void TextureStreamer::_finish(Entry& entry)
+{
+    StreamRequest& request = *entry.mPending;
+    bool tail = entry.mResidentLevel > entry.mTailLevel;
+    if (!tail) {
+        mPendingBytes -= request.mBytes;
+    }
+    mPendingCount--;
+
+    // ڼѾͷţGLֿѾڱĶ󣬲ϴ
+    if (!GpuResources::Get().IsValid(entry.mHandle)) {
+        entry.mPending.reset();
+        return;
+    }
+    if (request.mFailed) {
+        std::cout << "Failed to load texture: " << request.mPath << std::endl;
+    }
+    else {
+        // ӴֵϸϴٷſΧ
+        RenderDevice& device = RenderDevice::Get();
+        for (int level = request.mEndLevel - 1; level >= request.mFirstLevel; level--) {
+            device.SetTextureLevel(entry.mTexture, level, std::max(1, entry.mWidth >> level), std::max(1, entry.mHeight >> level),
+                entry.mChannels, request.mLevels[level - request.mFirstLevel].data());
+        }
+        device.SetTextureLevelRange(entry.mTexture, request.mFirstLevel, entry.mLevelCount - 1);
+        entry.mResidentLevel = request.mFirstLevel;
+        (tail ? mTailBytes : mResidentBytes) += request.mBytes;
+        RenderStats::Get().AddTextureUpload(request.mBytes);
+        GpuResources::Get().AddBytes(entry.mHandle, request.mBytes);
+        mStreamedLevels += request.mEndLevel - request.mFirstLevel;
+    }
+    entry.mPending.reset();
+}
+
+void TextureStreamer::_decodeJob(JobSystem& /*jobSystem*/, Job& /*job*/, const void* data)
+{
+    StreamRequest* request = *static_cast<StreamRequest* const*>(data);
+    _decode(*request);
+    request->mDone.store(true, std::memory_order_release);
+}
+
+void TextureStreamer::_decode(StreamRequest& request)
+{
+    // תȫֵģ߳߳Լ
+    stbi_set_flip_vertically_on_load_thread(1);
+    int width, height, channels;
+    std::uint8_t* pixels = stbi_load(request.mPath.c_str(), &width, &height, &channels, request.mChannels);
+    if (!pixels || width != request.mWidth || height != request.mHeight) {
+        request.mFailed = true;
+        stbi_image_free(pixels);
+        return;
+    }
+    std::vector<std::uint8_t> level(pixels, pixels + static_cast<std::size_t>(width) * height * request.mChannels);
+    stbi_image_free(pixels);
+
+    // ӵ0СֻҪļ
+    request.mLevels.resize(request.mEndLevel - request.mFirstLevel);
+    for (int i = 0; i < request.mEndLevel; i++) {
+        std::vector<std::uint8_t> next;
+        if (i + 1 < request.mEndLevel) {
+            next = _downsample(level, std::max(1, width >> i), std::max(1, height >> i), request.mChannels);
+        }
+        if (i >= request.mFirstLevel) {
+            request.mLevels[i - request.mFirstLevel] = std::move(level);
+        }
+        level = std::move(next);
+    }
+}
+
+std::vector<std::uint8_t> TextureStreamer::_downsample(const std::vector<std::uint8_t>& source, int width, int height, int channels)
+{
+    // 2x2ʽ˲߳ʱһУУǰһУУϲ
+    int targetWidth = std::max(1, width >> 1);
+    int targetHeight = std::max(1, height >> 1);
+    std::vector<std::uint8_t> target(static_cast<std::size_t>(targetWidth) * targetHeight * channels);
+    for (int y = 0; y < targetHeight; y++) {
+        int y0 = std::min(y * 2, height - 1);
+        int y1 = std::min(y * 2 + 1, height - 1);
+        for (int x = 0; x < targetWidth; x++) {
+            int x0 = std::min(x * 2, width - 1);
+            int x1 = std::min(x * 2 + 1, width - 1);
+            for (int c = 0; c < channels; c++) {
+                int sum = source[(static_cast<std::size_t>(y0) * width + x0) * channels + c] + source[(static_cast<std::size_t>(y0) * width + x1) * channels + c]
+                    + source[(static_cast<std::size_t>(y1) * width + x0) * channels + c] + source[(static_cast<std::size_t>(y1) * width + x1) * channels + c];
+                target[(static_cast<std::size_t>(y) * targetWidth + x) * channels + c] = static_cast<std::uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+    return target;
+}
+
+void TextureStreamer::Print(std::ostream& out, bool detailed) const
+{
+    std::int64_t budget = std::max<std::int64_t>(mBudget, 1);
+    out << "Texture streaming: " << mResidentBytes / 1024 << " KB resident of " << mBudget / 1024 << " KB budget ("
+        << mResidentBytes * 100 / budget << "%), mip tails " << mTailBytes / 1024 << " KB, " << mEntries.size() << " textures, "
+        << mPendingCount << " decoding, " << mStreamedLevels << " levels streamed in, " << mEvictedLevels << " evicted" << std::endl;
+    if (!detailed) {
+        return;
+    }
+    for (auto&& entry : mEntries) {
+        int resident = std::min(entry.mResidentLevel, entry.mLevelCount - 1);
+        out << "  " << entry.mPath << ": " << entry.mWidth << "x" << entry.mHeight << ", resident mip " << resident
+            << " (" << std::max(1, entry.mWidth >> resident) << "x" << std::max(1, entry.mHeight >> resident) << "), last requested " << entry.mRequestedLevel
+            << ", " << _getLevelBytes(entry, entry.mResidentLevel, entry.mLevelCount) / 1024 << " KB total" << std::endl;
+    }
+}
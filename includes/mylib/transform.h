@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#define MYLIB_TRANSFORM_SSE 1
+#endif
+
+
+// 4x4 out = a * bglmд洢ĵjΪaаb[j]ĸȨ
+inline void MultiplyMatrix(const glm::mat4& a, const glm::mat4& b, glm::mat4& out)
+{
+#ifdef MYLIB_TRANSFORM_SSE
+    __m128 a0 = _mm_loadu_ps(&a[0][0]);
+    __m128 a1 = _mm_loadu_ps(&a[1][0]);
+    __m128 a2 = _mm_loadu_ps(&a[2][0]);
+    __m128 a3 = _mm_loadu_ps(&a[3][0]);
+    for (int j = 0; j < 4; j++) {
+        __m128 column = _mm_mul_ps(a0, _mm_set1_ps(b[j][0]));
+        column = _mm_add_ps(column, _mm_mul_ps(a1, _mm_set1_ps(b[j][1])));
+        column = _mm_add_ps(column, _mm_mul_ps(a2, _mm_set1_ps(b[j][2])));
+        column = _mm_add_ps(column, _mm_mul_ps(a3, _mm_set1_ps(b[j][3])));
+        _mm_storeu_ps(&out[j][0], column);
+    }
+#else
+    out = a * b;
+#endif
+}
+
+
+// 任㼶ݰSoAУ±ָ
+// ڵ㰴ӣڵ±Сӽڵ㣬һ˳
+// ޸ľֲ任ֻǸýڵ㣬Updateʱֻ¼㱻ǽڵǵ
+class TransformHierarchy
+{
+public:
+    static const std::int32_t kNoParent = -1;
+
+    void Reserve(std::size_t count);
+    std::size_t GetNodeCount() const { return mParents.size(); }
+
+    // ӽڵ㣬parentѾӵĽڵkNoParentؽڵ±
+    std::uint32_t AddNode(std::int32_t parent, const glm::vec3& translation = glm::vec3(0.0f),
+        const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f), const glm::vec3& scale = glm::vec3(1.0f));
+
+    void SetTranslation(std::uint32_t node, const glm::vec3& translation);
+    void SetRotation(std::uint32_t node, const glm::quat& rotation);
+    void SetScale(std::uint32_t node, const glm::vec3& scale);
+
+    const glm::vec3& GetTranslation(std::uint32_t node) const { return mTranslations[node]; }
+    const glm::quat& GetRotation(std::uint32_t node) const { return mRotations[node]; }
+    const glm::vec3& GetScale(std::uint32_t node) const { return mScales[node]; }
+    std::int32_t GetParent(std::uint32_t node) const { return mParents[node]; }
+
+    // ¼㱻޸ĵĽڵ㼰󣬷¼Ľڵ
+    std::size_t Update();
+
+    // ҪȵUpdate
+    const glm::mat4& GetWorldMatrix(std::uint32_t node) const { return mWorldMatrices[node]; }
+
+private:
+    // ֲ任
+    std::vector<glm::vec3> mTranslations;
+    std::vector<glm::quat> mRotations;
+    std::vector<glm::vec3> mScales;
+
+    std::vector<glm::mat4> mWorldMatrices;
+    std::vector<std::int32_t> mParents;
+
+    // 1ʾֲ任޸ĹUpdateʱд2ʾ֡б仯ӽڵҪŸ
+    std::vector<std::uint8_t> mDirty;
+    bool mAnyDirty = false;
+
+    void _markDirty(std::uint32_t node);
+};
+
+void TransformHierarchy::Reserve(std::size_t count)
+{
+    mTranslations.reserve(count);
+    mRotations.reserve(count);
+    mScales.reserve(count);
+    mWorldMatrices.reserve(count);
+    mParents.reserve(count);
+    mDirty.reserve(count);
+}
+
+std::uint32_t TransformHierarchy::AddNode(std::int32_t parent, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale)
+{
+    std::uint32_t node = static_cast<std::uint32_t>(mParents.size());
+    if (parent < kNoParent || parent >= static_cast<std::int32_t>(node)) {
+        std::cout << "Transform node " << node << " has invalid parent " << parent << ", parents must be added first" << std::endl;
+        parent = kNoParent;
+    }
+
+    mTranslations.push_back(translation);
+    mRotations.push_back(rotation);
+    mScales.push_back(scale);
+    mWorldMatrices.emplace_back(1.0f);
+    mParents.push_back(parent);
+    mDirty.push_back(1);
+    mAnyDirty = true;
+    return node;
+}
+
+void TransformHierarchy::SetTranslation(std::uint32_t node, const glm::vec3& translation)
+{
+    mTranslations[node] = translation;
+    _markDirty(node);
+}
+
+void TransformHierarchy::SetRotation(std::uint32_t node, const glm::quat& rotation)
+{
+    mRotations[node] = rotation;
+    _markDirty(node);
+}
+
+void TransformHierarchy::SetScale(std::uint32_t node, const glm::vec3& scale)
+{
+    mScales[node] = scale;
+    _markDirty(node);
+}
+
+void TransformHierarchy::_markDirty(std::uint32_t node)
+{
+    mDirty[node] = 1;
+    mAnyDirty = true;
+}
+
+std::size_t TransformHierarchy::Update()
+{
+    if (!mAnyDirty) {
+        return 0;
+    }
+
+    std::size_t updatedCount = 0;
+    std::size_t nodeCount = mParents.size();
+    std::uint8_t* dirty = mDirty.data();
+    const std::int32_t* parents = mParents.data();
+    for (std::size_t i = 0; i < nodeCount; i++) {
+        std::int32_t parent = parents[i];
+        // ڵ㱾֡¹ӽڵҲҪ
+        if (!dirty[i] && (parent == kNoParent || dirty[parent] != 2)) {
+            continue;
+        }
+
+        // TRSϾֲתÿгţдƽ
+        glm::mat4 local = glm::mat4_cast(mRotations[i]);
+        local[0] *= mScales[i].x;
+        local[1] *= mScales[i].y;
+        local[2] *= mScales[i].z;
+        local[3] = glm::vec4(mTranslations[i], 1.0f);
+
+        if (parent == kNoParent) {
+            mWorldMatrices[i] = local;
+        }
+        else {
+            MultiplyMatrix(mWorldMatrices[parent], local, mWorldMatrices[i]);
+        }
+        dirty[i] = 2;
+        updatedCount++;
+    }
+
+    // ǣΪӽڵҪȡڵı
+    std::fill(mDirty.begin(), mDirty.end(), 0);
+    mAnyDirty = false;
+    return updatedCount;
+}
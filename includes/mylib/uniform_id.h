@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+
+// uniformֵ32λFNV-1aϣַ"material.diffuse"_uidڱڼ
+// ShaderӺ󰴹ϣuniformλãʱUniformIdңҪַҲҪglGetUniformLocation
+// Ԫص֣pointLights[2].positionMakeUniformIdArrayڱ
+struct UniformId
+{
+    static constexpr std::uint32_t kOffsetBasis = 2166136261u;
+    static constexpr std::uint32_t kPrime = 16777619u;
+
+    std::uint32_t mHash = kOffsetBasis;
+
+    constexpr UniformId() = default;
+    constexpr explicit UniformId(std::uint32_t hash) : mHash(hash) {}
+    // ʱ㣬ֻʱͲڻ·ϵĵطʹ
+    constexpr explicit UniformId(const char* text) : mHash(UniformId().Append(text).mHash) {}
+
+    // ֺ׷ַFNV-1aֽڼģַĹϣͬ
+    constexpr UniformId Append(const char* text, std::size_t length) const
+    {
+        std::uint32_t hash = mHash;
+        for (std::size_t i = 0; i < length; i++) {
+            hash = (hash ^ static_cast<std::uint8_t>(text[i])) * kPrime;
+        }
+        return UniformId(hash);
+    }
+    constexpr UniformId Append(const char* text) const
+    {
+        std::size_t length = 0;
+        while (text[length] != '\0') {
+            length++;
+        }
+        return Append(text, length);
+    }
+    constexpr UniformId AppendIndex(std::uint32_t index) const
+    {
+        char digits[10] = {};
+        std::size_t count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + index % 10);
+            index /= 10;
+        } while (index > 0);
+        UniformId result = Append("[", 1);
+        while (count > 0) {
+            result = result.Append(&digits[--count], 1);
+        }
+        return result.Append("]", 1);
+    }
+
+    constexpr bool operator==(const UniformId& other) const { return mHash == other.mHash; }
+    constexpr bool operator!=(const UniformId& other) const { return mHash != other.mHash; }
+    constexpr bool operator<(const UniformId& other) const { return mHash < other.mHash; }
+};
+
+constexpr UniformId operator""_uid(const char* text, std::size_t length)
+{
+    return UniformId().Append(text, length);
+}
+
+// ShaderuniformַʱϣUniformId
+struct UniformName
+{
+    UniformId mId;
+    const char* mText;
+
+    UniformName(const char* text) : mId(text), mText(text) {}
+    constexpr UniformName(UniformId id) : mId(id), mText(nullptr) {}
+};
+
+// prefix[0]suffix ... prefix[N-1]suffixUniformId("pointLights", ".position")
+template<std::size_t N>
+constexpr std::array<UniformId, N> MakeUniformIdArray(const char* prefix, const char* suffix)
+{
+    std::array<UniformId, N> ids = {};
+    UniformId base = UniformId().Append(prefix);
+    for (std::size_t i = 0; i < N; i++) {
+        ids[i] = base.AppendIndex(static_cast<std::uint32_t>(i)).Append(suffix);
+    }
+    return ids;
+}
+
+static_assert("material.diffuse"_uid == UniformId().Append("material.").Append("diffuse"), "FNV-1a must be incremental");
+static_assert(MakeUniformIdArray<12>("pointLights", ".position")[11] == "pointLights[11].position"_uid, "array uniform ids");
@@ -0,0 +1,26 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+
+out vec3 Normal;
+out vec3 FragPos;
+out vec2 TexCoords;
+
+// ÿı任طʱ󶨵UBOĲͬ
+layout (std140) uniform ObjectBlock {
+    mat4 model;
+    mat4 normalMatrix;  // ֻõϽ3x3CPUԤȼ
+};
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    FragPos = vec3(model * vec4(aPos, 1.0));
+    TexCoords = aTexCoords;
+    Normal = mat3(normalMatrix) * aNormal;
+
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+}
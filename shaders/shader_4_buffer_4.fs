@@ -5,20 +5,20 @@ in vec2 TexCoords;
 
 uniform sampler2D screenTexture;
 
-const float offset = 1.0 / 300.0;  
-
 void main()
 {
+    // ƫһأֱ޹
+    vec2 offset = 1.0 / vec2(textureSize(screenTexture, 0));
     vec2 offsets[9] = vec2[](
-        vec2(-offset,  offset), // 
-        vec2( 0.0f,    offset), // 
-        vec2( offset,  offset), // 
-        vec2(-offset,  0.0f),   // 
+        vec2(-offset.x,  offset.y), // 
+        vec2( 0.0f,      offset.y), // 
+        vec2( offset.x,  offset.y), // 
+        vec2(-offset.x,  0.0f),   // 
         vec2( 0.0f,    0.0f),   // 
-        vec2( offset,  0.0f),   // 
-        vec2(-offset, -offset), // 
-        vec2( 0.0f,   -offset), // 
-        vec2( offset, -offset)  // 
+        vec2( offset.x,  0.0f),   // 
+        vec2(-offset.x, -offset.y), // 
+        vec2( 0.0f,     -offset.y), // 
+        vec2( offset.x, -offset.y)  // 
     );
 
     float kernel[9] = float[](
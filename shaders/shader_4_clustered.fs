@@ -0,0 +1,175 @@
+#version 330 core
+// ִǰȾֻ֮ƬڴеĵԴ;۹ƣԴݼcluster.h
+out vec4 FragColor;
+
+// 
+struct Material {
+    sampler2D diffuse;
+    sampler2D specular;
+    float     shininess;
+}; 
+
+// Դ
+struct DirLight {
+    vec3 direction;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+in vec3 Normal;
+in vec3 FragPos;
+in vec2 TexCoords;
+
+uniform DirLight dirLight;
+uniform Material material;
+uniform vec3 viewPos;
+uniform mat4 view;
+
+// ִ
+uniform samplerBuffer lightData;
+uniform usamplerBuffer lightIndices;
+uniform usamplerBuffer clusters;
+uniform vec3 clusterGrid;
+uniform float clusterZScale;
+uniform float clusterZBias;
+uniform vec2 screenSize;
+
+// Ӱshadow.h
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 shadowCameraView;
+uniform mat4 lightSpaceMatrices[4];
+uniform float cascadeSplits[4];
+uniform float cascadeTexelSizes[4];
+uniform int cascadeCount;
+
+// 㺯
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir, vec3 albedo, vec3 specularColor, float shadow);
+// йԴļ㺯
+vec3 CalcClusterLight(int light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 albedo, vec3 specularColor);
+// Ӱ㺯
+float CalcShadow(vec3 fragPos, vec3 normal);
+
+void main()
+{
+    vec4 texColor = texture(material.diffuse, TexCoords);
+    if(texColor.a < 0.1)
+        discard;
+    vec3 albedo = texColor.rgb;
+    vec3 specularColor = vec3(texture(material.specular, TexCoords));
+
+    // 
+    vec3 norm = normalize(Normal);
+    vec3 viewDir = normalize(viewPos - FragPos);
+
+    // һ׶Σ
+    vec3 result = CalcDirLight(dirLight, norm, viewDir, albedo, specularColor, CalcShadow(FragPos, norm));
+
+    // ڶ׶ΣҵڵĴأеĹԴ
+    float viewDepth = -(view * vec4(FragPos, 1.0)).z;
+    int slice = int(clamp(floor(log(viewDepth) * clusterZScale - clusterZBias), 0.0, clusterGrid.z - 1.0));
+    ivec2 tile = ivec2(min(gl_FragCoord.xy / screenSize * clusterGrid.xy, clusterGrid.xy - 1.0));
+    int cluster = (slice * int(clusterGrid.y) + tile.y) * int(clusterGrid.x) + tile.x;
+    uvec2 record = texelFetch(clusters, cluster).xy;
+    for(uint i = 0u; i < record.y; i++)
+    {
+        int light = int(texelFetch(lightIndices, int(record.x + i)).r);
+        result += CalcClusterLight(light, norm, FragPos, viewDir, albedo, specularColor);
+    }
+
+    FragColor = vec4(result, texColor.a);
+}
+
+
+// 㺯
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir, vec3 albedo, vec3 specularColor, float shadow)
+{
+    vec3 lightDir = normalize(-light.direction);
+    // ɫ
+    float diff = max(dot(normal, lightDir), 0.0);
+    // ɫ
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    // ϲ
+    vec3 ambient  = light.ambient  * albedo;
+    vec3 diffuse  = light.diffuse  * diff * albedo;
+    vec3 specular = light.specular * spec * specularColor;
+    
+    return (ambient + (diffuse + specular) * shadow);
+}
+
+
+// йԴļ㺯壬ÿԴ6texel
+// 0 λ,   1 , cutOff  2 ambient, constant  3 diffuse, linear  4 specular, quadratic  5 outerCutOff, 뾶
+vec3 CalcClusterLight(int light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 albedo, vec3 specularColor)
+{
+    int base = light * 6;
+    vec4 positionType = texelFetch(lightData, base);
+    vec4 ambientConstant = texelFetch(lightData, base + 2);
+    vec4 diffuseLinear = texelFetch(lightData, base + 3);
+    vec4 specularQuadratic = texelFetch(lightData, base + 4);
+
+    vec3 lightDir = normalize(positionType.xyz - fragPos);
+    // ɫ
+    float diff = max(dot(normal, lightDir), 0.0);
+    // ɫ
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    // ˥
+    float distance    = length(positionType.xyz - fragPos);
+    float attenuation = 1.0 / (ambientConstant.w + diffuseLinear.w * distance + specularQuadratic.w * (distance * distance));
+
+    // ۹ƵĹշΧǶ
+    float intensity = 1.0;
+    if(positionType.w > 0.5)
+    {
+        vec4 directionCutOff = texelFetch(lightData, base + 1);
+        float outerCutOff = texelFetch(lightData, base + 5).x;
+        float theta = dot(lightDir, normalize(-directionCutOff.xyz));
+        float epsilon = directionCutOff.w - outerCutOff;
+        intensity = clamp((theta - outerCutOff) / epsilon, 0.0, 1.0);
+    }
+
+    // ϲ
+    vec3 ambient  = ambientConstant.xyz   * albedo;
+    vec3 diffuse  = diffuseLinear.xyz     * diff * albedo;
+    vec3 specular = specularQuadratic.xyz * spec * specularColor;
+
+    return (ambient + diffuse + specular) * attenuation * intensity;
+}
+
+
+// Ӱ㺯壬010ΪȫӰ
+float CalcShadow(vec3 fragPos, vec3 normal)
+{
+    // ͼռѡ
+    float viewDepth = -(shadowCameraView * vec4(fragPos, 1.0)).z;
+    int cascade = cascadeCount;
+    for(int i = 0; i < cascadeCount; i++)
+    {
+        if(viewDepth < cascadeSplits[i])
+        {
+            cascade = i;
+            break;
+        }
+    }
+    if(cascade >= cascadeCount)
+        return 1.0;
+
+    // طƫһأӰ
+    vec4 lightPos = lightSpaceMatrices[cascade] * vec4(fragPos + normal * cascadeTexelSizes[cascade], 1.0);
+    vec3 projCoords = lightPos.xyz / lightPos.w * 0.5 + 0.5;
+    if(projCoords.z > 1.0)
+        return 1.0;
+
+    // 3x3 PCF
+    float shadow = 0.0;
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    for(int x = -1; x <= 1; x++)
+    {
+        for(int y = -1; y <= 1; y++)
+            shadow += texture(shadowMap, vec4(projCoords.xy + vec2(x, y) * texelSize, cascade, projCoords.z));
+    }
+    return shadow / 9.0;
+}
@@ -0,0 +1,104 @@
+#version 330 core
+// ӳȾȫpass⣬Ҫյֱalbedo
+out vec4 FragColor;
+
+// Դ
+struct DirLight {
+    vec3 direction;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+in vec2 TexCoords;
+
+uniform sampler2D gAlbedoSpec;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+
+uniform DirLight dirLight;
+uniform float shininess;
+uniform vec3 viewPos;
+uniform mat4 invViewProj;
+
+// Ӱshadow.h
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 shadowCameraView;
+uniform mat4 lightSpaceMatrices[4];
+uniform float cascadeSplits[4];
+uniform float cascadeTexelSizes[4];
+uniform int cascadeCount;
+
+// Ӱ㺯
+float CalcShadow(vec3 fragPos, vec3 normal);
+
+void main()
+{
+    float depth = texture(gDepth, TexCoords).r;
+    // ûرɫ
+    if(depth >= 1.0)
+        discard;
+
+    vec4 albedoSpec = texture(gAlbedoSpec, TexCoords);
+    vec4 normalLit = texture(gNormal, TexCoords);
+    if(normalLit.a < 0.5)
+    {
+        FragColor = vec4(albedoSpec.rgb, 1.0);
+        return;
+    }
+
+    // ؽռλ
+    vec4 worldPos = invViewProj * vec4(vec3(TexCoords, depth) * 2.0 - 1.0, 1.0);
+    vec3 fragPos = worldPos.xyz / worldPos.w;
+
+    vec3 normal = normalize(normalLit.xyz);
+    vec3 viewDir = normalize(viewPos - fragPos);
+    vec3 lightDir = normalize(-dirLight.direction);
+    // ɫ
+    float diff = max(dot(normal, lightDir), 0.0);
+    // ɫ
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+    // ϲ
+    vec3 ambient  = dirLight.ambient  * albedoSpec.rgb;
+    vec3 diffuse  = dirLight.diffuse  * diff * albedoSpec.rgb;
+    vec3 specular = dirLight.specular * spec * albedoSpec.a;
+
+    FragColor = vec4(ambient + (diffuse + specular) * CalcShadow(fragPos, normal), 1.0);
+}
+
+
+// Ӱ㺯壬010ΪȫӰ
+float CalcShadow(vec3 fragPos, vec3 normal)
+{
+    // ͼռѡ
+    float viewDepth = -(shadowCameraView * vec4(fragPos, 1.0)).z;
+    int cascade = cascadeCount;
+    for(int i = 0; i < cascadeCount; i++)
+    {
+        if(viewDepth < cascadeSplits[i])
+        {
+            cascade = i;
+            break;
+        }
+    }
+    if(cascade >= cascadeCount)
+        return 1.0;
+
+    // طƫһأӰ
+    vec4 lightPos = lightSpaceMatrices[cascade] * vec4(fragPos + normal * cascadeTexelSizes[cascade], 1.0);
+    vec3 projCoords = lightPos.xyz / lightPos.w * 0.5 + 0.5;
+    if(projCoords.z > 1.0)
+        return 1.0;
+
+    // 3x3 PCF
+    float shadow = 0.0;
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    for(int x = -1; x <= 1; x++)
+    {
+        for(int y = -1; y <= 1; y++)
+            shadow += texture(shadowMap, vec4(projCoords.xy + vec2(x, y) * texelSize, cascade, projCoords.z));
+    }
+    return shadow / 9.0;
+}
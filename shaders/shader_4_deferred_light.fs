@@ -0,0 +1,73 @@
+#version 330 core
+// ӳȾĹԴpassֻԹԴΧ򸲸ǵؼԴ۹ƣӵ
+out vec4 FragColor;
+
+// Դ;۹ƹõĲlightTypeΪ0ǵԴΪ1Ǿ۹
+struct Light {
+    vec3 position;
+    vec3 direction;
+    float cutOff;
+    float outerCutOff;
+
+    float constant;
+    float linear;
+    float quadratic;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+uniform sampler2D gAlbedoSpec;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+
+uniform Light light;
+uniform int lightType;
+uniform float shininess;
+uniform vec3 viewPos;
+uniform mat4 invViewProj;
+uniform vec2 screenSize;
+
+void main()
+{
+    vec2 texCoords = gl_FragCoord.xy / screenSize;
+    vec4 normalLit = texture(gNormal, texCoords);
+    float depth = texture(gDepth, texCoords).r;
+    if(normalLit.a < 0.5 || depth >= 1.0)
+        discard;
+
+    vec4 albedoSpec = texture(gAlbedoSpec, texCoords);
+
+    // ؽռλ
+    vec4 worldPos = invViewProj * vec4(vec3(texCoords, depth) * 2.0 - 1.0, 1.0);
+    vec3 fragPos = worldPos.xyz / worldPos.w;
+
+    vec3 normal = normalize(normalLit.xyz);
+    vec3 viewDir = normalize(viewPos - fragPos);
+    vec3 lightDir = normalize(light.position - fragPos);
+    // ɫ
+    float diff = max(dot(normal, lightDir), 0.0);
+    // ɫ
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+    // ˥
+    float distance    = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+
+    // ۹ƵĹշΧǶ
+    float intensity = 1.0;
+    if(lightType == 1)
+    {
+        float theta = dot(lightDir, normalize(-light.direction));
+        float epsilon = light.cutOff - light.outerCutOff;
+        intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+    }
+
+    // ϲ
+    vec3 ambient  = light.ambient  * albedoSpec.rgb;
+    vec3 diffuse  = light.diffuse  * diff * albedoSpec.rgb;
+    vec3 specular = light.specular * spec * albedoSpec.a;
+
+    FragColor = vec4((ambient + diffuse + specular) * attenuation * intensity, 1.0);
+}
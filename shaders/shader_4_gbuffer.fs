@@ -0,0 +1,28 @@
+#version 330 core
+// G-bufferalbedo͸߹ǿȡռ䷨ߺǷҪ
+layout (location = 0) out vec4 gAlbedoSpec;
+layout (location = 1) out vec4 gNormal;
+
+// 
+struct Material {
+    sampler2D diffuse;
+    sampler2D specular;
+    float     shininess;
+}; 
+
+in vec3 Normal;
+in vec3 FragPos;
+in vec2 TexCoords;
+
+uniform Material material;
+uniform bool lit;  // Ϊfalseʱս׶ֱalbedo
+
+void main()
+{
+    vec4 texColor = texture(material.diffuse, TexCoords);
+    if(texColor.a < 0.1)
+        discard;
+
+    gAlbedoSpec = vec4(texColor.rgb, texture(material.specular, TexCoords).r);
+    gNormal = vec4(normalize(Normal), lit ? 1.0 : 0.0);
+}
@@ -0,0 +1,32 @@
+#version 330 core
+// Ȩ˳޹͸ͬʱۻĿȨĿ
+layout (location = 0) out vec4 AccumColor;
+layout (location = 1) out vec4 AccumWeight;
+
+// 
+struct Material {
+    sampler2D diffuse;
+    sampler2D specular;
+    float     shininess;
+}; 
+
+in vec3 Normal;
+in vec3 FragPos;
+in vec2 TexCoords;
+
+uniform Material material;
+
+void main()
+{
+    vec4 texColor = texture(material.diffuse, TexCoords);
+    if(texColor.a < 0.01)
+        discard;
+
+    // ԽȨԽƷΧֹ뾫ȸ
+    float weight = clamp(texColor.a * max(1e-2, 3e3 * pow(1.0 - gl_FragCoord.z, 3.0)), 1e-2, 3e3);
+
+    // rgbۼԤɫaͨ۳(1 - alpha)õ͸(revealage)
+    AccumColor = vec4(texColor.rgb * texColor.a * weight, texColor.a);
+    // rۼȨ
+    AccumWeight = vec4(texColor.a * weight, 0.0, 0.0, texColor.a);
+}
@@ -0,0 +1,22 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D accumTexture;
+uniform sampler2D weightTexture;
+
+void main()
+{
+    vec4 accum = texture(accumTexture, TexCoords);
+    float revealage = accum.a;
+    // û͸帲ǵֱӱ͸
+    if(revealage >= 1.0)
+        discard;
+
+    float weight = texture(weightTexture, TexCoords).r;
+    vec3 averageColor = accum.rgb / max(weight, 1e-5);
+
+    // ʹͨalphaϵӵ͸
+    FragColor = vec4(averageColor, 1.0 - revealage);
+}
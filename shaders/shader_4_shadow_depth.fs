@@ -0,0 +1,19 @@
+#version 330 core
+// ȾӰͼֻдȣ͸ȵ͵زͶӰ
+
+// 
+struct Material {
+    sampler2D diffuse;
+    sampler2D specular;
+    float     shininess;
+}; 
+
+in vec2 TexCoords;
+
+uniform Material material;
+
+void main()
+{
+    if(texture(material.diffuse, TexCoords).a < 0.1)
+        discard;
+}
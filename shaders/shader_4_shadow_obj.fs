@@ -0,0 +1,206 @@
+#version 330 core
+// shader_2_obj.fsͬϼӰ
+out vec4 FragColor;
+
+// 
+struct Material {
+    sampler2D diffuse;
+    sampler2D specular;
+    float     shininess;
+}; 
+
+// Դ
+struct DirLight {
+    vec3 direction;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+// Դ
+struct PointLight {
+    vec3 position;
+
+    float constant;
+    float linear;
+    float quadratic;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};  
+
+// ۹
+struct SpotLight {
+    vec3 position;
+    vec3 direction;
+    float cutOff;
+    float outerCutOff;
+
+    float constant;
+    float linear;
+    float quadratic;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular; 
+};
+
+// 㺯
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir, float shadow);
+// Դ㺯
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
+// ۹Ƽ㺯
+vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
+// Ӱ㺯
+float CalcShadow(vec3 fragPos, vec3 normal);
+
+
+#define NR_POINT_LIGHTS 4
+
+in vec3 Normal;
+in vec3 FragPos;
+in vec2 TexCoords;
+
+uniform DirLight dirLight;
+uniform PointLight pointLights[NR_POINT_LIGHTS];
+uniform int pointLightCount;
+uniform SpotLight spotLight;
+uniform Material material;
+uniform vec3 viewPos;
+
+// Ӱshadow.h
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 shadowCameraView;
+uniform mat4 lightSpaceMatrices[4];
+uniform float cascadeSplits[4];
+uniform float cascadeTexelSizes[4];
+uniform int cascadeCount;
+
+void main()
+{
+    // 
+    vec3 norm = normalize(Normal);
+    vec3 viewDir = normalize(viewPos - FragPos);
+
+    // һ׶Σ
+    vec3 result = CalcDirLight(dirLight, norm, viewDir, CalcShadow(FragPos, norm));
+    // ڶ׶ΣԴ
+    for(int i = 0; i < pointLightCount; i++)
+        result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);    
+    // ׶Σ۹
+    result += CalcSpotLight(spotLight, norm, FragPos, viewDir);    
+
+    FragColor = vec4(result, 1.0);
+}
+
+
+// 㺯
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir, float shadow)
+{
+    vec3 lightDir = normalize(-light.direction);
+    // ɫ
+    float diff = max(dot(normal, lightDir), 0.0);
+    // ɫ
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    // ϲ
+    vec3 ambient  = light.ambient  * vec3(texture(material.diffuse, TexCoords));
+    vec3 diffuse  = light.diffuse  * diff * vec3(texture(material.diffuse, TexCoords));
+    vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
+    
+    return (ambient + (diffuse + specular) * shadow);
+}
+
+
+// Դ㺯
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+    vec3 lightDir = normalize(light.position - fragPos);
+    // ɫ
+    float diff = max(dot(normal, lightDir), 0.0);
+    // ɫ
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    // ˥
+    float distance    = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+    // ϲ
+    vec3 ambient  = light.ambient  * vec3(texture(material.diffuse, TexCoords));
+    vec3 diffuse  = light.diffuse  * diff * vec3(texture(material.diffuse, TexCoords));
+    vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
+    ambient  *= attenuation;
+    diffuse  *= attenuation;
+    specular *= attenuation;
+
+    return (ambient + diffuse + specular);
+}
+
+
+// ۹Ƽ㺯
+vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+    vec3 lightDir = normalize(light.position - fragPos);
+
+    // շΧǶ
+    float theta = dot(lightDir, normalize(-light.direction));
+    float epsilon   = light.cutOff - light.outerCutOff;
+    float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+
+    // ˥
+    float distance = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+
+    // 
+    float diff = max(dot(normal, lightDir), 0.0);
+    // 
+    vec3 reflectDir = reflect(-lightDir, normal);  
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+
+    // ϲ
+    vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoords));
+    vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoords));
+    vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
+
+    ambient *= attenuation * intensity;
+    diffuse *= attenuation * intensity;
+    specular *= attenuation * intensity;
+
+    return (ambient + diffuse + specular);
+}
+
+
+// Ӱ㺯壬010ΪȫӰ
+float CalcShadow(vec3 fragPos, vec3 normal)
+{
+    // ͼռѡ
+    float viewDepth = -(shadowCameraView * vec4(fragPos, 1.0)).z;
+    int cascade = cascadeCount;
+    for(int i = 0; i < cascadeCount; i++)
+    {
+        if(viewDepth < cascadeSplits[i])
+        {
+            cascade = i;
+            break;
+        }
+    }
+    if(cascade >= cascadeCount)
+        return 1.0;
+
+    // طƫһأӰ
+    vec4 lightPos = lightSpaceMatrices[cascade] * vec4(fragPos + normal * cascadeTexelSizes[cascade], 1.0);
+    vec3 projCoords = lightPos.xyz / lightPos.w * 0.5 + 0.5;
+    if(projCoords.z > 1.0)
+        return 1.0;
+
+    // 3x3 PCF
+    float shadow = 0.0;
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    for(int x = -1; x <= 1; x++)
+    {
+        for(int y = -1; y <= 1; y++)
+            shadow += texture(shadowMap, vec4(projCoords.xy + vec2(x, y) * texelSize, cascade, projCoords.z));
+    }
+    return shadow / 9.0;
+}
@@ -0,0 +1,26 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D screenTexture;
+uniform float sharpness;  // 01
+
+// ԱȶӦ
+// ΧصĶԱȶԽԽǿѾıԵټǿְױ
+void main()
+{
+    vec3 center = texture(screenTexture, TexCoords).rgb;
+    vec3 up = textureOffset(screenTexture, TexCoords, ivec2(0, 1)).rgb;
+    vec3 left = textureOffset(screenTexture, TexCoords, ivec2(-1, 0)).rgb;
+    vec3 right = textureOffset(screenTexture, TexCoords, ivec2(1, 0)).rgb;
+    vec3 down = textureOffset(screenTexture, TexCoords, ivec2(0, -1)).rgb;
+
+    vec3 minColor = min(center, min(min(up, down), min(left, right)));
+    vec3 maxColor = max(center, max(max(up, down), max(left, right)));
+    vec3 amount = sqrt(clamp(min(minColor, 1.0 - maxColor) / max(maxColor, vec3(0.0001)), 0.0, 1.0));
+    vec3 weight = amount * (-1.0 / mix(8.0, 5.0, sharpness));
+
+    vec3 color = (center + (up + left + right + down) * weight) / (1.0 + 4.0 * weight);
+    FragColor = vec4(clamp(color, 0.0, 1.0), 1.0);
+}
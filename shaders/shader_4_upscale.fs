@@ -0,0 +1,56 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D screenTexture;
+
+float luma(vec3 color)
+{
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+// ԵӦŴ
+// Catmull-RomֵԵ̶ȣ2x2طΧȥ
+// ƽ̹ʹ˫ԲֵŴ
+void main()
+{
+    vec2 size = vec2(textureSize(screenTexture, 0));
+    vec2 pos = TexCoords * size - 0.5;
+    vec2 base = floor(pos);
+    vec2 f = pos - base;
+
+    // Catmull-RomȨأмϲһ˫Բ
+    vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    vec2 w3 = f * f * (-0.5 + 0.5 * f);
+    vec2 w12 = w1 + w2;
+    vec2 t0 = (base - 0.5) / size;
+    vec2 t12 = (base + 0.5 + w2 / w12) / size;
+    vec2 t3 = (base + 2.5) / size;
+
+    vec3 bicubic =
+        texture(screenTexture, vec2(t0.x, t0.y)).rgb * w0.x * w0.y +
+        texture(screenTexture, vec2(t12.x, t0.y)).rgb * w12.x * w0.y +
+        texture(screenTexture, vec2(t3.x, t0.y)).rgb * w3.x * w0.y +
+        texture(screenTexture, vec2(t0.x, t12.y)).rgb * w0.x * w12.y +
+        texture(screenTexture, vec2(t12.x, t12.y)).rgb * w12.x * w12.y +
+        texture(screenTexture, vec2(t3.x, t12.y)).rgb * w3.x * w12.y +
+        texture(screenTexture, vec2(t0.x, t3.y)).rgb * w0.x * w3.y +
+        texture(screenTexture, vec2(t12.x, t3.y)).rgb * w12.x * w3.y +
+        texture(screenTexture, vec2(t3.x, t3.y)).rgb * w3.x * w3.y;
+
+    // 2x2
+    vec3 c00 = texture(screenTexture, (base + vec2(0.5, 0.5)) / size).rgb;
+    vec3 c10 = texture(screenTexture, (base + vec2(1.5, 0.5)) / size).rgb;
+    vec3 c01 = texture(screenTexture, (base + vec2(0.5, 1.5)) / size).rgb;
+    vec3 c11 = texture(screenTexture, (base + vec2(1.5, 1.5)) / size).rgb;
+    vec3 minColor = min(min(c00, c10), min(c01, c11));
+    vec3 maxColor = max(max(c00, c10), max(c01, c11));
+    bicubic = clamp(bicubic, minColor, maxColor);
+
+    vec3 bilinear = mix(mix(c00, c10, f.x), mix(c01, c11, f.x), f.y);
+    float edge = smoothstep(0.02, 0.15, luma(maxColor) - luma(minColor));
+    FragColor = vec4(mix(bilinear, bicubic, edge), 1.0);
+}
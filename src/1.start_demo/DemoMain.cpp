@@ -207,7 +207,7 @@ int run()
     stbi_image_free(data);
 
     ourShader.use();
-    glUniform1i(glGetUniformLocation(ourShader.mID, "texture1"), 0);
+    glUniform1i(glGetUniformLocation(ourShader.GetID(), "texture1"), 0);
     ourShader.setInt("texture2", 1);
 
     // ģ;ӽǾͶӰ
@@ -244,7 +244,7 @@ int run()
         ourShader.use();
 
         view = ourCamera.GetViewMatrix();
-        glUniformMatrix4fv(glGetUniformLocation(ourShader.mID, "view"), 1, GL_FALSE, glm::value_ptr(view));
+        glUniformMatrix4fv(glGetUniformLocation(ourShader.GetID(), "view"), 1, GL_FALSE, glm::value_ptr(view));
 
         glBindVertexArray(VAO);
         for (unsigned int i = 0; i < 10; i++)
@@ -252,14 +252,14 @@ int run()
             model = glm::mat4(1.0f);
             model = glm::translate(model, cubePositions[i]);
             model = glm::rotate(model, glm::radians(20.0f * i), glm::vec3(1.0f, 0.3f, 0.5f));
-            glUniformMatrix4fv(glGetUniformLocation(ourShader.mID, "model"), 1, GL_FALSE, glm::value_ptr(model));
+            glUniformMatrix4fv(glGetUniformLocation(ourShader.GetID(), "model"), 1, GL_FALSE, glm::value_ptr(model));
 
             glDrawArrays(GL_TRIANGLES, 0, 36);
         }
 
 
         projection = ourCamera.GetProjectMatrix();
-        glUniformMatrix4fv(glGetUniformLocation(ourShader.mID, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+        glUniformMatrix4fv(glGetUniformLocation(ourShader.GetID(), "projection"), 1, GL_FALSE, glm::value_ptr(projection));
 
         //glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 
@@ -2,6 +2,7 @@
 #include <GLFW/glfw3.h>
 #include <stb_image.h>
 #include <iostream>
+#include <memory>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -12,6 +13,7 @@
 #include <mylib/filesystem.h>
 #include <mylib/mesh.h>
 #include <mylib/model.h>
+#include <mylib/benchmark.h>
 
 
 // ڴС
@@ -76,8 +78,27 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos)
 }
 
 
-int main()
+// ÷4_1.stencil_demo [׼Բ] [--stats-log ļ]׼ԲBenchmarkOptions
+// ָ--stats-logʱȾͳÿ60֡дһεļչΪ.jsonʱΪJSONΪCSV
+// ׼ʱ·ƶӦ룬رմֱͬ˳˻ʱ1
+int main(int argc, char* argv[])
 {
+    BenchmarkOptions benchmarkOptions;
+    std::vector<std::string> options;
+    if (!benchmarkOptions.Parse(argc, argv, &options)) {
+        return -1;
+    }
+    std::string statsLogPath;
+    for (std::size_t i = 0; i < options.size(); i++) {
+        if (options[i] == "--stats-log" && i + 1 < options.size()) {
+            statsLogPath = options[++i];
+        }
+        else {
+            std::cout << "Unknown option: " << options[i] << std::endl;
+            return -1;
+        }
+    }
+
     // ʼ汾
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -101,6 +122,9 @@ int main()
         return -1;
     }
 
+    // shader֮󴴽˳ʱɾGPU󡢱й©رGLFW
+    GpuResourcesShutdown gpuShutdown(glfwTerminate);
+
     glm::vec3 model1Position(0.0f, 0.01f, -5.0f); // ģ1λ ̧һֹȳͻ
     glm::vec3 model2Position(3.0f, 0.0f, -9.0f); // ģ2λ
     glm::vec3 planePosition(0.0f, -1.5f, 0.0f); // ذλ
@@ -110,8 +134,8 @@ int main()
     Shader objectShader(FileSystem::getPath("shaders/shader_3_obj.vs").c_str(), FileSystem::getPath("shaders/shader_2_obj.fs").c_str());
     // Ⱦ߿õshader
     Shader outlineShader(FileSystem::getPath("shaders/shader_3_obj.vs").c_str(), FileSystem::getPath("shaders/shader_3_obj_1.fs").c_str());
+    // ͬһģͻƣֻλòͬģֻƶܸ
     Model cubeModel1(Mesh::CreateCube(3.0f, FileSystem::getPath("resources/marble.jpg").c_str()));
-    Model cubeModel2(cubeModel1);
 
     LightParameters::MaterialParam lightMaterial(0, 1, 32.0f);
     LightParameters::DirectLight directLight(glm::vec3(1.0f, -1.0f, -1.0f), glm::vec3(0.05f), glm::vec3(3.5f), glm::vec3(0.5f));
@@ -122,7 +146,6 @@ int main()
 
     // Ⱦobjùղ
     cubeModel1.SetLightParameters(objectShader, allLightParams);
-    cubeModel2.SetLightParameters(objectShader, allLightParams);
 
     // ƹshader
     Shader lightingShader(FileSystem::getPath("shaders/shader_2_light.vs").c_str(), FileSystem::getPath("shaders/shader_2_light.fs").c_str());
@@ -136,6 +159,17 @@ int main()
     double lastFrame = glfwGetTime(); // һ֡ʱ
     double currentFrame = glfwGetTime(); // ǰ֡ʱ
 
+    // ׼Ĭϵ·ģ1תһȦ
+    std::unique_ptr<Benchmark> benchmark;
+    if (benchmarkOptions.mEnabled) {
+        CameraPath benchmarkPath;
+        if (!benchmarkOptions.LoadPath(CameraPath::Orbit(model1Position, 10.0f, 2.0f, 20.0f), benchmarkPath)) {
+            return -1;
+        }
+        benchmark.reset(new Benchmark("4_1.stencil_demo", benchmarkPath, windowWidth, windowHeight, benchmarkOptions.mSettings));
+        glfwSwapInterval(0);
+    }
+
     // ꣬׽λ
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
@@ -147,14 +181,29 @@ int main()
     glEnable(GL_STENCIL_TEST);
     glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
 
+    // Դϴ㵽һ֡
+    RenderStats::Get().Reset();
+    RenderStatsExporter statsExporter;
+    if (!statsLogPath.empty()) {
+        if (!statsExporter.Open(statsLogPath, 60)) {
+            return -1;
+        }
+        RenderStats::Get().SetExporter(&statsExporter);
+    }
+
     // ȾѭݴٶȵõƵʻвͬҪ֡
     while (!glfwWindowShouldClose(window))
     {
-        currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
-
-        processInput(window, deltaTime);
+        if (benchmark) {
+            currentFrame = benchmark->BeginFrame(ourCamera);
+            deltaTime = benchmark->GetDeltaTime();
+        }
+        else {
+            currentFrame = glfwGetTime();
+            deltaTime = currentFrame - lastFrame;
+            lastFrame = currentFrame;
+            processInput(window, deltaTime);
+        }
 
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glStencilMask(0xFF);
@@ -185,23 +234,34 @@ int main()
         glStencilMask(0xFF);
         glClear(GL_STENCIL_BUFFER_BIT);
         modelRenderParam.SetModelPosition(model2Position);
-        cubeModel2.UpdateLightParam(objectShader, modelRenderParam);
-        cubeModel2.Draw(objectShader, modelRenderParam);
+        cubeModel1.UpdateLightParam(objectShader, modelRenderParam);
+        cubeModel1.Draw(objectShader, modelRenderParam);
         // ģ2߿
         glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
         glStencilMask(0x00);
         modelRenderParam.SetModelScale(1.05);
-        cubeModel2.Draw(outlineShader, modelRenderParam);
+        cubeModel1.Draw(outlineShader, modelRenderParam);
 
         // Ƶ
         modelRenderParam.SetModelPosition(lightPosition);
         lightCube.Draw(lightingShader, modelRenderParam);
 
+        if (benchmark) {
+            benchmark->EndFrame();
+        }
+        // һ֡ͳư֡passܣȻ
+        RenderStats::Get().EndFrame();
+        if (benchmark && benchmark->IsFinished()) {
+            break;
+        }
+
         glfwSwapBuffers(window);
+        // ɾGPUѾġͷ˵Ķ
+        GpuResources::Get().EndFrame();
         // Ƿд¼롢꣩´״̬
         glfwPollEvents();
     }
 
-    glfwTerminate();
-    return 0;
+    RenderStats::Get().SetExporter(nullptr);
+    return benchmark ? benchmarkOptions.Finish(benchmark->GetResult()) : 0;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <GLFW/glfw3.h>
 #include <stb_image.h>
 #include <iostream>
+#include <memory>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -12,6 +13,7 @@
 #include <mylib/filesystem.h>
 #include <mylib/mesh.h>
 #include <mylib/model.h>
+#include <mylib/benchmark.h>
 
 
 // ڴС
@@ -76,8 +78,27 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos)
 }
 
 
-int main()
+// ÷4_2.blend_demo [׼Բ] [--stats-log ļ]׼ԲBenchmarkOptions
+// ָ--stats-logʱȾͳÿ60֡дһεļչΪ.jsonʱΪJSONΪCSV
+// ׼ʱ·ƶӦ룬رմֱͬ˳˻ʱ1
+int main(int argc, char* argv[])
 {
+    BenchmarkOptions benchmarkOptions;
+    std::vector<std::string> options;
+    if (!benchmarkOptions.Parse(argc, argv, &options)) {
+        return -1;
+    }
+    std::string statsLogPath;
+    for (std::size_t i = 0; i < options.size(); i++) {
+        if (options[i] == "--stats-log" && i + 1 < options.size()) {
+            statsLogPath = options[++i];
+        }
+        else {
+            std::cout << "Unknown option: " << options[i] << std::endl;
+            return -1;
+        }
+    }
+
     // ʼ汾
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -101,6 +122,9 @@ int main()
         return -1;
     }
 
+    // shader֮󴴽˳ʱɾGPU󡢱й©رGLFW
+    GpuResourcesShutdown gpuShutdown(glfwTerminate);
+
     glm::vec3 model1Position(0.0f, 0.01f, -5.0f); // ģ1λ ̧һֹȳͻ
     glm::vec3 grassPositions[] = {
         {-5.5f,  0.0f, -5.48f},
@@ -150,6 +174,17 @@ int main()
     double lastFrame = glfwGetTime(); // һ֡ʱ
     double currentFrame = glfwGetTime(); // ǰ֡ʱ
 
+    // ׼Ĭϵ·ģ1תһȦ
+    std::unique_ptr<Benchmark> benchmark;
+    if (benchmarkOptions.mEnabled) {
+        CameraPath benchmarkPath;
+        if (!benchmarkOptions.LoadPath(CameraPath::Orbit(model1Position, 10.0f, 2.0f, 20.0f), benchmarkPath)) {
+            return -1;
+        }
+        benchmark.reset(new Benchmark("4_2.blend_demo", benchmarkPath, windowWidth, windowHeight, benchmarkOptions.mSettings));
+        glfwSwapInterval(0);
+    }
+
     // ꣬׽λ
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
@@ -166,14 +201,29 @@ int main()
     glCullFace(GL_BACK);
     glFrontFace(GL_CCW);
 
+    // Դϴ㵽һ֡
+    RenderStats::Get().Reset();
+    RenderStatsExporter statsExporter;
+    if (!statsLogPath.empty()) {
+        if (!statsExporter.Open(statsLogPath, 60)) {
+            return -1;
+        }
+        RenderStats::Get().SetExporter(&statsExporter);
+    }
+
     // ȾѭݴٶȵõƵʻвͬҪ֡
     while (!glfwWindowShouldClose(window))
     {
-        currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
-
-        processInput(window, deltaTime);
+        if (benchmark) {
+            currentFrame = benchmark->BeginFrame(ourCamera);
+            deltaTime = benchmark->GetDeltaTime();
+        }
+        else {
+            currentFrame = glfwGetTime();
+            deltaTime = currentFrame - lastFrame;
+            lastFrame = currentFrame;
+            processInput(window, deltaTime);
+        }
 
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glStencilMask(0xFF);
@@ -200,22 +250,37 @@ int main()
         modelRenderParam.SetModelPosition(lightPosition);
         lightCube.Draw(lightingShader, modelRenderParam);
 
-        // ƴȾ
-        std::map<float, glm::vec3> sortedPos;
-        for (auto&& pos : windowPositions) {
-            float distance = glm::length(pos - ourCamera.GetPos());
-            sortedPos[distance] = pos;
+        // ƴȾõmapڵĿУʱ֡ڴ滹û
+        {
+            FrameMap<float, glm::vec3> sortedPos;
+            for (auto&& pos : windowPositions) {
+                float distance = glm::length(pos - ourCamera.GetPos());
+                sortedPos[distance] = pos;
+            }
+            for (auto it = sortedPos.rbegin(); it != sortedPos.rend(); it++) {
+                modelRenderParam.SetModelPosition(it->second);
+                windowModel.Draw(windowShader, modelRenderParam);
+            }
+        }
+
+        if (benchmark) {
+            benchmark->EndFrame();
         }
-        for (std::map<float, glm::vec3>::reverse_iterator it = sortedPos.rbegin(); it != sortedPos.rend(); it++) {
-            modelRenderParam.SetModelPosition(it->second);
-            windowModel.Draw(windowShader, modelRenderParam);
+        // һ֡ͳư֡passܣȻ
+        RenderStats::Get().EndFrame();
+        if (benchmark && benchmark->IsFinished()) {
+            break;
         }
 
         glfwSwapBuffers(window);
+        // ɾGPUѾġͷ˵Ķ
+        GpuResources::Get().EndFrame();
+        // һ֡ʱڴȫ
+        FrameArena::ResetAll();
         // Ƿд¼롢꣩´״̬
         glfwPollEvents();
     }
 
-    glfwTerminate();
-    return 0;
+    RenderStats::Get().SetExporter(nullptr);
+    return benchmark ? benchmarkOptions.Finish(benchmark->GetResult()) : 0;
 }
\ No newline at end of file
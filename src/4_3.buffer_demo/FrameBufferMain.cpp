@@ -2,6 +2,7 @@
 #include <GLFW/glfw3.h>
 #include <stb_image.h>
 #include <iostream>
+#include <memory>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -12,6 +13,16 @@
 #include <mylib/filesystem.h>
 #include <mylib/mesh.h>
 #include <mylib/model.h>
+#include <mylib/oit.h>
+#include <mylib/render_target.h>
+#include <mylib/post_chain.h>
+#include <mylib/dynamic_resolution.h>
+#include <mylib/profiler.h>
+#include <mylib/benchmark.h>
+#include <mylib/deferred.h>
+#include <mylib/cluster.h>
+#include <mylib/light_assign.h>
+#include <mylib/shadow.h>
 
 
 // ڴС
@@ -26,6 +37,28 @@ bool firstMouse = true;
 // ȫ
 Camera ourCamera;
 
+// ͸Ⱦģʽ / ȨOIT
+enum class TransparencyMode { sorted, oit };
+TransparencyMode transparencyMode = TransparencyMode::oit;
+// ǷҪԱ͸ģʽĻ
+bool compareTransparency = false;
+
+// ͸ȾʽǰȾ / ӳȾ / ִǰȾ
+enum class RenderPath { forward, deferred, clustered };
+const char* renderPathNames[] = { "forward", "deferred", "clustered" };
+RenderPath renderPath = RenderPath::forward;
+
+// ĻʱʹõĺԵ / Ҷȷɫ / ˹ģɫӳ
+const int postChainCount = 3;
+int postChainIndex = 0;
+
+// ǷGPU֡ʱ䶯̬ķֱ
+bool dynamicResolutionEnabled = true;
+// Ƿ񵼳ܷĽ
+bool writeProfile = false;
+// Ƿ¼·
+bool recordCameraPath = false;
+
 // ڻص
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
@@ -75,9 +108,60 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos)
     lastY = ypos;
 }
 
+// صOл͸ȾģʽPԱģʽĻ죬Gл͸ȾʽKлRضֱ̬ʣTܷBʼ/¼·
+void key_callback(GLFWwindow* /*window*/, int key, int /*scancode*/, int action, int /*mods*/)
+{
+    if (action != GLFW_PRESS)
+        return;
+
+    if (key == GLFW_KEY_O) {
+        transparencyMode = transparencyMode == TransparencyMode::sorted ? TransparencyMode::oit : TransparencyMode::sorted;
+        std::cout << "Transparency mode: " << (transparencyMode == TransparencyMode::sorted ? "sorted" : "OIT") << std::endl;
+    }
+    else if (key == GLFW_KEY_P) {
+        compareTransparency = true;
+    }
+    else if (key == GLFW_KEY_G) {
+        renderPath = static_cast<RenderPath>((static_cast<int>(renderPath) + 1) % 3);
+        std::cout << "Render path: " << renderPathNames[static_cast<int>(renderPath)] << std::endl;
+    }
+    else if (key == GLFW_KEY_K) {
+        postChainIndex = (postChainIndex + 1) % postChainCount;
+    }
+    else if (key == GLFW_KEY_R) {
+        dynamicResolutionEnabled = !dynamicResolutionEnabled;
+        std::cout << "Dynamic resolution: " << (dynamicResolutionEnabled ? "on" : "off") << std::endl;
+    }
+    else if (key == GLFW_KEY_T) {
+        writeProfile = true;
+    }
+    else if (key == GLFW_KEY_B) {
+        recordCameraPath = !recordCameraPath;
+    }
+}
+
 
-int main()
+// ÷4_3.buffer_demo [׼Բ] [--stats-log ļ]׼ԲBenchmarkOptions
+// ָ--stats-logʱȾͳÿ60֡дһεļչΪ.jsonʱΪJSONΪCSV
+// ׼ʱ·ƶӦ룬رմֱͬͶֱ̬ʣ˳˻ʱ1
+int main(int argc, char* argv[])
 {
+    BenchmarkOptions benchmarkOptions;
+    std::vector<std::string> options;
+    if (!benchmarkOptions.Parse(argc, argv, &options)) {
+        return -1;
+    }
+    std::string statsLogPath;
+    for (std::size_t i = 0; i < options.size(); i++) {
+        if (options[i] == "--stats-log" && i + 1 < options.size()) {
+            statsLogPath = options[++i];
+        }
+        else {
+            std::cout << "Unknown option: " << options[i] << std::endl;
+            return -1;
+        }
+    }
+
     // ʼ汾
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -94,6 +178,7 @@ int main()
     glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetKeyCallback(window, key_callback);
 
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
@@ -101,6 +186,11 @@ int main()
         return -1;
     }
 
+    // shader֮󴴽˳ʱɾGPU󡢱й©رGLFW
+    GpuResourcesShutdown gpuShutdown(glfwTerminate);
+
+    Profiler::Get().SetThreadName("main");
+
     glm::vec3 model1Position(0.0f, 0.01f, -5.0f); // ģ1λ ̧һֹȳͻ
     glm::vec3 grassPositions[] = {
         {-5.5f,  0.0f, -5.48f},
@@ -119,8 +209,11 @@ int main()
     glm::vec3 lightPosition(4.0f, 5.0f, -3.0f);  // Դλ
 
     // Ⱦõshader
-    Shader objectShader(FileSystem::getPath("shaders/shader_3_obj.vs").c_str(), FileSystem::getPath("shaders/shader_2_obj.fs").c_str());
+    Shader objectShader(FileSystem::getPath("shaders/shader_3_obj.vs").c_str(), FileSystem::getPath("shaders/shader_4_shadow_obj.fs").c_str());
     Model cubeModel1(Mesh::CreateCube(3.0f, FileSystem::getPath("resources/marble.jpg").c_str()));
+    // ģ1תС飬Ϊ̬ӰͶ
+    Model orbitCube(Mesh::CreateCube(1.0f, FileSystem::getPath("resources/marble.jpg").c_str()));
+    glm::vec3 orbitPosition = model1Position;
 
     // Ⱦobjùղ
     LightParameters::MaterialParam lightMaterial(0, 1, 32.0f);
@@ -150,6 +243,20 @@ int main()
     double lastFrame = glfwGetTime(); // һ֡ʱ
     double currentFrame = glfwGetTime(); // ǰ֡ʱ
 
+    // ׼Ĭϵ·ģ1תһȦ
+    std::unique_ptr<Benchmark> benchmark;
+    if (benchmarkOptions.mEnabled) {
+        CameraPath benchmarkPath;
+        if (!benchmarkOptions.LoadPath(CameraPath::Orbit(model1Position, 10.0f, 2.0f, 20.0f), benchmarkPath)) {
+            return -1;
+        }
+        benchmark.reset(new Benchmark("4_3.buffer_demo", benchmarkPath, windowWidth, windowHeight, benchmarkOptions.mSettings));
+        dynamicResolutionEnabled = false;
+        glfwSwapInterval(0);
+    }
+    CameraPath recordedPath;
+    double recordStart = 0.0;
+
     // ꣬׽λ
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
@@ -166,40 +273,13 @@ int main()
     glCullFace(GL_BACK);
     glFrontFace(GL_CCW);
 
-    // ֡
-    unsigned int fbo;
-    glGenFramebuffers(1, &fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-
-    // 
-    unsigned int texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, windowWidth, windowHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
-
-
-    // Ⱦ
-    unsigned int rbo;
-    glGenRenderbuffers(1, &rbo);
-    glBindRenderbuffer(GL_RENDERBUFFER, rbo);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, windowWidth, windowHeight);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rbo);
-
-    // ֡Ƿ
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        std::cout << "Create frame buffers error!" << std::endl;
-        return 0;
-    }
-
-    // ֡
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // ɫÿ֡ӶȡڴС仯Զ´С
+    RenderTargetPool renderTargets(windowWidth, windowHeight);
+    RenderTarget* sceneColor = nullptr;
+    RenderTarget* sceneDepth = nullptr;
+    unsigned int fbo = 0;
 
     // Ⱦ֡ҪƬ
-    Shader frameBufferShader(FileSystem::getPath("shaders/shader_4_buffer_1.vs").c_str(), FileSystem::getPath("shaders/shader_4_buffer_4.fs").c_str());
     unsigned int bufferVAO, bufferVBO;
     glGenVertexArrays(1, &bufferVAO);
     glGenBuffers(1, &bufferVBO);
@@ -224,74 +304,468 @@ int main()
     glBindVertexArray(0);
 
 
-    // ȾѭݴٶȵõƵʻвͬҪ֡
-    while (!glfwWindowShouldClose(window))
-    {
-        currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+    // ĻĺصЧϲpassУģɺpass
+    PostChain edgeChain(renderTargets);
+    edgeChain.Edge().Build();
+    PostChain invertChain(renderTargets);
+    invertChain.Grayscale().Invert().Build();
+    PostChain blurChain(renderTargets);
+    blurChain.GaussianBlur(2.0f).Tonemap(1.5f).Build();
+    PostChain* postChains[postChainCount] = { &edgeChain, &invertChain, &blurChain };
+    int activePostChain = -1;
+
+    // ֱ̬Ⱦ֮ٷŴ󵽴ڴС
+    DynamicResolution dynamicResolution;
+    SpatialUpscaler upscaler(renderTargets);
+    Shader upscaleShader(FileSystem::getPath("shaders/shader_4_buffer_1.vs").c_str(), FileSystem::getPath("shaders/shader_4_upscale.fs").c_str());
+    Shader sharpenShader(FileSystem::getPath("shaders/shader_4_buffer_1.vs").c_str(), FileSystem::getPath("shaders/shader_4_sharpen.fs").c_str());
+
+    // ˳޹͸֡壬볡Ȼ
+    // ۻĿG-bufferķ߸ʽͬӳȾʱֱӸG-buffer黹
+    OITFrameBuffer oitBuffer(renderTargets);
+    Shader oitShader(FileSystem::getPath("shaders/shader_3_obj.vs").c_str(), FileSystem::getPath("shaders/shader_4_oit.fs").c_str());
+    Shader oitCompositeShader(FileSystem::getPath("shaders/shader_4_buffer_1.vs").c_str(), FileSystem::getPath("shaders/shader_4_oit_composite.fs").c_str());
+
+    // ӳȾG-buffer͹shader
+    GBuffer gBuffer(renderTargets);
+    Shader gBufferShader(FileSystem::getPath("shaders/shader_3_obj.vs").c_str(), FileSystem::getPath("shaders/shader_4_gbuffer.fs").c_str());
+    gBufferShader.use();
+    gBufferShader.setInt("material.diffuse", lightMaterial.mDiffuse);
+    gBufferShader.setInt("material.specular", lightMaterial.mSpecular);
+    Shader deferredDirShader(FileSystem::getPath("shaders/shader_4_buffer_1.vs").c_str(), FileSystem::getPath("shaders/shader_4_deferred_dir.fs").c_str());
+    Shader deferredLightShader(FileSystem::getPath("shaders/shader_4_light_volume.vs").c_str(), FileSystem::getPath("shaders/shader_4_deferred_light.fs").c_str());
+    Model lightVolume(Mesh::CreateSphere(1.0f, 12, 16, ""));
+
+    // ڵذɢһЩɫСԴǰȾshader֧4ԴLightAssignerΪÿѡ
+    std::vector<LightParameters::PointLight> scenePointLights(allLightParams.mPointLights);
+    std::uint32_t seed = 12345;
+    auto random = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / 16777216.0f;
+    };
+    for (int i = 0; i < 128; i++) {
+        glm::vec3 position(random() * 40.0f - 20.0f, -1.0f, random() * -30.0f);
+        glm::vec3 color(random(), random(), random());
+        scenePointLights.emplace_back(position, 1.0f, 0.7f, 1.8f, glm::vec3(0.0f), color * 2.0f, color);
+    }
 
-        processInput(window, deltaTime);
+    // ǰȾʱÿֻϴӰļԴ
+    LightAssigner lightAssigner;
+    lightAssigner.SetLights(scenePointLights);
+    auto assignLights = [&](Model& model, const ModelRenderParam& modelRenderParam) {
+        glm::vec3 boundsCenter;
+        float boundsRadius;
+        model.GetWorldBounds(modelRenderParam.mModelTransMat, boundsCenter, boundsRadius);
+        objectShader.use();
+        lightAssigner.Apply(objectShader, boundsCenter, boundsRadius);
+    };
 
-        // 󶨵֡ϽȾ
+    // ִǰȾ
+    LightClusters lightClusters;
+    Shader clusteredShader(FileSystem::getPath("shaders/shader_3_obj.vs").c_str(), FileSystem::getPath("shaders/shader_4_clustered.fs").c_str());
+    cubeModel1.SetLightParameters(clusteredShader, allLightParams);
+
+    // ļӰذ塢ģ1ͲǾ̬壬ֻڻʧЧʱȾ
+    CascadedShadowMap shadowMap;
+    Shader shadowDepthShader(FileSystem::getPath("shaders/shader_3_obj.vs").c_str(), FileSystem::getPath("shaders/shader_4_shadow_depth.fs").c_str());
+    auto drawShadows = [&](const ModelRenderParam& modelRenderParam) {
+        GPU_PROFILE_SCOPE("Shadows");
+        shadowMap.Update(allLightParams.mDirectLight.mDirection, modelRenderParam);
+        shadowMap.Render(shadowDepthShader, modelRenderParam,
+            [&](Shader& depthShader, ModelRenderParam& lightParam) {
+                lightParam.SetModelPosition(planePosition);
+                plane.Draw(depthShader, lightParam);
+                lightParam.SetModelPosition(model1Position);
+                cubeModel1.Draw(depthShader, lightParam);
+                for (auto&& pos : grassPositions) {
+                    lightParam.SetModelPosition(pos);
+                    grassModel.Draw(depthShader, lightParam);
+                }
+            },
+            [&](Shader& depthShader, ModelRenderParam& lightParam) {
+                lightParam.SetModelPosition(orbitPosition);
+                orbitCube.Draw(depthShader, lightParam);
+            });
+    };
+
+    // ۹Ƹ
+    auto getCameraSpotLight = [&](const ModelRenderParam& modelRenderParam) {
+        LightParameters::SpotLight cameraSpotLight = allLightParams.mSpotLight;
+        cameraSpotLight.mPosition = modelRenderParam.mCameraPos;
+        cameraSpotLight.mDirection = modelRenderParam.mCameraDir;
+        return cameraSpotLight;
+    };
+
+    // ִshader󶨴ݺӰͼҪһ֡Ĳ͸׶θ¹
+    auto bindClusteredShader = [&](ModelRenderParam& modelRenderParam) {
+        clusteredShader.use();
+        clusteredShader.setVec3("viewPos"_uid, modelRenderParam.mCameraPos);
+        shadowMap.Bind(clusteredShader, 3);
+        lightClusters.Bind(clusteredShader, 4, glm::vec2(sceneColor->mWidth, sceneColor->mHeight));
+    };
+
+    // ӳȾ͸壺G-bufferԴĻռ
+    auto drawDeferred = [&](ModelRenderParam& modelRenderParam) {
+        GPU_PROFILE_SCOPE("Deferred");
+        gBuffer.BeginGeometry(sceneColor->mWidth, sceneColor->mHeight);
+
+        gBufferShader.use();
+        gBufferShader.setBool("lit"_uid, true);
+        modelRenderParam.SetModelPosition(planePosition);
+        plane.Draw(gBufferShader, modelRenderParam);
+        modelRenderParam.SetModelPosition(model1Position);
+        cubeModel1.Draw(gBufferShader, modelRenderParam);
+        modelRenderParam.SetModelPosition(orbitPosition);
+        orbitCube.Draw(gBufferShader, modelRenderParam);
+
+        // ǰȾвܹ
+        gBufferShader.setBool("lit"_uid, false);
+        for (auto&& pos : grassPositions) {
+            modelRenderParam.SetModelPosition(pos);
+            grassModel.Draw(gBufferShader, modelRenderParam);
+        }
+
+        gBuffer.EndGeometry(fbo);
+        deferredDirShader.use();
+        shadowMap.Bind(deferredDirShader, 3);
+        gBuffer.LightDirectional(deferredDirShader, bufferVAO, allLightParams, modelRenderParam, fbo);
+
+        gBuffer.LightVolumes(deferredLightShader, lightVolume, scenePointLights, getCameraSpotLight(modelRenderParam),
+            allLightParams.mMaterial.mShininess, modelRenderParam, fbo);
+        gBuffer.Release();
+
+        // ƱҪգڸƹֱǰ
+        modelRenderParam.SetModelPosition(lightPosition);
+        lightCube.Draw(lightingShader, modelRenderParam);
+    };
+
+    // Ʋ͸
+    auto drawOpaque = [&](ModelRenderParam& modelRenderParam) {
+        // ȾӰͼٻص֡
+        drawShadows(modelRenderParam);
+        GPU_PROFILE_SCOPE("Opaque");
         glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        glViewport(0, 0, sceneColor->mWidth, sceneColor->mHeight);
 
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        //glStencilMask(0xFF);// ڲʹģ建
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glEnable(GL_DEPTH_TEST);
+        if (renderPath == RenderPath::deferred) {
+            drawDeferred(modelRenderParam);
+            return;
+        }
 
-        ModelRenderParam modelRenderParam(ourCamera);
+        // ִȾCPUϰѹԴ䵽
+        Shader& litShader = renderPath == RenderPath::clustered ? clusteredShader : objectShader;
+        if (renderPath == RenderPath::clustered) {
+            lightClusters.Update(scenePointLights, { getCameraSpotLight(modelRenderParam) }, modelRenderParam.mViewMat, modelRenderParam.mProjMat);
+            bindClusteredShader(modelRenderParam);
+        }
+        else {
+            litShader.use();
+            shadowMap.Bind(litShader, 3);
+        }
 
         // Ƶذ
         modelRenderParam.SetModelPosition(planePosition);
-        plane.Draw(objectShader, modelRenderParam);
+        if (renderPath == RenderPath::forward) {
+            assignLights(plane, modelRenderParam);
+        }
+        plane.Draw(litShader, modelRenderParam);
 
         // ģ1
         modelRenderParam.SetModelPosition(model1Position);
-        cubeModel1.UpdateLightParam(objectShader, modelRenderParam);
-        cubeModel1.Draw(objectShader, modelRenderParam);
+        if (renderPath == RenderPath::forward) {
+            assignLights(cubeModel1, modelRenderParam);
+            cubeModel1.UpdateLightParam(objectShader, modelRenderParam);
+        }
+        cubeModel1.Draw(litShader, modelRenderParam);
+
+        // תС
+        modelRenderParam.SetModelPosition(orbitPosition);
+        if (renderPath == RenderPath::forward) {
+            assignLights(orbitCube, modelRenderParam);
+        }
+        orbitCube.Draw(litShader, modelRenderParam);
 
-        // Ʋ
+        // ƲݣִȾʱҲܴеĹԴ
+        Shader& grassDrawShader = renderPath == RenderPath::clustered ? clusteredShader : grassShader;
         for (auto&& pos : grassPositions) {
             modelRenderParam.SetModelPosition(pos);
-            grassModel.Draw(grassShader, modelRenderParam);
+            grassModel.Draw(grassDrawShader, modelRenderParam);
         }
 
         // Ƶ
         modelRenderParam.SetModelPosition(lightPosition);
         lightCube.Draw(lightingShader, modelRenderParam);
+    };
+
+    // ͸壬ģʽĽfbo
+    auto drawTransparent = [&](ModelRenderParam& modelRenderParam, TransparencyMode mode) {
+        GPU_PROFILE_SCOPE("Transparent");
+        if (mode == TransparencyMode::sorted) {
+            // ƴԶȾִȾʱò͸׶ηֺõĴأalphaڻ
+            Shader& windowDrawShader = renderPath == RenderPath::clustered ? clusteredShader : windowShader;
+            if (renderPath == RenderPath::clustered) {
+                bindClusteredShader(modelRenderParam);
+            }
+            FrameMap<float, glm::vec3> sortedPos;
+            for (auto&& pos : windowPositions) {
+                float distance = glm::length(pos - ourCamera.GetPos());
+                sortedPos[distance] = pos;
+            }
+            for (auto it = sortedPos.rbegin(); it != sortedPos.rend(); it++) {
+                modelRenderParam.SetModelPosition(it->second);
+                windowModel.Draw(windowDrawShader, modelRenderParam);
+            }
+        }
+        else {
+            // ƴҪ
+            oitBuffer.BeginTransparent(sceneDepth);
+            for (auto&& pos : windowPositions) {
+                modelRenderParam.SetModelPosition(pos);
+                windowModel.Draw(oitShader, modelRenderParam);
+            }
+            oitBuffer.EndTransparent();
+            oitBuffer.Composite(oitCompositeShader, bufferVAO, fbo);
+        }
+    };
+
+    // 󶨵֡ϲ
+    auto beginScene = [&]() {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, sceneColor->mWidth, sceneColor->mHeight);
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        //glStencilMask(0xFF);// ڲʹģ建
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glEnable(GL_DEPTH_TEST);
+    };
+
+    // ȡ֡ɫ
+    auto readScene = [&](std::vector<uint8>& pixels) {
+        pixels.resize(sceneColor->mWidth * sceneColor->mHeight * 3);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, sceneColor->mWidth, sceneColor->mHeight, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    };
+
+    // ͳƲ͸͸ȾʱGPUʱʹѯȡһ֡Ľ
+    unsigned int timeQueries[2];
+    glGenQueries(2, timeQueries);
+    unsigned int opaqueQueries[2];
+    glGenQueries(2, opaqueQueries);
+    int frameIndex = 0;
+    int statFrames = 0;
+    double frameTimeSum = 0.0;
+    double transparentCpuTime = 0.0;
+    double transparentGpuTime = 0.0;
+    double opaqueGpuTime = 0.0;
+    std::uint32_t shadowPages = 0;
+    TransparencyMode statMode = transparencyMode;
+    RenderPath statPath = renderPath;
+    bool resetStats = false;
+
+    // Դϴ㵽һ֡
+    RenderStats::Get().Reset();
+    RenderStatsExporter statsExporter;
+    if (!statsLogPath.empty()) {
+        if (!statsExporter.Open(statsLogPath, 60)) {
+            return -1;
+        }
+        RenderStats::Get().SetExporter(&statsExporter);
+    }
+
+    // ȾѭݴٶȵõƵʻвͬҪ֡
+    while (!glfwWindowShouldClose(window))
+    {
+        // ռһ֡ļʱGPUĽͨ֡
+        Profiler::Get().Collect();
+        if (writeProfile) {
+            writeProfile = false;
+            Profiler::Get().WriteChromeTrace("profile.json");
+            Profiler::Get().Report(std::cout);
+        }
+        PROFILE_SCOPE("Frame");
+
+        if (benchmark) {
+            currentFrame = benchmark->BeginFrame(ourCamera);
+            deltaTime = benchmark->GetDeltaTime();
+        }
+        else {
+            currentFrame = glfwGetTime();
+            deltaTime = currentFrame - lastFrame;
+            lastFrame = currentFrame;
+            processInput(window, deltaTime);
+        }
+
+        // ¼·ʱ棬 --benchmark camera_path.txt ط
+        if (recordCameraPath) {
+            if (recordedPath.IsEmpty()) {
+                recordStart = currentFrame;
+                std::cout << "Recording camera path" << std::endl;
+            }
+            recordedPath.Record(static_cast<float>(currentFrame - recordStart), ourCamera);
+        }
+        else if (!recordedPath.IsEmpty()) {
+            recordedPath.Save("camera_path.txt");
+            std::cout << "Camera path saved to camera_path.txt (" << recordedPath.GetKeyframeCount() << " keyframes)" << std::endl;
+            recordedPath.Clear();
+        }
+
+        // ǰڴСͶֱ̬ʵıȡɫ
+        if (dynamicResolution.IsEnabled() != dynamicResolutionEnabled) {
+            dynamicResolution.SetEnabled(dynamicResolutionEnabled);
+        }
+        renderTargets.SetResolution(windowWidth, windowHeight);
+        renderTargets.BeginFrame();
+        sceneColor = renderTargets.Acquire(RenderTargetDesc(GL_RGB8, dynamicResolution.GetScale()));
+        sceneDepth = renderTargets.Acquire(RenderTargetDesc(GL_DEPTH24_STENCIL8, dynamicResolution.GetScale()));
+        fbo = renderTargets.GetFramebuffer({ sceneColor }, sceneDepth);
+
+        // Ա͸ģʽȾͬһ֡Ļ
+        if (compareTransparency) {
+            compareTransparency = false;
+            std::vector<uint8> sortedPixels, oitPixels;
+            ModelRenderParam compareRenderParam(ourCamera);
+
+            beginScene();
+            drawOpaque(compareRenderParam);
+            drawTransparent(compareRenderParam, TransparencyMode::sorted);
+            readScene(sortedPixels);
+
+            beginScene();
+            drawOpaque(compareRenderParam);
+            drawTransparent(compareRenderParam, TransparencyMode::oit);
+            readScene(oitPixels);
+
+            int maxDiff = 0;
+            double sumDiff = 0.0;
+            size_t diffPixels = 0;
+            for (size_t i = 0; i < sortedPixels.size(); i += 3) {
+                int pixelDiff = 0;
+                for (size_t c = 0; c < 3; c++) {
+                    int diff = std::abs(static_cast<int>(sortedPixels[i + c]) - static_cast<int>(oitPixels[i + c]));
+                    pixelDiff = std::max(pixelDiff, diff);
+                    sumDiff += diff;
+                }
+                maxDiff = std::max(maxDiff, pixelDiff);
+                if (pixelDiff > 2)
+                    diffPixels++;
+            }
+            std::cout << "Sorted vs OIT: mean abs diff " << sumDiff / sortedPixels.size()
+                << ", max diff " << maxDiff
+                << ", pixels differ " << 100.0 * diffPixels / (sceneColor->mWidth * sceneColor->mHeight) << "%" << std::endl;
+            // Աȵһ֡ʱͳ
+            resetStats = true;
+        }
+
+        // лģʽͳ
+        if (resetStats || statMode != transparencyMode || statPath != renderPath) {
+            resetStats = false;
+            statMode = transparencyMode;
+            statPath = renderPath;
+            statFrames = 0;
+            frameTimeSum = transparentCpuTime = transparentGpuTime = opaqueGpuTime = 0.0;
+            shadowPages = 0;
+        }
+
+        // Сģ1ת
+        orbitPosition = model1Position + glm::vec3(3.5f * glm::cos(currentFrame), 1.5f, 3.5f * glm::sin(currentFrame));
+
+        // 󶨵֡ϽȾ
+        dynamicResolution.BeginFrame();
+        beginScene();
+
+        ModelRenderParam modelRenderParam(ourCamera);
 
-        // ƴȾ
-        std::map<float, glm::vec3> sortedPos;
-        for (auto&& pos : windowPositions) {
-            float distance = glm::length(pos - ourCamera.GetPos());
-            sortedPos[distance] = pos;
+        glBeginQuery(GL_TIME_ELAPSED, opaqueQueries[frameIndex % 2]);
+        drawOpaque(modelRenderParam);
+        glEndQuery(GL_TIME_ELAPSED);
+        shadowPages += shadowMap.GetStaticRenderCount();
+
+        // ͸岢ͳƺʱ
+        double transparentStart = glfwGetTime();
+        glBeginQuery(GL_TIME_ELAPSED, timeQueries[frameIndex % 2]);
+        drawTransparent(modelRenderParam, transparencyMode);
+        glEndQuery(GL_TIME_ELAPSED);
+        transparentCpuTime += glfwGetTime() - transparentStart;
+        if (frameIndex > 0) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(timeQueries[(frameIndex + 1) % 2], GL_QUERY_RESULT, &elapsed);
+            transparentGpuTime += elapsed * 1e-9;
+            glGetQueryObjectui64v(opaqueQueries[(frameIndex + 1) % 2], GL_QUERY_RESULT, &elapsed);
+            opaqueGpuTime += elapsed * 1e-9;
         }
-        for (std::map<float, glm::vec3>::reverse_iterator it = sortedPos.rbegin(); it != sortedPos.rend(); it++) {
-            modelRenderParam.SetModelPosition(it->second);
-            windowModel.Draw(windowShader, modelRenderParam);
+        frameIndex++;
+        frameTimeSum += deltaTime;
+        if (++statFrames == 120) {
+            std::cout << "[" << renderPathNames[static_cast<int>(renderPath)] << "]"
+                << (transparencyMode == TransparencyMode::sorted ? "[sorted]" : "[OIT]")
+                << " frame " << 1000.0 * frameTimeSum / statFrames << " ms"
+                << ", opaque GPU " << 1000.0 * opaqueGpuTime / statFrames << " ms"
+                << ", shadow pages " << shadowPages
+                << ", transparent CPU " << 1000.0 * transparentCpuTime / statFrames << " ms"
+                << ", transparent GPU " << 1000.0 * transparentGpuTime / statFrames << " ms"
+                << ", GPU frame " << dynamicResolution.GetGpuTime() << " ms"
+                << ", scale " << dynamicResolution.GetScale()
+                << " (" << sceneColor->mWidth << "x" << sceneColor->mHeight << ")" << std::endl;
+            renderTargets.Report(std::cout);
+            statFrames = 0;
+            frameTimeSum = transparentCpuTime = transparentGpuTime = opaqueGpuTime = 0.0;
+            shadowPages = 0;
         }
 
-        // ڰ󶨵Ĭϵ֡Ⱦ
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+        // Ĭϵ֡ϣḲأҪ
+        if (activePostChain != postChainIndex) {
+            activePostChain = postChainIndex;
+            std::cout << "Post chain: " << postChains[activePostChain]->GetDescription()
+                << " (" << postChains[activePostChain]->GetPassCount() << " passes)" << std::endl;
+        }
+        if (sceneColor->mWidth == windowWidth && sceneColor->mHeight == windowHeight) {
+            GPU_PROFILE_SCOPE("Post");
+            postChains[activePostChain]->Apply(sceneColor->mTexture, sceneColor->mWidth, sceneColor->mHeight, bufferVAO,
+                0, windowWidth, windowHeight);
+        }
+        else {
+            // ڽϵ͵ķֱɣٷŴ񻯵
+            RenderTarget* postColor = renderTargets.Acquire(RenderTargetDesc(GL_RGBA8, sceneColor->mWidth, sceneColor->mHeight));
+            {
+                GPU_PROFILE_SCOPE("Post");
+                postChains[activePostChain]->Apply(sceneColor->mTexture, sceneColor->mWidth, sceneColor->mHeight, bufferVAO,
+                    renderTargets.GetFramebuffer({ postColor }, nullptr), postColor->mWidth, postColor->mHeight);
+            }
+            {
+                GPU_PROFILE_SCOPE("Upscale");
+                upscaler.Apply(upscaleShader, sharpenShader, bufferVAO, postColor->mTexture, 0, windowWidth, windowHeight, 0.5f);
+            }
+            renderTargets.Release(postColor);
+        }
+        dynamicResolution.EndFrame();
 
-        frameBufferShader.use();
+        // Ŀֻһ֡ʹ
+        renderTargets.Release(sceneColor);
+        renderTargets.Release(sceneDepth);
 
-        glBindVertexArray(bufferVAO);
-        glDisable(GL_DEPTH_TEST); // ıαȽϼ򵥣ԲȲ
-        glBindTexture(GL_TEXTURE_2D, texture);
-        //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);  // ʹ߿ģʽ鿴
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        if (benchmark) {
+            benchmark->EndFrame();
+        }
+        // һ֡ͳư֡passܣȻ
+        RenderStats::Get().EndFrame();
+        if (benchmark && benchmark->IsFinished()) {
+            break;
+        }
 
-        glfwSwapBuffers(window);
+        {
+            PROFILE_SCOPE("Swap buffers");
+            glfwSwapBuffers(window);
+            // ɾGPUѾġͷ˵Ķ
+            GpuResources::Get().EndFrame();
+            // һ֡ʱڴȫ
+            FrameArena::ResetAll();
+        }
         // Ƿд¼롢꣩´״̬
         glfwPollEvents();
     }
 
-    glfwTerminate();
-    return 0;
+    RenderStats::Get().SetExporter(nullptr);
+    return benchmark ? benchmarkOptions.Finish(benchmark->GetResult()) : 0;
 }
\ No newline at end of file
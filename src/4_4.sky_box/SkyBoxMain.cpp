@@ -2,6 +2,7 @@
 #include <GLFW/glfw3.h>
 #include <stb_image.h>
 #include <iostream>
+#include <memory>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -12,6 +13,9 @@
 #include <mylib/filesystem.h>
 #include <mylib/mesh.h>
 #include <mylib/model.h>
+#include <mylib/render_target.h>
+#include <mylib/render_graph.h>
+#include <mylib/benchmark.h>
 
 
 // ڴС
@@ -26,6 +30,11 @@ bool firstMouse = true;
 // ȫ
 Camera ourCamera;
 
+// ǷԻҶȺرʱҶpassĽûбʹãᱻȾͼ޳
+bool grayscale = false;
+// Ƿһ֡Ⱦͼı
+bool reportGraph = false;
+
 // ڻص
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
@@ -75,9 +84,43 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos)
     lastY = ypos;
 }
 
+// صGлҶȺRȾͼ
+void key_callback(GLFWwindow* /*window*/, int key, int /*scancode*/, int action, int /*mods*/)
+{
+    if (action != GLFW_PRESS)
+        return;
+
+    if (key == GLFW_KEY_G) {
+        grayscale = !grayscale;
+        reportGraph = true;
+    }
+    else if (key == GLFW_KEY_R) {
+        reportGraph = true;
+    }
+}
+
 
-int main()
+// ÷4_4.sky_box [׼Բ] [--stats-log ļ]׼ԲBenchmarkOptions
+// ָ--stats-logʱȾͳÿ60֡дһεļչΪ.jsonʱΪJSONΪCSV
+// ׼ʱ·ƶӦ룬رմֱͬ˳˻ʱ1
+int main(int argc, char* argv[])
 {
+    BenchmarkOptions benchmarkOptions;
+    std::vector<std::string> options;
+    if (!benchmarkOptions.Parse(argc, argv, &options)) {
+        return -1;
+    }
+    std::string statsLogPath;
+    for (std::size_t i = 0; i < options.size(); i++) {
+        if (options[i] == "--stats-log" && i + 1 < options.size()) {
+            statsLogPath = options[++i];
+        }
+        else {
+            std::cout << "Unknown option: " << options[i] << std::endl;
+            return -1;
+        }
+    }
+
     // ʼ汾
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -94,6 +137,7 @@ int main()
     glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetKeyCallback(window, key_callback);
 
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
@@ -101,6 +145,9 @@ int main()
         return -1;
     }
 
+    // shader֮󴴽˳ʱɾGPU󡢱й©رGLFW
+    GpuResourcesShutdown gpuShutdown(glfwTerminate);
+
     glm::vec3 model1Position(0.0f, 0.01f, -5.0f); // ģ1λ ̧һֹȳͻ
     glm::vec3 model2Position(0.0f, 5.0f, -5.0f);
     glm::vec3 model3Position(-5.0f, 5.0f, -5.0f);
@@ -155,10 +202,63 @@ int main()
     Shader windowShader(FileSystem::getPath("shaders/shader_3_obj.vs").c_str(), FileSystem::getPath("shaders/shader_3_obj_3.fs").c_str());
     Model windowModel(Mesh::CreatePlane(3.0f, glm::vec3(0, 0, 1), FileSystem::getPath("resources/blending_transparent_window.png").c_str()));
 
+    // ĻõȫƬ
+    Shader screenShader(FileSystem::getPath("shaders/shader_4_buffer_1.vs").c_str(), FileSystem::getPath("shaders/shader_4_buffer_1.fs").c_str());
+    Shader grayscaleShader(FileSystem::getPath("shaders/shader_4_buffer_1.vs").c_str(), FileSystem::getPath("shaders/shader_4_buffer_3.fs").c_str());
+    unsigned int quadVAO, quadVBO;
+    glGenVertexArrays(1, &quadVAO);
+    glGenBuffers(1, &quadVBO);
+    glBindVertexArray(quadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    float quadVertices[] = {
+        //     ---- λ ----     -  -
+             1.0f,  1.0f, 0.0f,  1.0f, 1.0f,   // 
+            -1.0f,  1.0f, 0.0f,  0.0f, 1.0f,   // 
+            -1.0f, -1.0f, 0.0f,  0.0f, 0.0f,   // 
+             1.0f, -1.0f, 0.0f,  1.0f, 0.0f,   // 
+             1.0f,  1.0f, 0.0f,  1.0f, 1.0f,   // 
+            -1.0f, -1.0f, 0.0f,  0.0f, 0.0f,   // 
+    };
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    // λ
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    // 
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glBindVertexArray(0);
+
+    auto drawQuad = [&](Shader& shader, unsigned int texture) {
+        shader.use();
+        shader.setInt("screenTexture"_uid, 0);
+        // Ļûmip0ŵԪϵĲ
+        RenderDevice::Get().BindTexture(0, DeviceTextureType::texture2D, texture);
+        glDisable(GL_DEPTH_TEST);
+        glBindVertexArray(quadVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        glBindVertexArray(0);
+        glEnable(GL_DEPTH_TEST);
+    };
+
+    // ÿ֡ȾͼpassɫȶʱԴ
+    RenderTargetPool renderTargets(windowWidth, windowHeight);
+    RenderGraph renderGraph(renderTargets);
+
     double deltaTime = 0.0f; // ǰ֡һ֡ʱ
     double lastFrame = glfwGetTime(); // һ֡ʱ
     double currentFrame = glfwGetTime(); // ǰ֡ʱ
 
+    // ׼Ĭϵ·ģ1תһȦպڸ򶼻ῴ
+    std::unique_ptr<Benchmark> benchmark;
+    if (benchmarkOptions.mEnabled) {
+        CameraPath benchmarkPath;
+        if (!benchmarkOptions.LoadPath(CameraPath::Orbit(model1Position, 10.0f, 2.0f, 20.0f), benchmarkPath)) {
+            return -1;
+        }
+        benchmark.reset(new Benchmark("4_4.sky_box", benchmarkPath, windowWidth, windowHeight, benchmarkOptions.mSettings));
+        glfwSwapInterval(0);
+    }
+
     // ꣬׽λ
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
@@ -175,68 +275,142 @@ int main()
     glCullFace(GL_BACK);
     glFrontFace(GL_CCW);
 
+    // Դϴ㵽һ֡
+    RenderStats::Get().Reset();
+    RenderStatsExporter statsExporter;
+    if (!statsLogPath.empty()) {
+        if (!statsExporter.Open(statsLogPath, 60)) {
+            return -1;
+        }
+        RenderStats::Get().SetExporter(&statsExporter);
+    }
+
     // ȾѭݴٶȵõƵʻвͬҪ֡
     while (!glfwWindowShouldClose(window))
     {
-        currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
-
-        processInput(window, deltaTime);
+        if (benchmark) {
+            currentFrame = benchmark->BeginFrame(ourCamera);
+            deltaTime = benchmark->GetDeltaTime();
+        }
+        else {
+            currentFrame = glfwGetTime();
+            deltaTime = currentFrame - lastFrame;
+            lastFrame = currentFrame;
+            processInput(window, deltaTime);
+        }
 
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glStencilMask(0xFF);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        renderTargets.SetResolution(windowWidth, windowHeight);
+        renderTargets.BeginFrame();
+        renderGraph.Reset();
 
         ModelRenderParam modelRenderParam(ourCamera);
 
-        // ģ1
-        modelRenderParam.SetModelPosition(model1Position);
-        cubeModel1.UpdateLightParam(objectShader, modelRenderParam);
-        cubeModel1.Draw(objectShader, modelRenderParam);
-
-        // ģ2
-        modelRenderParam.SetModelPosition(model2Position);
-        reflectShader.use();
-        reflectShader.setVec3("cameraPos", modelRenderParam.mCameraPos);
-        cubeModel2.Draw(reflectShader, modelRenderParam);
-
-        // ģ3
-        modelRenderParam.SetModelPosition(model3Position);
-        refractShader.use();
-        refractShader.setVec3("cameraPos", modelRenderParam.mCameraPos);
-        cubeModel3.Draw(refractShader, modelRenderParam);
-
-        // Ʋ
-        for (auto&& pos : grassPositions) {
-            modelRenderParam.SetModelPosition(pos);
-            grassModel.Draw(grassShader, modelRenderParam);
-        }
-
-        // Ƶ
-        modelRenderParam.SetModelPosition(lightPosition);
-        lightCube.Draw(lightingShader, modelRenderParam);
+        RenderGraphHandle backbuffer = renderGraph.ImportBackbuffer("backbuffer", windowWidth, windowHeight);
+        RenderGraphHandle sceneColor = renderGraph.CreateTexture("sceneColor", RenderTargetDesc(GL_RGB8));
+        RenderGraphHandle sceneDepth = renderGraph.CreateTexture("sceneDepth", RenderTargetDesc(GL_DEPTH24_STENCIL8));
+
+        // ͸壬û֮󶼻ᱻպиǣɫҪ
+        renderGraph.AddPass("opaque", [&](RenderGraphBuilder& builder) {
+            sceneColor = builder.Write(sceneColor, RenderGraphLoadOp::dontCare);
+            sceneDepth = builder.Write(sceneDepth, RenderGraphLoadOp::clear, glm::vec4(1.0f, 0.0f, 0.0f, 0.0f));
+        }, [&](const RenderGraph&) {
+            // ģ1
+            modelRenderParam.SetModelPosition(model1Position);
+            cubeModel1.UpdateLightParam(objectShader, modelRenderParam);
+            cubeModel1.Draw(objectShader, modelRenderParam);
+
+            // ģ2
+            modelRenderParam.SetModelPosition(model2Position);
+            reflectShader.use();
+            reflectShader.setVec3("cameraPos"_uid, modelRenderParam.mCameraPos);
+            cubeModel2.Draw(reflectShader, modelRenderParam);
+
+            // ģ3
+            modelRenderParam.SetModelPosition(model3Position);
+            refractShader.use();
+            refractShader.setVec3("cameraPos"_uid, modelRenderParam.mCameraPos);
+            cubeModel3.Draw(refractShader, modelRenderParam);
+
+            // Ʋ
+            for (auto&& pos : grassPositions) {
+                modelRenderParam.SetModelPosition(pos);
+                grassModel.Draw(grassShader, modelRenderParam);
+            }
+
+            // Ƶ
+            modelRenderParam.SetModelPosition(lightPosition);
+            lightCube.Draw(lightingShader, modelRenderParam);
+        });
 
         // պ
-        sky.Draw(skyShader, modelRenderParam);
+        renderGraph.AddPass("sky", [&](RenderGraphBuilder& builder) {
+            sceneColor = builder.Write(sceneColor);
+            sceneDepth = builder.Write(sceneDepth);
+        }, [&](const RenderGraph&) {
+            sky.Draw(skyShader, modelRenderParam);
+        });
 
         // ͸ȻҪȾ
-        // ƴȾ
-        std::map<float, glm::vec3> sortedPos;
-        for (auto&& pos : windowPositions) {
-            float distance = glm::length(pos - ourCamera.GetPos());
-            sortedPos[distance] = pos;
+        renderGraph.AddPass("transparent", [&](RenderGraphBuilder& builder) {
+            sceneColor = builder.Write(sceneColor);
+            sceneDepth = builder.Write(sceneDepth);
+        }, [&](const RenderGraph&) {
+            // ƴȾ
+            FrameMap<float, glm::vec3> sortedPos;
+            for (auto&& pos : windowPositions) {
+                float distance = glm::length(pos - ourCamera.GetPos());
+                sortedPos[distance] = pos;
+            }
+            for (auto it = sortedPos.rbegin(); it != sortedPos.rend(); it++) {
+                modelRenderParam.SetModelPosition(it->second);
+                windowModel.Draw(windowShader, modelRenderParam);
+            }
+        });
+
+        // ҶȺֻпʱŻᱻĻ
+        RenderGraphHandle grayColor = renderGraph.CreateTexture("grayColor", RenderTargetDesc(GL_RGB8));
+        renderGraph.AddPass("grayscale", [&](RenderGraphBuilder& builder) {
+            builder.Read(sceneColor);
+            grayColor = builder.Write(grayColor, RenderGraphLoadOp::dontCare);
+        }, [&](const RenderGraph& graph) {
+            drawQuad(grayscaleShader, graph.GetTexture(sceneColor));
+        });
+
+        // Ļ
+        RenderGraphHandle presentSource = grayscale ? grayColor : sceneColor;
+        renderGraph.AddPass("present", [&](RenderGraphBuilder& builder) {
+            builder.Read(presentSource);
+            backbuffer = builder.Write(backbuffer, RenderGraphLoadOp::dontCare);
+        }, [&](const RenderGraph& graph) {
+            drawQuad(screenShader, graph.GetTexture(presentSource));
+        });
+
+        renderGraph.Compile();
+        renderGraph.Execute();
+        if (reportGraph) {
+            reportGraph = false;
+            renderGraph.Report(std::cout);
+            renderTargets.Report(std::cout);
+        }
+
+        if (benchmark) {
+            benchmark->EndFrame();
         }
-        for (std::map<float, glm::vec3>::reverse_iterator it = sortedPos.rbegin(); it != sortedPos.rend(); it++) {
-            modelRenderParam.SetModelPosition(it->second);
-            windowModel.Draw(windowShader, modelRenderParam);
+        // һ֡ͳư֡passܣȻ
+        RenderStats::Get().EndFrame();
+        if (benchmark && benchmark->IsFinished()) {
+            break;
         }
 
         glfwSwapBuffers(window);
+        // ɾGPUѾġͷ˵Ķ
+        GpuResources::Get().EndFrame();
+        // һ֡ʱڴȫ
+        FrameArena::ResetAll();
         // Ƿд¼롢꣩´״̬
         glfwPollEvents();
     }
 
-    glfwTerminate();
-    return 0;
+    RenderStats::Get().SetExporter(nullptr);
+    return benchmark ? benchmarkOptions.Finish(benchmark->GetResult()) : 0;
 }
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <stb_image.h>
+#include <iostream>
+#include <memory>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <mylib/shader_s.h>
+#include <mylib/camera.h>
+#include <mylib/filesystem.h>
+#include <mylib/mesh.h>
+#include <mylib/model.h>
+#include <mylib/command_buffer.h>
+#include <mylib/job_system.h>
+#include <mylib/benchmark.h>
+
+
+// ڴС
+int windowWidth = 800;
+int windowHeight = 600;
+
+// һ֡λ
+double lastX = static_cast<double>(windowWidth / 2);
+double lastY = static_cast<double>(windowHeight / 2);
+bool firstMouse = true;
+
+// ȫ
+Camera ourCamera;
+
+// Ƿʹö̼߳¼Mл
+bool multiThreadRecord = true;
+
+// ĴСkGridSize * kGridSize
+const int kGridSize = 64;
+
+// ڻص
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    windowWidth = width;
+    windowHeight = height;
+    glViewport(0, 0, width, height);
+}
+
+// 
+void processInput(GLFWwindow* window, const double deltaTime)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    std::uint8_t move = static_cast<std::uint8_t>(Camera_Movement::none);
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        move |= static_cast<std::uint8_t>(Camera_Movement::front);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        move |= static_cast<std::uint8_t>(Camera_Movement::back);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        move |= static_cast<std::uint8_t>(Camera_Movement::left);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        move |= static_cast<std::uint8_t>(Camera_Movement::right);
+    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS)
+        move |= static_cast<std::uint8_t>(Camera_Movement::up);
+    if (glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS)
+        move |= static_cast<std::uint8_t>(Camera_Movement::down);
+
+    ourCamera.SetPos(move, deltaTime);
+}
+
+// ƶ
+void mouse_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    if (firstMouse)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+
+    double xoffset = xpos - lastX;
+    double yoffset = lastY - ypos; // ע෴ģΪyǴӵײ
+    ourCamera.SetPitchYaw(xoffset, yoffset);
+
+    lastX = xpos;
+    lastY = ypos;
+}
+
+// ص
+void key_callback(GLFWwindow* /*window*/, int key, int /*scancode*/, int action, int /*mods*/)
+{
+    if (key == GLFW_KEY_M && action == GLFW_PRESS) {
+        multiThreadRecord = !multiThreadRecord;
+        std::cout << "Record commands with " << (multiThreadRecord ? "multiple threads" : "single thread") << std::endl;
+    }
+}
+
+
+// ÷4_5.command_buffer [׼Բ] [--stats-log ļ]׼ԲBenchmarkOptions
+// ָ--stats-logʱȾͳÿ60֡дһεļչΪ.jsonʱΪJSONΪCSV
+// ׼ʱ·ƶӦ룬رմֱͬ˳˻ʱ1
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions benchmarkOptions;
+    std::vector<std::string> options;
+    if (!benchmarkOptions.Parse(argc, argv, &options)) {
+        return -1;
+    }
+    std::string statsLogPath;
+    for (std::size_t i = 0; i < options.size(); i++) {
+        if (options[i] == "--stats-log" && i + 1 < options.size()) {
+            statsLogPath = options[++i];
+        }
+        else {
+            std::cout << "Unknown option: " << options[i] << std::endl;
+            return -1;
+        }
+    }
+
+    // ʼ汾
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    GLFWwindow* window = glfwCreateWindow(windowWidth, windowHeight, "LearnOpenGL", NULL, NULL);
+    if (window == NULL)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetKeyCallback(window, key_callback);
+
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+
+    // shader֮󴴽˳ʱɾGPU󡢱й©رGLFW
+    GpuResourcesShutdown gpuShutdown(glfwTerminate);
+
+    glm::vec3 lightPosition(4.0f, 5.0f, -3.0f);  // Դλ
+
+    // Ⱦõshader任uniform
+    Shader objectShader(FileSystem::getPath("shaders/shader_4_batch.vs").c_str(), FileSystem::getPath("shaders/shader_2_obj.fs").c_str());
+    glUniformBlockBinding(objectShader.GetID(), glGetUniformBlockIndex(objectShader.GetID(), "ObjectBlock"), 0);
+    Model cubeModel(Mesh::CreateCube(1.0f, FileSystem::getPath("resources/marble.jpg").c_str()));
+
+    // Ⱦobjùղ
+    LightParameters::MaterialParam lightMaterial(0, 1, 32.0f);
+    LightParameters::DirectLight directLight(glm::vec3(1.0f, -1.0f, -1.0f), glm::vec3(0.05f), glm::vec3(3.5f), glm::vec3(0.5f));
+    LightParameters::SpotLight spotLight(glm::vec3(0), glm::vec3(0), glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(1.0f, 0.5f, 0.0f), 1.0f, 0.09f, 0.032f, glm::cos(glm::radians(12.5f)), glm::cos(glm::radians(15.0f)));
+    std::vector<LightParameters::PointLight> pointLights;
+    pointLights.emplace_back(lightPosition);
+    LightParameters allLightParams(lightMaterial, directLight, pointLights, spotLight);
+    cubeModel.SetLightParameters(objectShader, allLightParams);
+
+    // λ
+    std::vector<glm::vec3> objectPositions;
+    for (int x = 0; x < kGridSize; x++) {
+        for (int z = 0; z < kGridSize; z++) {
+            objectPositions.emplace_back((x - kGridSize / 2) * 2.0f, -1.5f, -z * 2.0f - 3.0f);
+        }
+    }
+
+    // ֳɶΣÿһ壬ϵͳָ̼߳¼
+    JobSystem jobSystem;
+    CommandReplayer replayer;
+    int chunkCount = jobSystem.GetThreadCount() * 4;
+    std::vector<CommandBuffer> commandBuffers(chunkCount, CommandBuffer(replayer.GetUniformAlignment()));
+    std::cout << "Record commands with " << jobSystem.GetThreadCount() << " threads, " << objectPositions.size() << " objects" << std::endl;
+
+    // ¼[begin, end)ΧĻֻ㲻GL
+    auto recordObjects = [&](CommandBuffer& commandBuffer, size_t begin, size_t end, float time) {
+        commandBuffer.Reset();
+        commandBuffer.BindProgram(objectShader.GetID());
+        for (size_t i = begin; i < end; i++) {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), objectPositions[i]);
+            model = glm::rotate(model, time + i * 0.1f, glm::vec3(0.0f, 1.0f, 0.0f));
+            cubeModel.Record(commandBuffer, model);
+        }
+    };
+
+    double deltaTime = 0.0f; // ǰ֡һ֡ʱ
+    double lastFrame = glfwGetTime(); // һ֡ʱ
+    double currentFrame = glfwGetTime(); // ǰ֡ʱ
+
+    // ׼Ĭϵ·ƬתһȦ
+    std::unique_ptr<Benchmark> benchmark;
+    if (benchmarkOptions.mEnabled) {
+        CameraPath benchmarkPath;
+        if (!benchmarkOptions.LoadPath(CameraPath::Orbit(glm::vec3(0.0f, -1.5f, -kGridSize - 2.0f), kGridSize * 0.75f, 20.0f, 20.0f), benchmarkPath)) {
+            return -1;
+        }
+        benchmark.reset(new Benchmark("4_5.command_buffer", benchmarkPath, windowWidth, windowHeight, benchmarkOptions.mSettings));
+        glfwSwapInterval(0);
+    }
+
+    // ͳƼ¼ͻطŵCPUʱ
+    int statFrames = 0;
+    double recordTime = 0.0;
+    double replayTime = 0.0;
+
+    // ꣬׽λ
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // Ȳ
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+
+    // ޳޳棬趨ʱΪ
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+    glFrontFace(GL_CCW);
+
+    // Դϴ㵽һ֡
+    RenderStats::Get().Reset();
+    RenderStatsExporter statsExporter;
+    if (!statsLogPath.empty()) {
+        if (!statsExporter.Open(statsLogPath, 60)) {
+            return -1;
+        }
+        RenderStats::Get().SetExporter(&statsExporter);
+    }
+
+    // ȾѭݴٶȵõƵʻвͬҪ֡
+    while (!glfwWindowShouldClose(window))
+    {
+        if (benchmark) {
+            currentFrame = benchmark->BeginFrame(ourCamera);
+            deltaTime = benchmark->GetDeltaTime();
+        }
+        else {
+            currentFrame = glfwGetTime();
+            deltaTime = currentFrame - lastFrame;
+            lastFrame = currentFrame;
+            processInput(window, deltaTime);
+        }
+
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        ModelRenderParam modelRenderParam(ourCamera);
+
+        // ͹ղÿֻ֡һ
+        objectShader.use();
+        objectShader.setMat4("view"_uid, modelRenderParam.mViewMat);
+        objectShader.setMat4("projection"_uid, modelRenderParam.mProjMat);
+        cubeModel.UpdateLightParam(objectShader, modelRenderParam);
+
+        // ƽֶμ¼
+        double recordStart = glfwGetTime();
+        float time = static_cast<float>(currentFrame);
+        size_t chunkSize = (objectPositions.size() + chunkCount - 1) / chunkCount;
+        auto recordChunks = [&](size_t beginChunk, size_t endChunk) {
+            for (size_t i = beginChunk; i < endChunk; i++) {
+                size_t begin = std::min(objectPositions.size(), i * chunkSize);
+                size_t end = std::min(objectPositions.size(), begin + chunkSize);
+                recordObjects(commandBuffers[i], begin, end, time);
+            }
+        };
+        if (multiThreadRecord) {
+            jobSystem.ParallelFor(chunkCount, 1, recordChunks);
+        }
+        else {
+            recordChunks(0, chunkCount);
+        }
+
+        // GL߳ϰ˳ط
+        double replayStart = glfwGetTime();
+        replayer.Submit(commandBuffers);
+        double replayEnd = glfwGetTime();
+
+        recordTime += replayStart - recordStart;
+        replayTime += replayEnd - replayStart;
+        if (++statFrames == 120) {
+            std::cout << (multiThreadRecord ? "[multi thread]" : "[single thread]")
+                << " record " << 1000.0 * recordTime / statFrames << " ms"
+                << ", replay " << 1000.0 * replayTime / statFrames << " ms"
+                << ", draws " << replayer.GetDrawCount()
+                << ", skipped binds " << replayer.GetSkippedCount() << std::endl;
+            statFrames = 0;
+            recordTime = replayTime = 0.0;
+        }
+
+        if (benchmark) {
+            benchmark->EndFrame();
+        }
+        // һ֡ͳư֡passܣȻ
+        RenderStats::Get().EndFrame();
+        if (benchmark && benchmark->IsFinished()) {
+            break;
+        }
+
+        glfwSwapBuffers(window);
+        // ɾGPUѾġͷ˵Ķ
+        GpuResources::Get().EndFrame();
+        // Ƿд¼롢꣩´״̬
+        glfwPollEvents();
+    }
+
+    RenderStats::Get().SetExporter(nullptr);
+    return benchmark ? benchmarkOptions.Finish(benchmark->GetResult()) : 0;
+}
\ No newline at end of file
@@ -0,0 +1,277 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <mylib/job_system.h>
+#include <mylib/transform.h>
+
+
+// ϵͳܲԣҪ
+// ÷4_6.job_system [] [߳]
+// 1, 2, 4, 8 ... ̷ֱ߳ԣʱԵ̵߳ļٱ
+// ÷4_6.job_system --transforms [ڵ]
+// TransformHierarchy::Updateڵûнڵ㱻޸ʱÿ֡ĺʱ
+
+
+// ģÿ֡
+struct ObjectData
+{
+    std::vector<glm::vec3> mPositions;
+    std::vector<glm::vec3> mRotations;
+    std::vector<float> mScales;
+    std::vector<glm::mat4> mWorldMatrices;
+    std::vector<std::uint8_t> mVisible;
+};
+
+// üɺִ߳е
+struct SubmitData
+{
+    const ObjectData* mObjects;
+    std::size_t* mVisibleCount;
+};
+
+// ±任
+void UpdateTransforms(ObjectData& objects, std::size_t begin, std::size_t end)
+{
+    for (std::size_t i = begin; i < end; i++) {
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), objects.mPositions[i]);
+        model = glm::rotate(model, objects.mRotations[i].x, glm::vec3(1.0f, 0.0f, 0.0f));
+        model = glm::rotate(model, objects.mRotations[i].y, glm::vec3(0.0f, 1.0f, 0.0f));
+        model = glm::rotate(model, objects.mRotations[i].z, glm::vec3(0.0f, 0.0f, 1.0f));
+        objects.mWorldMatrices[i] = glm::scale(model, glm::vec3(objects.mScales[i]));
+    }
+}
+
+// ʹðΧ׶ü
+void CullObjects(ObjectData& objects, const glm::vec4* planes, std::size_t begin, std::size_t end)
+{
+    for (std::size_t i = begin; i < end; i++) {
+        glm::vec3 center = glm::vec3(objects.mWorldMatrices[i][3]);
+        float radius = objects.mScales[i] * 0.866f;
+        bool visible = true;
+        for (int p = 0; p < 6; p++) {
+            if (glm::dot(glm::vec3(planes[p]), center) + planes[p].w < -radius) {
+                visible = false;
+                break;
+            }
+        }
+        objects.mVisible[i] = visible;
+    }
+}
+
+// ͼͶӰȡ׶ƽ
+void ExtractFrustumPlanes(const glm::mat4& viewProj, glm::vec4* planes)
+{
+    glm::mat4 m = glm::transpose(viewProj);
+    planes[0] = m[3] + m[0];
+    planes[1] = m[3] - m[0];
+    planes[2] = m[3] + m[1];
+    planes[3] = m[3] - m[1];
+    planes[4] = m[3] + m[2];
+    planes[5] = m[3] - m[2];
+    for (int i = 0; i < 6; i++) {
+        planes[i] /= glm::length(glm::vec3(planes[i]));
+    }
+}
+
+// ģGL߳ͳύ
+void SubmitVisible(JobSystem& /*jobSystem*/, Job& /*job*/, const void* data)
+{
+    const SubmitData& submit = *static_cast<const SubmitData*>(data);
+    std::size_t count = 0;
+    for (auto&& visible : submit.mObjects->mVisible) {
+        count += visible;
+    }
+    *submit.mVisibleCount = count;
+}
+
+// һ֡и±任вü߳ύ
+std::size_t RunFrame(JobSystem& jobSystem, ObjectData& objects, const glm::vec4* planes)
+{
+    const std::size_t batchSize = 1024;
+    std::size_t objectCount = objects.mPositions.size();
+
+    jobSystem.ParallelFor(objectCount, batchSize, [&](std::size_t begin, std::size_t end) {
+        UpdateTransforms(objects, begin, end);
+    });
+
+    // üɺͨ߳ύ
+    std::size_t visibleCount = 0;
+    Job* submitJob = jobSystem.CreateMainThreadJob(&SubmitVisible);
+    SubmitData submitData = { &objects, &visibleCount };
+    std::memcpy(submitJob->mData, &submitData, sizeof(submitData));
+
+    Job* cullJob = jobSystem.CreateJob([](JobSystem& /*jobSystem*/, Job& /*job*/, const void* /*data*/) {});
+    jobSystem.AddContinuation(cullJob, submitJob);
+    auto cull = [&](std::size_t begin, std::size_t end) {
+        CullObjects(objects, planes, begin, end);
+    };
+    for (std::size_t begin = 0; begin < objectCount; begin += batchSize * 16) {
+        std::size_t end = std::min(objectCount, begin + batchSize * 16);
+        struct CullData
+        {
+            const decltype(cull)* mCull;
+            std::size_t mBegin;
+            std::size_t mEnd;
+        } cullData = { &cull, begin, end };
+        jobSystem.Run(jobSystem.CreateChildJob(cullJob, [](JobSystem& /*jobSystem*/, Job& /*job*/, const void* data) {
+            const CullData& range = *static_cast<const CullData*>(data);
+            (*range.mCull)(range.mBegin, range.mEnd);
+        }, cullData));
+    }
+    jobSystem.Run(cullJob);
+    jobSystem.Wait(submitJob);
+
+    return visibleCount;
+}
+
+
+// 任㼶ܲԣڵ㰴ӣÿڵ4ӽڵ
+int RunTransformBenchmark(std::size_t nodeCount)
+{
+    const int warmupFrames = 5;
+    const int measureFrames = 30;
+    const std::uint32_t childCount = 4;
+
+    std::uint32_t seed = 12345;
+    auto random = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / 16777216.0f;
+    };
+
+    TransformHierarchy hierarchy;
+    hierarchy.Reserve(nodeCount);
+    for (std::size_t i = 0; i < nodeCount; i++) {
+        std::int32_t parent = i == 0 ? TransformHierarchy::kNoParent : static_cast<std::int32_t>((i - 1) / childCount);
+        glm::vec3 translation(random() * 2.0f - 1.0f, random() * 2.0f - 1.0f, random() * 2.0f - 1.0f);
+        glm::quat rotation = glm::angleAxis(random() * 6.28f, glm::vec3(0.0f, 1.0f, 0.0f));
+        hierarchy.AddNode(parent, translation, rotation, glm::vec3(0.9f + random() * 0.2f));
+    }
+    hierarchy.Update();
+
+    // ÿ֡޸ĵĽڵ㣺ֻ޸ĸڵ㣩1%ڵ㡢޸
+    std::vector<std::uint32_t> sparseNodes(std::max<std::size_t>(1, nodeCount / 100));
+    for (auto&& node : sparseNodes) {
+        node = static_cast<std::uint32_t>(random() * nodeCount) % nodeCount;
+    }
+    struct Mode
+    {
+        const char* mName;
+        std::vector<std::uint32_t> mNodes;
+    } modes[] = {
+        { "root", { 0 } },
+        { "1% nodes", sparseNodes },
+        { "clean", {} },
+    };
+
+    std::cout << "Transform nodes: " << nodeCount << std::endl;
+    std::cout << std::setw(10) << "modified" << std::setw(12) << "frame ms" << std::setw(10) << "updated"
+        << std::setw(12) << "ns/update" << std::endl;
+    for (auto&& mode : modes) {
+        float angle = 0.0f;
+        auto runFrame = [&]() {
+            angle += 0.01f;
+            for (auto&& node : mode.mNodes) {
+                hierarchy.SetRotation(node, glm::angleAxis(angle, glm::vec3(0.0f, 1.0f, 0.0f)));
+            }
+            return hierarchy.Update();
+        };
+
+        std::size_t updatedCount = 0;
+        for (int i = 0; i < warmupFrames; i++) {
+            updatedCount = runFrame();
+        }
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < measureFrames; i++) {
+            updatedCount = runFrame();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double frameTime = std::chrono::duration<double, std::milli>(end - start).count() / measureFrames;
+
+        std::cout << std::setw(10) << mode.mName << std::setw(12) << std::fixed << std::setprecision(3) << frameTime
+            << std::setw(10) << updatedCount << std::setw(12) << std::setprecision(1)
+            << (updatedCount ? frameTime * 1e6 / updatedCount : 0.0) << std::endl;
+    }
+
+    return 0;
+}
+
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "--transforms") {
+        return RunTransformBenchmark(argc > 2 ? std::stoul(argv[2]) : 100000);
+    }
+
+    std::size_t objectCount = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    unsigned int maxThreads = argc > 2 ? std::stoul(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+    const int warmupFrames = 5;
+    const int measureFrames = 30;
+
+    // ֲ
+    ObjectData objects;
+    objects.mPositions.resize(objectCount);
+    objects.mRotations.resize(objectCount);
+    objects.mScales.resize(objectCount);
+    objects.mWorldMatrices.resize(objectCount);
+    objects.mVisible.resize(objectCount);
+    std::uint32_t seed = 12345;
+    auto random = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / 16777216.0f;
+    };
+    for (std::size_t i = 0; i < objectCount; i++) {
+        objects.mPositions[i] = glm::vec3(random() * 200.0f - 100.0f, random() * 20.0f, random() * -200.0f);
+        objects.mRotations[i] = glm::vec3(random(), random(), random()) * 6.28f;
+        objects.mScales[i] = 0.5f + random();
+    }
+
+    glm::mat4 viewProj = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f)
+        * glm::lookAt(glm::vec3(0.0f, 5.0f, 3.0f), glm::vec3(0.0f, 5.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::vec4 planes[6];
+    ExtractFrustumPlanes(viewProj, planes);
+
+    std::cout << "Objects: " << objectCount << ", hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "frame ms" << std::setw(10) << "speedup"
+        << std::setw(12) << "efficiency" << std::setw(10) << "visible" << std::endl;
+
+    // Ե߳Ϊ2ݣټ߳
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    double singleThreadTime = 0.0;
+    for (auto&& threads : threadCounts) {
+        JobSystem jobSystem(threads - 1);
+
+        std::size_t visibleCount = 0;
+        for (int i = 0; i < warmupFrames; i++) {
+            visibleCount = RunFrame(jobSystem, objects, planes);
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < measureFrames; i++) {
+            visibleCount = RunFrame(jobSystem, objects, planes);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double frameTime = std::chrono::duration<double, std::milli>(end - start).count() / measureFrames;
+
+        if (threads == 1) {
+            singleThreadTime = frameTime;
+        }
+        double speedup = singleThreadTime / frameTime;
+        std::cout << std::setw(8) << threads << std::setw(12) << std::fixed << std::setprecision(3) << frameTime
+            << std::setw(10) << std::setprecision(2) << speedup
+            << std::setw(11) << std::setprecision(0) << 100.0 * speedup / threads << "%"
+            << std::setw(10) << visibleCount << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,533 @@
+#include <glad/glad.h>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <sstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <mylib/headless.h>
+#include <mylib/shader_s.h>
+#include <mylib/camera.h>
+#include <mylib/filesystem.h>
+#include <mylib/mesh.h>
+#include <mylib/model.h>
+#include <mylib/render_target.h>
+#include <mylib/benchmark.h>
+#include <mylib/render_device.h>
+#include <mylib/job_system.h>
+#include <mylib/soft_raster.h>
+#include <mylib/frame_arena.h>
+#include <mylib/texture_streaming.h>
+#ifdef MYLIB_GL_CAPTURE
+#include <mylib/gl_trace.h>
+#endif
+
+
+// ޴ȾҪʾCIȾڵûGPUĻϣMesa llvmpipe
+// ÷4_7.headless [--frames N] [--width W] [--height H] [--dump Ŀ¼] [--soft] [--compare] [--null] [--stats-log ļ] [--capture ļ]
+//                   [--texture-budget KB] [׼Բ]
+// ֡Ƴתٶ޹أͬĲÿȾĻͬ
+// ָ--dumpʱÿ֡Ϊ Ŀ¼/frame_0000.ppm--nullһʹʱֻܱ--softĻ
+// ָ--softʱCPUϵդȾͬĳָ--compareʱַʽȾGLĲ죬ʱդĻΪframe_0000_soft.ppm
+// ָ--nullʱGLģлύ豸ֻԼύʱ豸õĴ
+// ָ--stats-logʱȾͳÿ10֡дһεļչΪ.jsonʱΪJSONΪCSV
+// ָ--captureʱҪMYLIB_GL_CAPTURE룩GLñ浽ļ4_8.gl_replayط
+// ָ--texture-budgetʱҪľͣϸmipԴ治Ԥ㣬ʱפ
+// ָ--benchmarkʱBenchmarkOptionsĲл׼ԣ֡ΪԤȺͳ֮֡ͣ˻ʱ1
+// ʱǰ֮֡ÿ֡operator newĵôֻGLƲҲ滭ʱӦΪ0
+
+
+// ͳƶѷ
+MYLIB_DEFINE_ALLOCATION_COUNTER()
+
+
+void PrintUsage()
+{
+    std::cout << "Usage: 4_7.headless [--frames N] [--width W] [--height H] [--dump folder] [--soft] [--compare] [--null]" << std::endl
+        << "                   [--stats-log file] [--capture file] [--texture-budget KB] [benchmark options]" << std::endl;
+}
+
+// жַ߲[minValue, maxValue]Χʱfalse
+bool ParseInteger(const std::string& option, const std::string& value, long long minValue, long long maxValue, long long& result)
+{
+    char* end = nullptr;
+    errno = 0;
+    long long number = std::strtoll(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || errno == ERANGE || number < minValue || number > maxValue) {
+        std::cout << "Invalid value for option " << option << ": " << value << std::endl;
+        return false;
+    }
+    result = number;
+    return true;
+}
+
+
+int main(int argc, char* argv[])
+{
+    int frameCount = 60;
+    int width = 800;
+    int height = 600;
+    std::string dumpFolder;
+    std::string capturePath;
+    std::string statsLogPath;
+    std::int64_t textureBudget = -1;
+    bool softRaster = false;
+    bool compare = false;
+    bool nullDevice = false;
+    BenchmarkOptions benchmarkOptions;
+    std::vector<std::string> options;
+    if (!benchmarkOptions.Parse(argc, argv, &options)) {
+        PrintUsage();
+        return -1;
+    }
+    for (std::size_t i = 0; i < options.size(); i++) {
+        const std::string& option = options[i];
+        // ѡ
+        if (option == "--soft" || option == "--compare") {
+            softRaster = true;
+            compare = compare || option == "--compare";
+            continue;
+        }
+        if (option == "--null") {
+            nullDevice = true;
+            continue;
+        }
+        if (i + 1 >= options.size()) {
+            std::cout << "Missing value for option: " << option << std::endl;
+            PrintUsage();
+            return -1;
+        }
+        const std::string& value = options[++i];
+        long long number = 0;
+        if (option == "--frames" || option == "--width" || option == "--height" || option == "--texture-budget") {
+            // ߴ֡Ϊ1Ԥ㰴KBΪ0ֽں
+            bool budget = option == "--texture-budget";
+            if (!ParseInteger(option, value, budget ? 0 : 1, budget ? LLONG_MAX / 1024 : INT_MAX, number)) {
+                PrintUsage();
+                return -1;
+            }
+        }
+        if (option == "--frames") {
+            frameCount = static_cast<int>(number);
+        }
+        else if (option == "--width") {
+            width = static_cast<int>(number);
+        }
+        else if (option == "--height") {
+            height = static_cast<int>(number);
+        }
+        else if (option == "--dump") {
+            dumpFolder = value;
+        }
+        else if (option == "--capture") {
+            capturePath = value;
+        }
+        else if (option == "--stats-log") {
+            statsLogPath = value;
+        }
+        else if (option == "--texture-budget") {
+            textureBudget = number * 1024;
+        }
+        else {
+            std::cout << "Unknown option: " << option << std::endl;
+            PrintUsage();
+            return -1;
+        }
+    }
+
+    if (nullDevice && (compare || !capturePath.empty())) {
+        std::cout << "--compare and --capture need the GL device" << std::endl;
+        return -1;
+    }
+    // 豸ûпԶصĻ棬ֻܱդĽ
+    if (nullDevice && !dumpFolder.empty() && !softRaster) {
+        std::cout << "--dump with --null needs --soft" << std::endl;
+        return -1;
+    }
+#ifndef MYLIB_GL_CAPTURE
+    if (!capturePath.empty()) {
+        std::cout << "--capture needs MYLIB_GL_CAPTURE" << std::endl;
+        return -1;
+    }
+#endif
+
+    // 豸ҪGLģդҲģʽ
+    NullRenderDevice recordingDevice;
+    HeadlessContext context;
+    // shaderʱֻǼͷţǶ֮ͨǰ豸ɾй©ĶٻָΪGL
+    struct DeviceRestore
+    {
+        ~DeviceRestore()
+        {
+            GpuResources::Get().Flush();
+            GpuResources::Get().PrintLeaks(std::cout);
+            RenderDevice::Set(nullptr);
+        }
+    } deviceRestore;
+    if (nullDevice) {
+        RenderDevice::Set(&recordingDevice);
+    }
+    else if (!context.Create(width, height)) {
+        return -1;
+    }
+    RenderDevice& device = RenderDevice::Get();
+#ifdef MYLIB_GL_CAPTURE
+    // ڴԴ֮ǰʼץȡطʱҪ
+    if (!capturePath.empty() && !GLCapture::Get().Start(capturePath)) {
+        return -1;
+    }
+#endif
+
+    // ͺդϵͳҪڼ֮ǰ
+    std::unique_ptr<JobSystem> jobSystem;
+    if (softRaster || textureBudget >= 0) {
+        jobSystem.reset(new JobSystem());
+    }
+    std::unique_ptr<TextureStreamer> textureStreamer;
+    if (textureBudget >= 0) {
+        textureStreamer.reset(new TextureStreamer(*jobSystem, textureBudget));
+        TextureStreamer::SetCurrent(textureStreamer.get());
+    }
+
+    glm::vec3 model1Position(0.0f, 0.01f, -5.0f); // ģ1λ ̧һֹȳͻ
+    glm::vec3 grassPositions[] = {
+        {-5.5f,  0.0f, -5.48f},
+        {5.5f,  0.0f,  -6.51f},
+        {-6.3f,  0.0f, -4.3f},
+    }; // λ
+    glm::vec3 windowPositions[] = {
+        {0.0f,  0.0f, -1.49f},
+        {4.5f,  0.0f,  -6.5f},
+        {-3.3f,  0.0f, -2.3f},
+    }; // λ
+    glm::vec3 planePosition(0.0f, -1.5f, 0.0f); // ذλ
+    glm::vec3 lightPosition(4.0f, 5.0f, -3.0f);  // Դλ
+
+    // Ⱦõshader
+    Shader objectShader(FileSystem::getPath("shaders/shader_3_obj.vs").c_str(), FileSystem::getPath("shaders/shader_2_obj.fs").c_str());
+    // դҪӶݸȱCPUݣƺͷ
+    Mesh cubeMesh1 = Mesh::CreateCube(3.0f, FileSystem::getPath("resources/marble.jpg").c_str(), MeshResidency::cpuRetained);
+
+    // Ⱦobjùղ
+    LightParameters::MaterialParam lightMaterial(0, 1, 32.0f);
+    LightParameters::DirectLight directLight(glm::vec3(1.0f, -1.0f, -1.0f), glm::vec3(0.05f), glm::vec3(3.5f), glm::vec3(0.5f));
+    LightParameters::SpotLight spotLight(glm::vec3(0), glm::vec3(0), glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(1.0f, 0.5f, 0.0f), 1.0f, 0.09f, 0.032f, glm::cos(glm::radians(12.5f)), glm::cos(glm::radians(15.0f)));
+    std::vector<LightParameters::PointLight> pointLights;
+    pointLights.emplace_back(lightPosition);
+    LightParameters allLightParams(lightMaterial, directLight, pointLights, spotLight);
+    SoftTextureCache softTextures;
+    SoftMesh softCube1(cubeMesh1, softTextures);
+    cubeMesh1.ReleaseCpuData();
+    Model cubeModel1(std::move(cubeMesh1));
+    cubeModel1.SetLightParameters(objectShader, allLightParams);
+
+    // ƹshader
+    Shader lightingShader(FileSystem::getPath("shaders/shader_2_light.vs").c_str(), FileSystem::getPath("shaders/shader_2_light.fs").c_str());
+    Mesh lightCubeMesh = Mesh::CreateCube(0.5f, "", MeshResidency::cpuRetained);
+    SoftMesh softLightCube(lightCubeMesh, softTextures);
+    lightCubeMesh.ReleaseCpuData();
+    Model lightCube(std::move(lightCubeMesh));
+
+    // ذ
+    Mesh planeMesh = Mesh::CreatePlane(100.0f, glm::vec3(0, 1, 0), FileSystem::getPath("resources/metal.png").c_str(), MeshResidency::cpuRetained);
+    SoftMesh softPlane(planeMesh, softTextures);
+    planeMesh.ReleaseCpuData();
+    Model plane(std::move(planeMesh));
+    // ذܴҼߣԹ˻Զ
+    plane.SetSamplerPreset(SamplerPreset::anisotropicClamp);
+
+    // shader
+    Shader grassShader(FileSystem::getPath("shaders/shader_3_obj.vs").c_str(), FileSystem::getPath("shaders/shader_3_obj_2.fs").c_str());
+    Mesh grassMesh = Mesh::CreatePlane(5.0f, glm::vec3(0, 0, 1), FileSystem::getPath("resources/grass.png").c_str(), MeshResidency::cpuRetained);
+    SoftMesh softGrass(grassMesh, softTextures);
+    grassMesh.ReleaseCpuData();
+    Model grassModel(std::move(grassMesh));
+
+    // ͸shader
+    Shader windowShader(FileSystem::getPath("shaders/shader_3_obj.vs").c_str(), FileSystem::getPath("shaders/shader_3_obj_3.fs").c_str());
+    Mesh windowMesh = Mesh::CreatePlane(3.0f, glm::vec3(0, 0, 1), FileSystem::getPath("resources/blending_transparent_window.png").c_str(), MeshResidency::cpuRetained);
+    SoftMesh softWindow(windowMesh, softTextures);
+    windowMesh.ReleaseCpuData();
+    Model windowModel(std::move(windowMesh));
+
+    // դGLһmip
+    std::unique_ptr<SoftRenderer> softRenderer;
+    if (softRaster) {
+        softRenderer.reset(new SoftRenderer(width, height, *jobSystem));
+        softRenderer->SetLights(allLightParams);
+    }
+
+    // ûĬ֡壬ȾȾĿ
+    RenderTargetPool renderTargets(width, height);
+    RenderTarget* sceneColor = nullptr;
+    RenderTarget* sceneDepth = nullptr;
+    if (!nullDevice) {
+        sceneColor = renderTargets.Acquire(RenderTargetDesc(GL_RGBA8));
+        sceneDepth = renderTargets.Acquire(RenderTargetDesc(GL_DEPTH24_STENCIL8));
+        glBindFramebuffer(GL_FRAMEBUFFER, renderTargets.GetFramebuffer({ sceneColor }, sceneDepth));
+        glViewport(0, 0, width, height);
+        glDepthFunc(GL_LESS);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glCullFace(GL_BACK);
+        glFrontFace(GL_CCW);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    }
+    device.SetDepthTest(true);
+    device.SetBlend(true);
+    device.SetCullFace(true);
+
+    // Ĭģ1תһȦ׼ԿԸ¼Ƶ·
+    Camera ourCamera;
+    CameraPath orbitPath = CameraPath::Orbit(model1Position, 12.0f, 3.0f, 10.0f);
+    std::unique_ptr<Benchmark> benchmark;
+    if (benchmarkOptions.mEnabled) {
+        CameraPath benchmarkPath;
+        if (!benchmarkOptions.LoadPath(orbitPath, benchmarkPath)) {
+            return -1;
+        }
+        benchmark.reset(new Benchmark("4_7.headless", benchmarkPath, width, height, benchmarkOptions.mSettings));
+        frameCount = benchmarkOptions.mSettings.mWarmupFrames + benchmarkOptions.mSettings.mMeasureFrames;
+    }
+    // Դϴ㵽һ֡
+    RenderStats& renderStats = RenderStats::Get();
+    renderStats.Reset();
+    RenderStatsExporter statsExporter;
+    if (!statsLogPath.empty()) {
+        if (!statsExporter.Open(statsLogPath, 10)) {
+            return -1;
+        }
+        renderStats.SetExporter(&statsExporter);
+    }
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), static_cast<float>(width) / height, 0.1f, 100.0f);
+    std::vector<std::uint8_t> pixels(static_cast<std::size_t>(width) * height * 3);
+    std::vector<std::uint8_t> softPixels;
+
+    double renderTime = 0.0;
+    double softRenderTime = 0.0;
+    double readbackTime = 0.0;
+    // GLĲ죺ÿֵֵͨܺ͡һͨ16
+    double totalDiff = 0.0;
+    int maxDiff = 0;
+    std::uint64_t differentPixels = 0;
+    // ǰ֡еһʹʱķ䣨shader֡ڴݵȣ֮֡ͳ
+    const int warmupFrames = 2;
+    std::uint64_t steadyAllocations = 0;
+    for (int frame = 0; frame < frameCount; frame++) {
+        auto frameStart = std::chrono::high_resolution_clock::now();
+        std::uint64_t frameAllocations = AllocationCounter::Get();
+
+        // λֻ֡ž
+        if (benchmark) {
+            benchmark->BeginFrame(ourCamera);
+        }
+        else {
+            glm::vec3 position, target;
+            orbitPath.Sample(orbitPath.GetDuration() * frame / std::max(frameCount, 1), position, target);
+            ourCamera.SetLookAt(position, target);
+        }
+        glm::vec3 cameraPos = ourCamera.GetPos();
+
+        // ͶӰǹ̶Ŀ߱ȣ滻ΪĿ߱
+        ModelRenderParam modelRenderParam(ourCamera);
+        modelRenderParam.mProjMat = projection;
+
+        // һ֡ÿĻϵĴС
+        if (textureStreamer) {
+            ModelRenderParam requestParam = modelRenderParam;
+            auto requestTextures = [&](const Model& model, const glm::vec3& position) {
+                requestParam.mModelTransMat = glm::translate(glm::mat4(1.0f), position);
+                model.RequestTextures(*textureStreamer, requestParam, static_cast<float>(height));
+            };
+            requestTextures(plane, planePosition);
+            requestTextures(cubeModel1, model1Position);
+            for (auto&& pos : grassPositions) {
+                requestTextures(grassModel, pos);
+            }
+            for (auto&& pos : windowPositions) {
+                requestTextures(windowModel, pos);
+            }
+        }
+
+        // ԶƣõmapڵĿУʱ֡ڴ滹û
+        {
+            FrameMap<float, glm::vec3> sortedPos;
+            for (auto&& pos : windowPositions) {
+                sortedPos[glm::length(pos - cameraPos)] = pos;
+            }
+
+            if (!softRaster || compare) {
+                device.Clear(0.1f, 0.1f, 0.1f, 1.0f);
+
+                // Ƶذ
+                renderStats.BeginPass("opaque");
+                modelRenderParam.SetModelPosition(planePosition);
+                plane.Draw(objectShader, modelRenderParam);
+
+                // ģ1
+                modelRenderParam.SetModelPosition(model1Position);
+                cubeModel1.UpdateLightParam(objectShader, modelRenderParam);
+                cubeModel1.Draw(objectShader, modelRenderParam);
+
+                // Ʋ
+                for (auto&& pos : grassPositions) {
+                    modelRenderParam.SetModelPosition(pos);
+                    grassModel.Draw(grassShader, modelRenderParam);
+                }
+
+                // Ƶ
+                modelRenderParam.SetModelPosition(lightPosition);
+                lightCube.Draw(lightingShader, modelRenderParam);
+
+                // ƴ
+                renderStats.BeginPass("transparent");
+                for (auto it = sortedPos.rbegin(); it != sortedPos.rend(); it++) {
+                    modelRenderParam.SetModelPosition(it->second);
+                    windowModel.Draw(windowShader, modelRenderParam);
+                }
+                renderStats.EndPass();
+            }
+
+            // դͬ˳ύ
+            if (softRenderer) {
+                auto softStart = std::chrono::high_resolution_clock::now();
+                softRenderer->Clear(glm::vec4(0.1f, 0.1f, 0.1f, 1.0f));
+                softRenderer->SetCamera(modelRenderParam);
+                softRenderer->Draw(softPlane, objectShader, glm::translate(glm::mat4(1.0f), planePosition));
+                softRenderer->Draw(softCube1, objectShader, glm::translate(glm::mat4(1.0f), model1Position));
+                for (auto&& pos : grassPositions) {
+                    softRenderer->Draw(softGrass, grassShader, glm::translate(glm::mat4(1.0f), pos));
+                }
+                softRenderer->Draw(softLightCube, lightingShader, glm::translate(glm::mat4(1.0f), lightPosition));
+                for (auto it = sortedPos.rbegin(); it != sortedPos.rend(); it++) {
+                    softRenderer->Draw(softWindow, windowShader, glm::translate(glm::mat4(1.0f), it->second));
+                }
+                softRenderer->Render();
+                softRenderTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - softStart).count();
+            }
+        }
+
+        if (benchmark) {
+            benchmark->EndFrame();
+        }
+        if (textureStreamer) {
+            textureStreamer->Update();
+        }
+        GpuResources::Get().EndFrame();
+        renderStats.EndFrame();
+
+        // ȴȾɣͳƵһ֡ʱ豸ֻύCPUʱ
+        if (!nullDevice) {
+            glFinish();
+        }
+        auto renderEnd = std::chrono::high_resolution_clock::now();
+        renderTime += std::chrono::duration<double, std::milli>(renderEnd - frameStart).count();
+
+        if (softRenderer) {
+            softRenderer->ReadPixels(softPixels);
+        }
+        if (compare) {
+            glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+            for (std::size_t i = 0; i < pixels.size(); i += 3) {
+                int pixelDiff = 0;
+                for (std::size_t c = i; c < i + 3; c++) {
+                    int diff = std::abs(static_cast<int>(pixels[c]) - static_cast<int>(softPixels[c]));
+                    totalDiff += diff;
+                    pixelDiff = std::max(pixelDiff, diff);
+                }
+                maxDiff = std::max(maxDiff, pixelDiff);
+                differentPixels += pixelDiff > 16 ? 1 : 0;
+            }
+        }
+
+        if (!dumpFolder.empty()) {
+            std::ostringstream path;
+            path << dumpFolder << "/frame_" << std::setw(4) << std::setfill('0') << frame;
+            if ((!softRaster || compare) && !nullDevice) {
+                if (!compare) {
+                    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+                }
+                if (!WritePPM(path.str() + ".ppm", pixels, width, height)) {
+                    std::cout << "Failed to write " << path.str() << ".ppm" << std::endl;
+                    return -1;
+                }
+            }
+            if (softRaster) {
+                std::string softPath = path.str() + (compare ? "_soft.ppm" : ".ppm");
+                if (!WritePPM(softPath, softPixels, width, height)) {
+                    std::cout << "Failed to write " << softPath << std::endl;
+                    return -1;
+                }
+            }
+            readbackTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - renderEnd).count();
+        }
+#ifdef MYLIB_GL_CAPTURE
+        GLCapture::Get().EndFrame();
+#endif
+        FrameArena::ResetAll();
+        if (frame >= warmupFrames) {
+            steadyAllocations += AllocationCounter::Get() - frameAllocations;
+        }
+    }
+
+    std::cout << "Frames: " << frameCount << ", resolution: " << width << "x" << height << std::endl;
+    if (frameCount > 0) {
+        std::cout << std::fixed << std::setprecision(3) << "Render: " << renderTime / frameCount << " ms/frame";
+        if (!dumpFolder.empty()) {
+            std::cout << ", readback and write: " << readbackTime / frameCount << " ms/frame";
+        }
+        std::cout << std::endl;
+        if (softRenderer) {
+            const SoftRasterStats& stats = softRenderer->GetStats();
+            std::cout << "Software raster: " << softRenderTime / frameCount << " ms/frame, last frame: " << stats.mTriangles << " triangles, "
+                << stats.mBinnedTriangles << " tile bins, " << stats.mShadedPixels << " shaded pixels" << std::endl;
+        }
+        const RenderFrameStats& lastFrame = renderStats.GetLastFrame();
+        std::cout << "Last frame: " << lastFrame.mCounters.mDrawCalls << " draws, " << lastFrame.mCounters.mTriangles << " triangles, "
+            << lastFrame.mCounters.GetStateChanges() << " state changes, " << lastFrame.mCounters.mUniformUploads << " uniforms ("
+            << lastFrame.mCounters.mUniformBytes << " bytes), estimated memory: buffers " << lastFrame.mBufferMemory / 1024
+            << " KB, textures " << lastFrame.mTextureMemory / 1024 << " KB" << std::endl;
+        for (auto&& pass : lastFrame.mPasses) {
+            std::cout << "  " << pass.mName << ": " << pass.mCounters.mDrawCalls << " draws, " << pass.mCounters.mTriangles << " triangles, "
+                << pass.mCounters.mUniformUploads << " uniforms" << std::endl;
+        }
+        if (frameCount > warmupFrames) {
+            FrameArena& arena = FrameArena::ForThread();
+            std::cout << "Heap allocations after frame " << warmupFrames << ": " << static_cast<double>(steadyAllocations) / (frameCount - warmupFrames)
+                << " per frame, frame arena peak " << arena.GetPeak() << " bytes of " << arena.GetCapacity() << std::endl;
+        }
+        if (textureStreamer) {
+            textureStreamer->Print(std::cout, true);
+        }
+        if (nullDevice) {
+            std::cout << "Null device calls (all frames, including resource creation):" << std::endl;
+            recordingDevice.Print(std::cout);
+        }
+#ifdef MYLIB_GL_CAPTURE
+        if (GLCapture::Get().IsCapturing()) {
+            std::cout << "Captured " << GLCapture::Get().GetFrameCount() << " frames to " << capturePath << " (" << GLCapture::Get().GetBytesWritten() / 1024 << " KB)" << std::endl;
+        }
+#endif
+        if (compare) {
+            double pixelCount = static_cast<double>(width) * height * frameCount;
+            std::cout << "Compare with GL: mean abs diff " << totalDiff / (pixelCount * 3) << ", max diff " << maxDiff
+                << ", pixels differing by more than 16: " << differentPixels * 100.0 / pixelCount << "%" << std::endl;
+        }
+    }
+
+    renderTargets.Release(sceneColor);
+    renderTargets.Release(sceneDepth);
+#ifdef MYLIB_GL_CAPTURE
+    GLCapture::Get().Stop();
+#endif
+    renderStats.SetExporter(nullptr);
+    return benchmark ? benchmarkOptions.Finish(benchmark->GetResult()) : 0;
+}
@@ -0,0 +1,317 @@
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <mylib/headless.h>
+#include <mylib/gl_trace.h>
+
+
+// ȡGLCaptureץȡtraceļ4_7.headless --capture߷޴ڵGLִ
+// ÷4_8.gl_replay traceļ [--stats] [--top N] [--width W] [--height H] [--dump Ŀ¼]
+// ָ--statsʱGLģÿ֡ĵϴôĺԼظͬ״̬ĵ
+// GLлطţÿ֡ĺʱָ--dumpʱÿ֡ʱѵǰȡ֡屣Ϊ Ŀ¼/frame_0000.ppm
+// ֻڴĺͱ滭棬Ӧץȡʱһ
+
+
+// ÿͳ
+struct FunctionStats
+{
+    std::uint64_t mCalls = 0;
+    std::uint64_t mRedundant = 0;
+    std::uint64_t mPayloadBytes = 0;
+};
+
+// ÿ֡ͳ
+struct FrameStats
+{
+    std::uint64_t mCalls = 0;
+    std::uint64_t mDraws = 0;
+    std::uint64_t mRedundant = 0;
+    std::uint64_t mPayloadBytes = 0;
+};
+
+// ҳõֵ뵱ǰֵͬ״̬
+// ֻtraceܿ״̬ɾڱ޸ĵ
+class RedundancyTracker
+{
+public:
+    // Ƿظ
+    bool Check(const GLTraceCall& call);
+
+private:
+    std::map<std::string, std::string> mState;
+    std::uint64_t mProgram = 0;
+    std::uint64_t mActiveTexture = GL_TEXTURE0;
+
+    static std::string _getValue(const GLTraceCall& call, int firstArg);
+};
+
+std::string RedundancyTracker::_getValue(const GLTraceCall& call, int firstArg)
+{
+    // ֵָ
+    const GLTraceSignature& signature = GetGLTraceSignatures()[call.mFunction];
+    std::string value;
+    for (int i = firstArg; i < signature.mArgCount; i++) {
+        const GLTraceArg& arg = call.mArgs[i];
+        if (arg.mMode == GLTracePointer::payload && signature.mArgClasses[i] != GLTraceArgClass::scalar) {
+            value.append(static_cast<const char*>(arg.mPointer), arg.mSize);
+        }
+        else {
+            value.append(reinterpret_cast<const char*>(&arg.mValue), sizeof(arg.mValue));
+        }
+    }
+    return value;
+}
+
+bool RedundancyTracker::Check(const GLTraceCall& call)
+{
+    const GLTraceSignature& signature = GetGLTraceSignatures()[call.mFunction];
+    const std::string name = signature.mName;
+    std::string key;
+    std::string value;
+    switch (call.mFunction)
+    {
+    case GLTraceId_glUseProgram:
+        mProgram = call.mArgs[0].mValue;
+        key = name;
+        value = _getValue(call, 0);
+        break;
+    case GLTraceId_glActiveTexture:
+        mActiveTexture = call.mArgs[0].mValue;
+        key = name;
+        value = _getValue(call, 0);
+        break;
+    case GLTraceId_glBindVertexArray:
+        // İVAO
+        mState.erase("glBindBuffer " + std::to_string(GL_ELEMENT_ARRAY_BUFFER));
+        key = name;
+        value = _getValue(call, 0);
+        break;
+    case GLTraceId_glDepthMask: case GLTraceId_glDepthFunc: case GLTraceId_glBlendFunc: case GLTraceId_glBlendFuncSeparate:
+    case GLTraceId_glBlendEquation: case GLTraceId_glBlendEquationSeparate: case GLTraceId_glBlendColor:
+    case GLTraceId_glCullFace: case GLTraceId_glFrontFace: case GLTraceId_glViewport: case GLTraceId_glScissor:
+    case GLTraceId_glClearColor: case GLTraceId_glClearDepth: case GLTraceId_glClearStencil: case GLTraceId_glColorMask:
+    case GLTraceId_glStencilMask: case GLTraceId_glStencilFunc: case GLTraceId_glStencilOp: case GLTraceId_glPolygonMode:
+    case GLTraceId_glPolygonOffset: case GLTraceId_glLineWidth: case GLTraceId_glPointSize:
+    case GLTraceId_glDrawBuffer: case GLTraceId_glReadBuffer:
+        key = name;
+        value = _getValue(call, 0);
+        break;
+    case GLTraceId_glBindBuffer: case GLTraceId_glBindFramebuffer: case GLTraceId_glBindRenderbuffer:
+    case GLTraceId_glBindSampler: case GLTraceId_glPixelStorei: case GLTraceId_glHint:
+        key = name + " " + std::to_string(call.mArgs[0].mValue);
+        value = _getValue(call, 1);
+        break;
+    case GLTraceId_glBindBufferBase: case GLTraceId_glBindBufferRange:
+        key = "glBindBufferBase " + std::to_string(call.mArgs[0].mValue) + " " + std::to_string(call.mArgs[1].mValue);
+        value = name + _getValue(call, 2);
+        break;
+    case GLTraceId_glBindTexture:
+        key = name + " " + std::to_string(mActiveTexture) + " " + std::to_string(call.mArgs[0].mValue);
+        value = _getValue(call, 1);
+        break;
+    case GLTraceId_glEnable: case GLTraceId_glDisable:
+        key = "glEnable " + std::to_string(call.mArgs[0].mValue);
+        value = call.mFunction == GLTraceId_glEnable ? "1" : "0";
+        break;
+    default:
+        // glUniform*ǰλ
+        if (name.compare(0, 9, "glUniform") == 0 && name.compare(0, 21, "glUniformBlockBinding") != 0) {
+            key = "glUniform " + std::to_string(mProgram) + " " + std::to_string(call.mArgs[0].mValue);
+            value = name + _getValue(call, 1);
+            break;
+        }
+        return false;
+    }
+
+    auto found = mState.find(key);
+    if (found != mState.end() && found->second == value) {
+        return true;
+    }
+    mState[key] = value;
+    return false;
+}
+
+int PrintStats(GLTraceReader& reader, int top)
+{
+    const GLTraceSignature* signatures = GetGLTraceSignatures();
+    std::vector<FunctionStats> functions(GLTraceId_count);
+    std::vector<FrameStats> frames(1);
+    std::uint64_t unsupported = 0;
+    RedundancyTracker redundancy;
+
+    GLTraceCall call;
+    while (reader.Next(call)) {
+        if (call.mFunction == kGLTraceFrameEnd) {
+            frames.emplace_back();
+            continue;
+        }
+        FunctionStats& function = functions[call.mFunction];
+        FrameStats& frame = frames.back();
+        bool redundant = redundancy.Check(call);
+        function.mCalls++;
+        function.mRedundant += redundant ? 1 : 0;
+        function.mPayloadBytes += call.mPayloadBytes;
+        frame.mCalls++;
+        frame.mDraws += signatures[call.mFunction].mIsDraw ? 1 : 0;
+        frame.mRedundant += redundant ? 1 : 0;
+        frame.mPayloadBytes += call.mPayloadBytes;
+        unsupported += call.mSupported ? 0 : 1;
+    }
+    if (!reader.GetError().empty()) {
+        std::cout << reader.GetError() << std::endl;
+        return -1;
+    }
+    // һ֮֡ûеʱһ֡
+    if (frames.size() > 1 && frames.back().mCalls == 0) {
+        frames.pop_back();
+    }
+
+    // ÿ֡
+    std::cout << "frame      calls      draws  redundant   uploaded(KB)" << std::endl;
+    FrameStats total;
+    for (std::size_t i = 0; i < frames.size(); i++) {
+        const FrameStats& frame = frames[i];
+        std::cout << std::setw(5) << i << std::setw(11) << frame.mCalls << std::setw(11) << frame.mDraws << std::setw(11) << frame.mRedundant
+            << std::setw(15) << std::fixed << std::setprecision(1) << frame.mPayloadBytes / 1024.0 << std::endl;
+        total.mCalls += frame.mCalls;
+        total.mDraws += frame.mDraws;
+        total.mRedundant += frame.mRedundant;
+        total.mPayloadBytes += frame.mPayloadBytes;
+    }
+    std::cout << "Trace: " << reader.GetSize() / 1024 << " KB, " << frames.size() << " frames, " << total.mCalls << " calls, " << total.mDraws << " draws, "
+        << total.mRedundant << " redundant (" << std::setprecision(1) << (total.mCalls > 0 ? total.mRedundant * 100.0 / total.mCalls : 0.0) << "%), "
+        << total.mPayloadBytes / 1024 << " KB uploaded, " << unsupported << " unsupported calls" << std::endl;
+
+    // ôĺ
+    std::vector<int> order;
+    for (int i = 0; i < GLTraceId_count; i++) {
+        if (functions[i].mCalls > 0) {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&functions](int a, int b) { return functions[a].mCalls > functions[b].mCalls; });
+    std::cout << std::endl << "function                               calls  per frame  redundant   uploaded(KB)" << std::endl;
+    for (std::size_t i = 0; i < order.size() && static_cast<int>(i) < top; i++) {
+        const FunctionStats& function = functions[order[i]];
+        std::cout << std::left << std::setw(34) << signatures[order[i]].mName << std::right << std::setw(11) << function.mCalls
+            << std::setw(11) << std::setprecision(1) << static_cast<double>(function.mCalls) / frames.size()
+            << std::setw(11) << function.mRedundant << std::setw(15) << function.mPayloadBytes / 1024.0 << std::endl;
+    }
+    return 0;
+}
+
+int Replay(GLTraceReader& reader, int width, int height, const std::string& dumpFolder)
+{
+    HeadlessContext context;
+    if (!context.Create(width, height)) {
+        return -1;
+    }
+    GLTraceReplayer replayer;
+    std::vector<std::uint8_t> pixels(static_cast<std::size_t>(width) * height * 3);
+
+    // һ֡Դ
+    std::vector<double> frameTimes;
+    std::uint64_t calls = 0;
+    auto frameStart = std::chrono::high_resolution_clock::now();
+    GLTraceCall call;
+    while (reader.Next(call)) {
+        if (call.mFunction != kGLTraceFrameEnd) {
+            replayer.Execute(call);
+            calls++;
+            continue;
+        }
+
+        glFinish();
+        auto frameEnd = std::chrono::high_resolution_clock::now();
+        frameTimes.push_back(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+        if (!dumpFolder.empty()) {
+            std::ostringstream path;
+            path << dumpFolder << "/frame_" << std::setw(4) << std::setfill('0') << frameTimes.size() - 1 << ".ppm";
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+            if (!WritePPM(path.str(), pixels, width, height)) {
+                std::cout << "Failed to write " << path.str() << std::endl;
+                return -1;
+            }
+        }
+        frameStart = std::chrono::high_resolution_clock::now();
+    }
+    if (!reader.GetError().empty()) {
+        std::cout << reader.GetError() << std::endl;
+        return -1;
+    }
+
+    std::cout << "Replayed " << calls << " calls in " << frameTimes.size() << " frames, skipped " << replayer.GetSkippedCount()
+        << ", mismatched names or locations " << replayer.GetMismatchCount() << std::endl;
+    if (!frameTimes.empty()) {
+        std::cout << std::fixed << std::setprecision(3) << "First frame: " << frameTimes[0] << " ms" << std::endl;
+    }
+    if (frameTimes.size() > 1) {
+        double sum = 0.0;
+        double minTime = frameTimes[1];
+        double maxTime = frameTimes[1];
+        for (std::size_t i = 1; i < frameTimes.size(); i++) {
+            sum += frameTimes[i];
+            minTime = std::min(minTime, frameTimes[i]);
+            maxTime = std::max(maxTime, frameTimes[i]);
+        }
+        std::cout << "Other frames: avg " << sum / (frameTimes.size() - 1) << " ms, min " << minTime << " ms, max " << maxTime << " ms" << std::endl;
+    }
+    return replayer.GetMismatchCount() > 0 ? 1 : 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cout << "Usage: 4_8.gl_replay <trace> [--stats] [--top N] [--width W] [--height H] [--dump folder]" << std::endl;
+        return -1;
+    }
+    std::string tracePath = argv[1];
+    bool stats = false;
+    int top = 20;
+    int width = 800;
+    int height = 600;
+    std::string dumpFolder;
+    for (int i = 2; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--stats") {
+            stats = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cout << "Missing value for option: " << option << std::endl;
+            return -1;
+        }
+        std::string value = argv[++i];
+        if (option == "--top") {
+            top = std::stoi(value);
+        }
+        else if (option == "--width") {
+            width = std::stoi(value);
+        }
+        else if (option == "--height") {
+            height = std::stoi(value);
+        }
+        else if (option == "--dump") {
+            dumpFolder = value;
+        }
+        else {
+            std::cout << "Unknown option: " << option << std::endl;
+            return -1;
+        }
+    }
+
+    GLTraceReader reader;
+    if (!reader.Open(tracePath)) {
+        std::cout << reader.GetError() << std::endl;
+        return -1;
+    }
+    return stats ? PrintStats(reader, top) : Replay(reader, width, height, dumpFolder);
+}